@@ -0,0 +1,264 @@
+/*
+ * Per-cycle eval() cost of each Verilated module on its own
+ *
+ * One iteration is one clock cycle (rising and falling edge, two eval()
+ * calls), so Time is host ns per simulated cycle and Items/s is simulated
+ * cycles per second. Every module is measured idle (out of reset, inputs
+ * quiet) and busy (a new input every cycle); the difference is what the
+ * module's activity costs beyond evaluating the clock tree.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "verilated.h"
+#include "Vmarket_data_processor.h"
+#include "Vmarket_data_processor_wide.h"
+#include "Vtrading_strategy.h"
+#include "Vorder_manager.h"
+#include "Vlatency_histogram.h"
+#include "Vhjb_calculator.h"
+#include "Vhjb_calculator_pipelined.h"
+#include "Vhjb_calculator_fixed.h"
+#include "Vsharded_trading_system.h"
+
+#include "bench_harness.h"
+
+static constexpr uint32_t SYMBOL_BASE = 0x53000000;
+static constexpr unsigned NUM_SYMBOLS = 8;
+
+static uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Momentum-friendly price: a symbol alternates 1% on each visit
+static uint32_t tickPrice(uint64_t cycle) {
+    return ((cycle / NUM_SYMBOLS) % 2) ? 0x97800000 : 0x96000000;
+}
+
+// Clocks a fresh model for the timed iterations. configure(model) runs once
+// after construction; drive(model, cycle) before every cycle, including the
+// five reset cycles, which are not timed.
+template <typename Model, typename Configure, typename Drive>
+static void benchEval(BenchState& state, Configure configure, Drive drive) {
+    auto context = std::make_unique<VerilatedContext>();
+    auto model = std::make_unique<Model>(context.get());
+    configure(*model);
+
+    auto cycle = [&](uint64_t n) {
+        drive(*model, n);
+        model->clk = 1;
+        model->eval();
+        model->clk = 0;
+        model->eval();
+    };
+
+    model->rst_n = 0;
+    for (uint64_t n = 0; n < 5; ++n) cycle(n);
+    model->rst_n = 1;
+
+    uint64_t n = 0;
+    while (state.keepRunning()) cycle(n++);
+    model->final();
+    state.setItemsProcessed(state.iterations());
+}
+
+static auto quiet = [](auto&, uint64_t) {};
+static auto defaults = [](auto&) {};
+
+// Fill a wide (or narrow) port from 32-bit words
+template <size_t N>
+static void setWords(VlWide<N>& port, const uint32_t* words) {
+    for (size_t i = 0; i < N; ++i) port[i] = words[i];
+}
+
+// ITCH 5.0 Add Order blocks ([length:2][message:36]) packed into 512-bit
+// beats, looped over as one endless packet with tlast on its final beat
+struct WideStimulus {
+    static constexpr size_t BEAT_BYTES = 64;
+    std::vector<uint32_t> words;        // 16 per beat
+    size_t beats = 0;
+    size_t next = 0;
+
+    WideStimulus() {
+        std::vector<uint8_t> bytes;
+        for (uint64_t ref = 1; ref <= 256; ++ref) {
+            uint8_t msg[2 + 36] = {0, 36, 'A'};
+            for (int b = 0; b < 8; ++b) msg[2 + 11 + b] = static_cast<uint8_t>(ref >> (56 - 8 * b));
+            msg[2 + 19] = 'B';
+            msg[2 + 23] = 100;
+            std::memcpy(msg + 2 + 24, "BENCH   ", 8);
+            msg[2 + 33] = static_cast<uint8_t>(ref);
+            bytes.insert(bytes.end(), msg, msg + sizeof(msg));
+        }
+        bytes.resize((bytes.size() + BEAT_BYTES - 1) / BEAT_BYTES * BEAT_BYTES, 0);
+        beats = bytes.size() / BEAT_BYTES;
+        words.resize(bytes.size() / 4);
+        std::memcpy(words.data(), bytes.data(), bytes.size());
+    }
+};
+
+void registerEvalBenchmarks(BenchRegistry& registry) {
+    registry.add("eval/market_data_processor/idle", [](BenchState& s) {
+        benchEval<Vmarket_data_processor>(s, defaults, [](Vmarket_data_processor& m, uint64_t n) {
+            m.timebase = n;
+        });
+    });
+    registry.add("eval/market_data_processor/busy", [](BenchState& s) {
+        benchEval<Vmarket_data_processor>(s, defaults, [](Vmarket_data_processor& m, uint64_t n) {
+            m.timebase = n;
+            m.data_valid = m.rst_n;
+            m.data_type = 0x41;
+            m.data_last = 1;
+            m.data_in = (static_cast<uint64_t>(SYMBOL_BASE + n % NUM_SYMBOLS) << 32) | tickPrice(n);
+        });
+    });
+
+    registry.add("eval/market_data_processor_wide/idle", [](BenchState& s) {
+        benchEval<Vmarket_data_processor_wide>(s, defaults, quiet);
+    });
+    registry.add("eval/market_data_processor_wide/busy", [](BenchState& s) {
+        WideStimulus stimulus;
+        benchEval<Vmarket_data_processor_wide>(s,
+            [](Vmarket_data_processor_wide& m) { m.s_axis_tkeep = ~0ull; },
+            [&](Vmarket_data_processor_wide& m, uint64_t) {
+                // Advance only on accepted beats
+                if (m.s_axis_tvalid && m.s_axis_tready) stimulus.next = (stimulus.next + 1) % stimulus.beats;
+                m.s_axis_tvalid = m.rst_n;
+                m.s_axis_tlast = stimulus.next + 1 == stimulus.beats;
+                setWords(m.s_axis_tdata, &stimulus.words[stimulus.next * 16]);
+            });
+    });
+
+    auto strategy_config = [](Vtrading_strategy& m) {
+        m.strategy_enable = 0xF;
+        m.position_limit = 0xFFFFFFFF;
+        m.mm_spread = 0x00100000;
+        m.order_ready = 1;
+    };
+    registry.add("eval/trading_strategy/idle", [=](BenchState& s) {
+        benchEval<Vtrading_strategy>(s, strategy_config, quiet);
+    });
+    registry.add("eval/trading_strategy/busy", [=](BenchState& s) {
+        benchEval<Vtrading_strategy>(s, strategy_config, [](Vtrading_strategy& m, uint64_t n) {
+            m.tick_valid = m.rst_n;
+            m.tick_symbol = SYMBOL_BASE + n % NUM_SYMBOLS;
+            m.tick_price = tickPrice(n);
+            m.tick_bid = tickPrice(n) - 0x00100000;
+            m.tick_ask = tickPrice(n) + 0x00100000;
+            m.tick_volume = 0x64000000;
+            m.tick_time = n;
+        });
+    });
+
+    auto order_config = [](Vorder_manager& m) {
+        m.exec_ready = 1;
+        m.risk_enabled = 0;
+        m.risk_position_limit = 0xFFFFFFFF;
+        m.risk_max_order_size = 0xFFFFFFFF;
+        m.risk_max_notional = ~0ull;
+        m.risk_rate_burst = 0xFFFF;
+        m.risk_rate_interval = 0;
+    };
+    registry.add("eval/order_manager/idle", [=](BenchState& s) {
+        benchEval<Vorder_manager>(s, order_config, [](Vorder_manager& m, uint64_t n) { m.timebase = n; });
+    });
+    registry.add("eval/order_manager/busy", [=](BenchState& s) {
+        benchEval<Vorder_manager>(s, order_config, [](Vorder_manager& m, uint64_t n) {
+            m.timebase = n;
+            m.order_valid = m.rst_n && m.order_ready;
+            m.order_symbol = SYMBOL_BASE + n % NUM_SYMBOLS;
+            m.order_price = tickPrice(n);
+            m.order_volume = 100;
+            m.order_side = n & 1;
+            m.order_type = 0;
+            m.order_id = static_cast<uint32_t>(n);
+            m.order_tick_time = n;
+        });
+    });
+
+    registry.add("eval/latency_histogram/idle", [](BenchState& s) {
+        benchEval<Vlatency_histogram>(s, defaults, quiet);
+    });
+    registry.add("eval/latency_histogram/busy", [](BenchState& s) {
+        benchEval<Vlatency_histogram>(s, defaults, [](Vlatency_histogram& m, uint64_t n) {
+            m.sample_valid = m.rst_n;
+            m.sample_latency = static_cast<uint32_t>(n % 200);
+        });
+    });
+
+    registry.add("eval/hjb_calculator/idle", [](BenchState& s) {
+        benchEval<Vhjb_calculator>(s, defaults, quiet);
+    });
+    registry.add("eval/hjb_calculator/busy", [](BenchState& s) {
+        benchEval<Vhjb_calculator>(s, defaults, [](Vhjb_calculator& m, uint64_t n) {
+            m.calculate_en = m.rst_n;
+            m.mid_price = doubleBits(100000.0 + n % 1000);
+            m.inventory = static_cast<uint32_t>(n % 200) - 100;
+            m.volatility = doubleBits(0.2);
+        });
+    });
+
+    registry.add("eval/hjb_calculator_pipelined/idle", [](BenchState& s) {
+        benchEval<Vhjb_calculator_pipelined>(s, [](Vhjb_calculator_pipelined& m) { m.out_ready = 1; }, quiet);
+    });
+    registry.add("eval/hjb_calculator_pipelined/busy", [](BenchState& s) {
+        benchEval<Vhjb_calculator_pipelined>(s, [](Vhjb_calculator_pipelined& m) { m.out_ready = 1; },
+            [](Vhjb_calculator_pipelined& m, uint64_t n) {
+                m.in_valid = m.rst_n;
+                m.in_mid_price = doubleBits(100000.0 + n % 1000);
+                m.in_inventory = static_cast<uint32_t>(n % 200) - 100;
+                m.in_volatility = doubleBits(0.2);
+                m.in_tag = static_cast<uint32_t>(n);
+            });
+    });
+
+    // Q32.32 for gamma 0.1, kappa 1.5, as hjb_fixed_create() sets them
+    auto fixed_config = [](Vhjb_calculator_fixed& m) {
+        m.cfg_gamma = static_cast<uint64_t>(0.1 * 4294967296.0);
+        m.cfg_two_over_gamma = static_cast<uint64_t>(20.0 * 4294967296.0);
+        m.cfg_inv_kappa = static_cast<uint64_t>(4294967296.0 / 1.5);
+        m.out_ready = 1;
+    };
+    registry.add("eval/hjb_calculator_fixed/idle", [=](BenchState& s) {
+        benchEval<Vhjb_calculator_fixed>(s, fixed_config, quiet);
+    });
+    registry.add("eval/hjb_calculator_fixed/busy", [=](BenchState& s) {
+        benchEval<Vhjb_calculator_fixed>(s, fixed_config, [](Vhjb_calculator_fixed& m, uint64_t n) {
+            m.in_valid = m.rst_n;
+            m.in_mid_price = (100000ull + n % 1000) << 32;
+            m.in_inventory = static_cast<uint32_t>(n % 200) - 100;
+            m.in_volatility = static_cast<uint64_t>(0.2 * 4294967296.0);
+            m.in_tag = static_cast<uint32_t>(n);
+        });
+    });
+
+    // Default NUM_LANES, all lanes in use, momentum only
+    auto sharded_config = [](Vsharded_trading_system& m) {
+        m.cfg_lane_bits = 3;
+        m.strategy_enable = 0x8;
+        m.position_limit = 0xFFFFFFFF;
+        m.risk_position_limit = 0xFFFFFFFF;
+        m.risk_max_order_size = 0xFFFFFFFF;
+        m.risk_max_notional = ~0ull;
+        m.risk_rate_burst = 0xFFFF;
+        m.risk_rate_interval = 0;
+    };
+    registry.add("eval/sharded_trading_system/idle", [=](BenchState& s) {
+        benchEval<Vsharded_trading_system>(s, sharded_config,
+            [](Vsharded_trading_system& m, uint64_t n) { m.timebase = n; });
+    });
+    registry.add("eval/sharded_trading_system/busy", [=](BenchState& s) {
+        benchEval<Vsharded_trading_system>(s, sharded_config, [](Vsharded_trading_system& m, uint64_t n) {
+            m.timebase = n;
+            m.data_valid = m.rst_n;
+            m.data_type = 0x41;
+            m.data_last = 1;
+            m.data_in = (static_cast<uint64_t>(SYMBOL_BASE + n % 64) << 32) | ((n / 64) % 2 ? 0x97800000 : 0x96000000);
+        });
+    });
+}
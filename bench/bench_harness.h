@@ -0,0 +1,368 @@
+/*
+ * Microbenchmark harness for the host-side C++ components
+ *
+ * Kept to what Google Benchmark would give us, without the dependency:
+ *
+ *   void benchGenerateTick(BenchState& state) {
+ *       MarketDataGenerator generator;          // setup, not timed
+ *       while (state.keepRunning()) {
+ *           doNotOptimize(generator.generateTick(0));
+ *       }
+ *       state.setItemsProcessed(state.iterations());
+ *   }
+ *   registry.add("generator/generateTick", benchGenerateTick);
+ *
+ * Each benchmark is first run with a doubling iteration count until one run
+ * lasts the warm-up time, which also warms caches, branch predictors and
+ * lazily built state. The iteration count is then scaled to the minimum
+ * time and the benchmark repeated; the median, mean, standard deviation
+ * and coefficient of variation over the repetitions are reported. The
+ * process is pinned to one CPU for the whole run so repetitions do not
+ * migrate between cores.
+ */
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+// Keeps a value (and the stores that produced it) from being optimised away
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+class BenchState {
+public:
+    explicit BenchState(uint64_t iterations) : max_iterations(iterations) {}
+
+    // True once per iteration; the timer starts on the first call and stops
+    // when the iterations run out
+    bool keepRunning() {
+        if (!started) {
+            started = true;
+            resumeTiming();
+        }
+        if (done < max_iterations) {
+            done++;
+            return true;
+        }
+        pauseTiming();
+        return false;
+    }
+
+    // Setup or checking inside the loop that should not be timed
+    void pauseTiming() {
+        if (!running) return;
+        real_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - real_start).count();
+        cpu_ns += threadCpuNs() - cpu_start;
+        running = false;
+    }
+
+    void resumeTiming() {
+        if (running) return;
+        real_start = std::chrono::steady_clock::now();
+        cpu_start = threadCpuNs();
+        running = true;
+    }
+
+    void setItemsProcessed(uint64_t items) { item_count = items; }
+    void setBytesProcessed(uint64_t bytes) { byte_count = bytes; }
+    void setLabel(const std::string& text) { label_text = text; }
+
+    uint64_t iterations() const { return max_iterations; }
+    bool ran() const { return started; }
+    double realNs() const { return real_ns; }
+    double cpuNs() const { return cpu_ns; }
+    uint64_t items() const { return item_count; }
+    uint64_t bytes() const { return byte_count; }
+    const std::string& label() const { return label_text; }
+
+private:
+    static double threadCpuNs() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1e9 + ts.tv_nsec;
+    }
+
+    uint64_t max_iterations;
+    uint64_t done = 0;
+    bool started = false;
+    bool running = false;
+    std::chrono::steady_clock::time_point real_start;
+    double cpu_start = 0.0;
+    double real_ns = 0.0;
+    double cpu_ns = 0.0;
+    uint64_t item_count = 0;
+    uint64_t byte_count = 0;
+    std::string label_text;
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(BenchState&)> run;
+};
+
+class BenchRegistry {
+public:
+    void add(const std::string& name, std::function<void(BenchState&)> run) {
+        benchmarks.push_back({name, std::move(run)});
+    }
+
+    const std::vector<Benchmark>& all() const { return benchmarks; }
+
+private:
+    std::vector<Benchmark> benchmarks;
+};
+
+// Each suite registers its benchmarks here (bench_host.cpp, bench_hjb.cpp,
+// bench_eval.cpp)
+void registerHostBenchmarks(BenchRegistry& registry);
+void registerHjbBenchmarks(BenchRegistry& registry);
+void registerEvalBenchmarks(BenchRegistry& registry);
+
+struct BenchOptions {
+    double min_time = 0.5;              // seconds per repetition
+    double warmup_time = 0.1;           // seconds of doubling runs before measuring
+    unsigned repetitions = 5;
+    int cpu = -1;                       // CPU to pin to; -1 = the one we started on
+    bool pin = true;
+    std::string filter = ".*";          // regex over benchmark names
+    std::string json_file;              // Google Benchmark style JSON, if set
+    bool list = false;
+};
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& opts) : options(opts) {}
+
+    // Pins the process and runs every benchmark whose name matches the filter.
+    // Returns the number run.
+    size_t run(const BenchRegistry& registry) {
+        std::regex filter(options.filter);
+        std::vector<const Benchmark*> selected;
+        for (const auto& b : registry.all()) {
+            if (std::regex_search(b.name, filter)) selected.push_back(&b);
+        }
+        if (options.list) {
+            for (const auto* b : selected) std::cout << b->name << std::endl;
+            return selected.size();
+        }
+
+        pinned_cpu = options.pin ? pin(options.cpu) : -1;
+        printContext();
+
+        size_t width = 10;
+        for (const auto* b : selected) width = std::max(width, b->name.size() + 2);
+        std::cout << std::left << std::setw(width) << "Benchmark" << std::right <<
+                     std::setw(14) << "Time (ns)" << std::setw(14) << "CPU (ns)" << std::setw(8) << "CV %" <<
+                     std::setw(14) << "Iterations" << std::setw(16) << "Items/s" << "  Bytes/s" << std::endl;
+        std::cout << std::string(width + 80, '-') << std::endl;
+
+        for (const auto* b : selected) {
+            Result result = measure(*b);
+            print(result, width);
+            results.push_back(result);
+        }
+
+        if (!options.json_file.empty()) writeJson(options.json_file);
+        return selected.size();
+    }
+
+private:
+    struct Repetition {
+        double real_ns;             // per iteration
+        double cpu_ns;
+        double items_per_second;
+        double bytes_per_second;
+    };
+
+    struct Result {
+        std::string name;
+        std::string label;
+        uint64_t iterations;
+        std::vector<Repetition> repetitions;
+    };
+
+    static int pin(int cpu) {
+        if (cpu < 0) cpu = sched_getcpu();
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "Warning: could not pin to CPU " << cpu << "; timings may migrate between cores" << std::endl;
+            return -1;
+        }
+        return cpu;
+    }
+
+    void printContext() const {
+        std::cout << "Host CPUs: " << std::thread::hardware_concurrency() << ", pinned to CPU " <<
+                     (pinned_cpu >= 0 ? std::to_string(pinned_cpu) : std::string("none")) << ", " <<
+                     options.repetitions << " repetitions of " << options.min_time << " s after " <<
+                     options.warmup_time << " s warm-up" << std::endl;
+        std::string governor = scalingGovernor(pinned_cpu >= 0 ? pinned_cpu : 0);
+        if (!governor.empty() && governor != "performance") {
+            std::cout << "Warning: CPU frequency governor is '" << governor <<
+                         "'; results will be noisy (use 'performance')" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    static std::string scalingGovernor(int cpu) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_governor");
+        std::string governor;
+        if (file) file >> governor;
+        return governor;
+    }
+
+    static BenchState runOnce(const Benchmark& b, uint64_t iterations) {
+        BenchState state(iterations);
+        b.run(state);
+        if (!state.ran()) throw std::runtime_error(b.name + " never called keepRunning()");
+        return state;
+    }
+
+    Result measure(const Benchmark& b) const {
+        // Warm-up doubles as calibration: the last run gives the time per iteration
+        uint64_t iterations = 1;
+        BenchState probe = runOnce(b, iterations);
+        while (probe.realNs() < options.warmup_time * 1e9 && iterations < (1ull << 40)) {
+            double scale = probe.realNs() > 0 ? options.warmup_time * 1e9 / probe.realNs() : 10.0;
+            iterations = std::max(iterations * 2, static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+            probe = runOnce(b, iterations);
+        }
+        double ns_per_iteration = probe.realNs() / iterations;
+        iterations = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(options.min_time * 1e9 / ns_per_iteration)));
+
+        Result result = {b.name, probe.label(), iterations, {}};
+        for (unsigned r = 0; r < options.repetitions; ++r) {
+            BenchState state = runOnce(b, iterations);
+            double seconds = state.realNs() / 1e9;
+            result.repetitions.push_back({state.realNs() / iterations, state.cpuNs() / iterations,
+                                          state.items() / seconds, state.bytes() / seconds});
+            result.label = state.label();
+        }
+        return result;
+    }
+
+    struct Stats {
+        double mean, median, stddev, cv;
+    };
+
+    template <typename Field>
+    static Stats stats(const std::vector<Repetition>& reps, Field field) {
+        std::vector<double> values;
+        for (const auto& r : reps) values.push_back(r.*field);
+        std::sort(values.begin(), values.end());
+        double mean = 0.0;
+        for (double v : values) mean += v;
+        mean /= values.size();
+        double var = 0.0;
+        for (double v : values) var += (v - mean) * (v - mean);
+        double stddev = values.size() > 1 ? std::sqrt(var / (values.size() - 1)) : 0.0;
+        size_t mid = values.size() / 2;
+        double median = values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+        return {mean, median, stddev, mean > 0 ? stddev / mean : 0.0};
+    }
+
+    static std::string rate(double per_second) {
+        if (per_second <= 0.0) return "-";
+        static const char* units[] = {"", "k", "M", "G", "T"};
+        size_t u = 0;
+        while (per_second >= 1000.0 && u + 1 < sizeof(units) / sizeof(units[0])) {
+            per_second /= 1000.0;
+            u++;
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3g%s", per_second, units[u]);
+        return text;
+    }
+
+    void print(const Result& r, size_t width) const {
+        Stats real = stats(r.repetitions, &Repetition::real_ns);
+        Stats cpu = stats(r.repetitions, &Repetition::cpu_ns);
+        Stats items = stats(r.repetitions, &Repetition::items_per_second);
+        Stats bytes = stats(r.repetitions, &Repetition::bytes_per_second);
+        std::cout << std::left << std::setw(width) << r.name << std::right << std::fixed << std::setprecision(1) <<
+                     std::setw(14) << real.median << std::setw(14) << cpu.median <<
+                     std::setw(8) << 100.0 * real.cv << std::setw(14) << r.iterations <<
+                     std::setw(16) << rate(items.median) << "  " << rate(bytes.median);
+        if (!r.label.empty()) std::cout << "  " << r.label;
+        std::cout << std::endl;
+    }
+
+    // Same shape as Google Benchmark's --benchmark_out, so its compare.py and
+    // other tooling can read it: one entry per repetition, then aggregates
+    void writeJson(const std::string& filename) const {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot write " + filename);
+        char host[256] = {};
+        gethostname(host, sizeof(host) - 1);
+
+        out << "{\n  \"context\": {\"host_name\": \"" << host << "\", \"num_cpus\": " <<
+               std::thread::hardware_concurrency() << ", \"pinned_cpu\": " << pinned_cpu <<
+               ", \"repetitions\": " << options.repetitions << ", \"min_time\": " << options.min_time << "},\n";
+        out << "  \"benchmarks\": [";
+        bool first = true;
+        auto entry = [&](const Result& r, const std::string& run_type, const std::string& aggregate, int index,
+                         double real, double cpu, double items, double bytes) {
+            out << (first ? "\n" : ",\n") << "    {\"name\": \"" << r.name << (aggregate.empty() ? "" : "_" + aggregate) <<
+                   "\", \"run_name\": \"" << r.name << "\", \"run_type\": \"" << run_type << "\"";
+            if (aggregate.empty()) out << ", \"repetition_index\": " << index;
+            else out << ", \"aggregate_name\": \"" << aggregate << "\"";
+            out << std::setprecision(6) << std::defaultfloat <<
+                   ", \"repetitions\": " << options.repetitions << ", \"iterations\": " << r.iterations <<
+                   ", \"real_time\": " << real << ", \"cpu_time\": " << cpu << ", \"time_unit\": \"ns\"";
+            if (items > 0) out << ", \"items_per_second\": " << items;
+            if (bytes > 0) out << ", \"bytes_per_second\": " << bytes;
+            out << "}";
+            first = false;
+        };
+        for (const auto& r : results) {
+            for (size_t i = 0; i < r.repetitions.size(); ++i) {
+                const Repetition& rep = r.repetitions[i];
+                entry(r, "iteration", "", static_cast<int>(i), rep.real_ns, rep.cpu_ns,
+                      rep.items_per_second, rep.bytes_per_second);
+            }
+            Stats real = stats(r.repetitions, &Repetition::real_ns);
+            Stats cpu = stats(r.repetitions, &Repetition::cpu_ns);
+            Stats items = stats(r.repetitions, &Repetition::items_per_second);
+            Stats bytes = stats(r.repetitions, &Repetition::bytes_per_second);
+            entry(r, "aggregate", "mean", 0, real.mean, cpu.mean, items.mean, bytes.mean);
+            entry(r, "aggregate", "median", 0, real.median, cpu.median, items.median, bytes.median);
+            entry(r, "aggregate", "stddev", 0, real.stddev, cpu.stddev, items.stddev, bytes.stddev);
+            entry(r, "aggregate", "cv", 0, real.cv, cpu.cv, items.cv, bytes.cv);
+        }
+        out << "\n  ]\n}\n";
+        std::cout << std::endl << "Results written to: " << filename << std::endl;
+    }
+
+    BenchOptions options;
+    int pinned_cpu = -1;
+    std::vector<Result> results;
+};
+
+#endif // BENCH_HARNESS_H
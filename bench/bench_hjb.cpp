@@ -0,0 +1,94 @@
+/*
+ * HJB wrapper benchmarks: one quote at a time through hjb_calculate()
+ * against a batch through each path (FSM core, pipelined stream, fixed-point
+ * stream, native model). Items are quotes, so the rows compare directly.
+ * Model construction and reset are setup and not timed.
+ */
+
+#include <random>
+#include <vector>
+
+#include "bench_harness.h"
+#include "hjb_wrapper.h"
+
+static constexpr size_t BATCH = 1024;
+static constexpr double HJB_GAMMA = 0.1;
+static constexpr double HJB_KAPPA = 1.5;
+
+// Same input distribution as hjb_benchmark
+struct QuoteInputs {
+    std::vector<double> mid, vol;
+    std::vector<int32_t> inv;
+    std::vector<HJBResult> out;
+
+    QuoteInputs() : mid(BATCH), vol(BATCH), inv(BATCH), out(BATCH) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<> mid_dist(90000.0, 110000.0);
+        std::uniform_int_distribution<> inv_dist(-100, 100);
+        std::uniform_real_distribution<> vol_dist(0.1, 0.5);
+        for (size_t i = 0; i < BATCH; ++i) {
+            mid[i] = mid_dist(gen);
+            inv[i] = inv_dist(gen);
+            vol[i] = vol_dist(gen);
+        }
+    }
+};
+
+static void benchScalar(BenchState& state) {
+    QuoteInputs q;
+    hjb_init();
+    size_t i = 0;
+    while (state.keepRunning()) {
+        hjb_calculate(q.mid[i], q.inv[i], q.vol[i], &q.out[i]);
+        i = (i + 1) % BATCH;
+    }
+    hjb_cleanup();
+    state.setItemsProcessed(state.iterations());
+}
+
+static void benchBatch(BenchState& state) {
+    QuoteInputs q;
+    hjb_init();
+    while (state.keepRunning()) {
+        doNotOptimize(hjb_calculate_batch(q.mid.data(), q.inv.data(), q.vol.data(), BATCH, q.out.data()));
+    }
+    hjb_cleanup();
+    state.setItemsProcessed(state.iterations() * BATCH);
+}
+
+static void benchStream(BenchState& state) {
+    QuoteInputs q;
+    HJBStreamEngine* engine = hjb_stream_create();
+    while (state.keepRunning()) {
+        doNotOptimize(hjb_stream_calculate_batch(engine, q.mid.data(), q.inv.data(), q.vol.data(), BATCH, q.out.data()));
+    }
+    hjb_stream_destroy(engine);
+    state.setItemsProcessed(state.iterations() * BATCH);
+}
+
+static void benchFixed(BenchState& state) {
+    QuoteInputs q;
+    HJBFixedEngine* engine = hjb_fixed_create(HJB_GAMMA, HJB_KAPPA);
+    while (state.keepRunning()) {
+        doNotOptimize(hjb_fixed_calculate_batch(engine, q.mid.data(), q.inv.data(), q.vol.data(), BATCH, q.out.data()));
+    }
+    hjb_fixed_destroy(engine);
+    state.setItemsProcessed(state.iterations() * BATCH);
+}
+
+static void benchNative(BenchState& state) {
+    QuoteInputs q;
+    while (state.keepRunning()) {
+        doNotOptimize(hjb_calculate_native_batch(q.mid.data(), q.inv.data(), q.vol.data(), BATCH, q.out.data()));
+        clobberMemory();
+    }
+    state.setItemsProcessed(state.iterations() * BATCH);
+}
+
+void registerHjbBenchmarks(BenchRegistry& registry) {
+    registry.add("hjb/scalar", benchScalar);
+    registry.add("hjb/batch/1024", benchBatch);
+    registry.add("hjb/stream/1024", benchStream);
+    registry.add("hjb/fixed/1024", benchFixed);
+    registry.add("hjb/native/1024", benchNative);
+}
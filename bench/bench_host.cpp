@@ -0,0 +1,175 @@
+/*
+ * Host-side benchmarks: market data generation and tick file I/O
+ *
+ * generator/... MarketDataGenerator's wall-clock path (generateTick,
+ *               generateBurst) against the structure-of-arrays generateInto
+ * tick_io/...   the same ticks written and read back as CSV and as the
+ *               binary tick format; the read side goes through
+ *               LoadGenerator's replay, which is what the testbench uses
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bench_harness.h"
+#include "market_data_generator.h"
+#include "load_generator.h"
+#include "tick_file.h"
+
+static constexpr size_t BURST_TICKS = 1024;
+static constexpr size_t IO_TICKS = 100000;
+
+// saveToFile()/saveToBinary() report every file they write; keep that out
+// of the results table
+class SilenceCout {
+public:
+    SilenceCout() : saved(std::cout.rdbuf(nullptr)) {}
+    ~SilenceCout() { std::cout.rdbuf(saved); }
+
+private:
+    std::streambuf* saved;
+};
+
+static std::string tempPath(const char* name) {
+    const char* dir = std::getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/veritrade_bench_" + std::to_string(getpid()) + "_" + name;
+}
+
+static uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+// One set of ticks shared by the I/O benchmarks, with a CSV and a binary
+// copy on disk for the read side
+struct TickFixture {
+    std::vector<MarketTick> ticks;
+    std::string csv_file = tempPath("ticks.csv");
+    std::string bin_file = tempPath("ticks.bin");
+    MarketDataGenerator generator;
+
+    TickFixture() : ticks(IO_TICKS) {
+        generator.generateInto(ticks.data(), ticks.size());
+        SilenceCout quiet;
+        generator.saveToFile(ticks, csv_file);
+        generator.saveToBinary(ticks, bin_file);
+    }
+
+    ~TickFixture() {
+        std::remove(csv_file.c_str());
+        std::remove(bin_file.c_str());
+    }
+};
+
+static TickFixture& tickFixture() {
+    static TickFixture fixture;
+    return fixture;
+}
+
+static void benchGenerateTick(BenchState& state) {
+    MarketDataGenerator generator;
+    size_t symbol = 0;
+    while (state.keepRunning()) {
+        doNotOptimize(generator.generateTick(symbol));
+        symbol = (symbol + 1) % 5;
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+static void benchGenerateBurst(BenchState& state) {
+    MarketDataGenerator generator;
+    while (state.keepRunning()) {
+        std::vector<MarketTick> ticks = generator.generateBurst(BURST_TICKS);
+        doNotOptimize(ticks.data());
+    }
+    state.setItemsProcessed(state.iterations() * BURST_TICKS);
+    state.setBytesProcessed(state.iterations() * BURST_TICKS * sizeof(MarketTick));
+}
+
+static void benchGenerateInto(BenchState& state) {
+    MarketDataGenerator generator;
+    std::vector<MarketTick> ticks(BURST_TICKS);
+    while (state.keepRunning()) {
+        generator.generateInto(ticks.data(), ticks.size());
+        clobberMemory();
+    }
+    state.setItemsProcessed(state.iterations() * BURST_TICKS);
+    state.setBytesProcessed(state.iterations() * BURST_TICKS * sizeof(MarketTick));
+}
+
+static void benchCsvWrite(BenchState& state) {
+    TickFixture& fixture = tickFixture();
+    std::string path = tempPath("write.csv");
+    SilenceCout quiet;
+    while (state.keepRunning()) {
+        fixture.generator.saveToFile(fixture.ticks, path);
+    }
+    state.setItemsProcessed(state.iterations() * fixture.ticks.size());
+    state.setBytesProcessed(state.iterations() * fileSize(path));
+    std::remove(path.c_str());
+}
+
+static void benchBinaryWrite(BenchState& state) {
+    TickFixture& fixture = tickFixture();
+    std::string path = tempPath("write.bin");
+    SilenceCout quiet;
+    while (state.keepRunning()) {
+        fixture.generator.saveToBinary(fixture.ticks, path);
+    }
+    state.setItemsProcessed(state.iterations() * fixture.ticks.size());
+    state.setBytesProcessed(state.iterations() * fileSize(path));
+    std::remove(path.c_str());
+}
+
+// Parse into the load generator's schedule, as a --load=replay phase does
+static void benchReplayRead(BenchState& state, const std::string& path) {
+    LoadConfig config;
+    config.process = ArrivalProcess::Replay;
+    config.replay_file = path;
+    config.messages = IO_TICKS;
+    LoadGenerator generator(config, {});
+    while (state.keepRunning()) {
+        std::vector<LoadMessage> schedule = generator.build(0.0);
+        doNotOptimize(schedule.data());
+    }
+    state.setItemsProcessed(state.iterations() * IO_TICKS);
+    state.setBytesProcessed(state.iterations() * fileSize(path));
+}
+
+static void benchCsvRead(BenchState& state) {
+    benchReplayRead(state, tickFixture().csv_file);
+}
+
+static void benchBinaryRead(BenchState& state) {
+    benchReplayRead(state, tickFixture().bin_file);
+}
+
+// Map and walk the records in place, as the threaded pipeline's producer does
+static void benchBinaryScan(BenchState& state) {
+    const std::string& path = tickFixture().bin_file;
+    while (state.keepRunning()) {
+        TickFileReader reader(path);
+        uint64_t volume = 0;
+        for (const MarketTick& tick : reader.ticks()) volume += tick.volume;
+        doNotOptimize(volume);
+    }
+    state.setItemsProcessed(state.iterations() * IO_TICKS);
+    state.setBytesProcessed(state.iterations() * fileSize(path));
+}
+
+void registerHostBenchmarks(BenchRegistry& registry) {
+    registry.add("generator/generateTick", benchGenerateTick);
+    registry.add("generator/generateBurst/1024", benchGenerateBurst);
+    registry.add("generator/generateInto/1024", benchGenerateInto);
+    registry.add("tick_io/csv_write/100000", benchCsvWrite);
+    registry.add("tick_io/binary_write/100000", benchBinaryWrite);
+    registry.add("tick_io/csv_read/100000", benchCsvRead);
+    registry.add("tick_io/binary_read/100000", benchBinaryRead);
+    registry.add("tick_io/binary_scan/100000", benchBinaryScan);
+}
@@ -0,0 +1,90 @@
+/*
+ * Microbenchmark suite for the host-side C++ components
+ * Shows where host time goes: the HJB wrapper paths, market data
+ * generation, tick file I/O and the per-cycle eval() cost of each Verilated
+ * module on its own. See bench_harness.h for the measurement method.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "verilated.h"
+#include "bench_harness.h"
+
+static void printUsage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]" << std::endl
+              << "  --filter=REGEX            Run benchmarks whose name matches (default: all)" << std::endl
+              << "  --list                    List the matching benchmarks and exit" << std::endl
+              << "  --min-time=S              Seconds per repetition (default: 0.5)" << std::endl
+              << "  --warmup=S                Seconds of warm-up runs before measuring (default: 0.1)" << std::endl
+              << "  --repetitions=N           Repetitions per benchmark (default: 5)" << std::endl
+              << "  --cpu=N                   Pin to CPU N (default: the CPU the process starts on)" << std::endl
+              << "  --no-pin                  Do not pin to a CPU" << std::endl
+              << "  --json=FILE               Write results as Google Benchmark style JSON" << std::endl;
+}
+
+static bool parseArgs(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t len = std::strlen(name);
+            return (std::strncmp(arg, name, len) == 0 && arg[len] == '=') ? arg + len + 1 : nullptr;
+        };
+
+        if (const char* v = value("--filter")) {
+            options.filter = v;
+        } else if (const char* v = value("--min-time")) {
+            options.min_time = std::strtod(v, nullptr);
+        } else if (const char* v = value("--warmup")) {
+            options.warmup_time = std::strtod(v, nullptr);
+        } else if (const char* v = value("--repetitions")) {
+            options.repetitions = std::strtoul(v, nullptr, 10);
+            if (options.repetitions == 0) return false;
+        } else if (const char* v = value("--cpu")) {
+            options.cpu = std::atoi(v);
+        } else if (const char* v = value("--json")) {
+            options.json_file = v;
+        } else if (std::strcmp(arg, "--no-pin") == 0) {
+            options.pin = false;
+        } else if (std::strcmp(arg, "--list") == 0) {
+            options.list = true;
+        } else if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (arg[0] == '-' && arg[1] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+        // Anything else (e.g. +verilator+ plusargs) is left to Verilator
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        BenchRegistry registry;
+        registerHjbBenchmarks(registry);
+        registerHostBenchmarks(registry);
+        registerEvalBenchmarks(registry);
+
+        BenchRunner runner(options);
+        if (runner.run(registry) == 0) {
+            std::cerr << "No benchmarks match " << options.filter << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
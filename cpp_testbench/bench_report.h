@@ -0,0 +1,163 @@
+/*
+ * Machine-readable benchmark results
+ *
+ * The testbench phases record named metrics into sections ("high_frequency",
+ * "latency", "counters", ...) and the report is written as one flat-ish JSON
+ * object for run_simulation.py to merge into simulation_report.json and
+ * compare against a stored baseline:
+ *
+ *   {"version": 1, "clock_period_ns": 4,
+ *    "high_frequency": {"ticks": 10000, "ticks_per_second": 1.2e6, ...},
+ *    "latency": {"samples": 1000, "p99_cycles": 9, ...}}
+ *
+ * Metric names carry their direction for the regression gate: names like
+ * "simulated_*_per_second" are simulated throughputs (higher is better) and
+ * names like "p99_*_cycles" are tail latencies (lower is better). Wall-clock
+ * rates such as "ticks_per_second" and everything else are reported but not
+ * gated.
+ */
+
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "latency_histogram.h"
+
+class BenchReport {
+public:
+    explicit BenchReport(double clock_period_ns) : clock_period_ns(clock_period_ns) {}
+
+    // Adds a metric, or replaces it if the section already has one by that name
+    void set(const std::string& section, const std::string& key, double value) {
+        Metrics& metrics = find(section);
+        for (auto& m : metrics) {
+            if (m.first == key) {
+                m.second = value;
+                return;
+            }
+        }
+        metrics.emplace_back(key, value);
+    }
+
+    // Sample count, mean and percentiles of a histogram in cycles
+    void setLatency(const std::string& section, const LatencyHistogram& hist) {
+        set(section, "samples", static_cast<double>(hist.count()));
+        set(section, "mean_cycles", hist.mean());
+        set(section, "p50_cycles", static_cast<double>(hist.percentile(50.0)));
+        set(section, "p90_cycles", static_cast<double>(hist.percentile(90.0)));
+        set(section, "p99_cycles", static_cast<double>(hist.percentile(99.0)));
+        set(section, "p999_cycles", static_cast<double>(hist.percentile(99.9)));
+        set(section, "max_cycles", static_cast<double>(hist.max()));
+    }
+
+    bool empty() const { return sections.empty(); }
+
+    // Checkpoint support, same Stream interface as LatencyHistogram::save()
+    template <typename Stream>
+    void save(Stream& os) const {
+        uint64_t count = sections.size();
+        os.write(&count, sizeof(count));
+        for (const auto& section : sections) {
+            saveString(os, section.first);
+            uint64_t metrics = section.second.size();
+            os.write(&metrics, sizeof(metrics));
+            for (const auto& m : section.second) {
+                saveString(os, m.first);
+                os.write(&m.second, sizeof(m.second));
+            }
+        }
+    }
+
+    template <typename Stream>
+    void restore(Stream& is) {
+        uint64_t count = 0;
+        is.read(&count, sizeof(count));
+        sections.clear();
+        for (uint64_t i = 0; i < count; ++i) {
+            std::string section = restoreString(is);
+            Metrics& metrics = find(section);
+            uint64_t n = 0;
+            is.read(&n, sizeof(n));
+            for (uint64_t j = 0; j < n; ++j) {
+                std::string key = restoreString(is);
+                double value = 0.0;
+                is.read(&value, sizeof(value));
+                metrics.emplace_back(std::move(key), value);
+            }
+        }
+    }
+
+    void write(std::ostream& os) const {
+        os << "{\n  \"version\": 1,\n  \"clock_period_ns\": " << clock_period_ns;
+        for (const auto& section : sections) {
+            os << ",\n  \"" << section.first << "\": {";
+            for (size_t i = 0; i < section.second.size(); ++i) {
+                os << (i ? ", " : "") << "\"" << section.second[i].first << "\": ";
+                writeNumber(os, section.second[i].second);
+            }
+            os << "}";
+        }
+        os << "\n}\n";
+    }
+
+    void writeFile(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file) throw std::runtime_error("Cannot write " + filename);
+        write(file);
+    }
+
+private:
+    using Metrics = std::vector<std::pair<std::string, double>>;
+
+    Metrics& find(const std::string& section) {
+        for (auto& s : sections) {
+            if (s.first == section) return s.second;
+        }
+        sections.emplace_back(section, Metrics());
+        return sections.back().second;
+    }
+
+    template <typename Stream>
+    static void saveString(Stream& os, const std::string& str) {
+        uint64_t size = str.size();
+        os.write(&size, sizeof(size));
+        os.write(str.data(), size);
+    }
+
+    template <typename Stream>
+    static std::string restoreString(Stream& is) {
+        uint64_t size = 0;
+        is.read(&size, sizeof(size));
+        std::string str(size, '\0');
+        if (size) is.read(&str[0], size);
+        return str;
+    }
+
+    // Counts print as integers; JSON has no NaN or infinity, so those are null
+    static void writeNumber(std::ostream& os, double value) {
+        if (!std::isfinite(value)) {
+            os << "null";
+        } else if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0) {
+            os << static_cast<int64_t>(value);
+        } else {
+            std::ios::fmtflags flags = os.flags();
+            std::streamsize precision = os.precision(9);
+            os << std::defaultfloat << value;
+            os.flags(flags);
+            os.precision(precision);
+        }
+    }
+
+    double clock_period_ns;
+    std::vector<std::pair<std::string, Metrics>> sections;
+};
+
+#endif // BENCH_REPORT_H
@@ -0,0 +1,94 @@
+/*
+ * Bulk clocking for Verilated models
+ *
+ * Every testbench and the HJB wrapper advanced their model one edge at a
+ * time and polled outputs between edges. CycleRunner does the clocking in
+ * a tight loop and only hands control back when a watched output fires,
+ * so the host does no per-cycle work the caller did not ask for.
+ *
+ * A cycle is a rising edge then a falling edge, with clk left low, so
+ * outputs read after a cycle are the values registered on its rising edge.
+ * Watches and callbacks are template parameters (usually lambdas) and are
+ * inlined into the loop; there are no virtual calls or tracing checks.
+ *
+ *   CycleRunner<Vorder_manager> runner(dut.get());
+ *   runner.run(100);
+ *   auto r = runner.runUntil(1000, [](const Vorder_manager& m) { return m.order_ready; });
+ *   runner.runEvents(10000, [](const Vorder_manager& m) { return m.exec_valid; },
+ *                    [&](uint64_t cycle) { ... });
+ */
+
+#ifndef CYCLE_RUNNER_H
+#define CYCLE_RUNNER_H
+
+#include <cstdint>
+
+template <typename Model>
+class CycleRunner {
+public:
+    struct RunResult {
+        uint64_t cycles;        // cycles advanced, including the one that fired
+        bool fired;             // false when max_cycles ran out first
+    };
+
+    explicit CycleRunner(Model* model) : model(model) {}
+
+    void tick() {
+        model->clk = 1;
+        model->eval();
+        model->clk = 0;
+        model->eval();
+        cycles++;
+    }
+
+    void run(uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) tick();
+    }
+
+    // Advance until watch(model) is true after a cycle, or max_cycles run out
+    template <typename Watch>
+    RunResult runUntil(uint64_t max_cycles, Watch&& watch) {
+        for (uint64_t i = 0; i < max_cycles; ++i) {
+            tick();
+            if (watch(static_cast<const Model&>(*model))) return {i + 1, true};
+        }
+        return {max_cycles, false};
+    }
+
+    // Advance n cycles, calling on_event(cycle) after every cycle where
+    // watch(model) is true; cycle is this runner's count for that cycle.
+    // Returns the number of events.
+    template <typename Watch, typename OnEvent>
+    uint64_t runEvents(uint64_t n, Watch&& watch, OnEvent&& on_event) {
+        uint64_t events = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            tick();
+            if (watch(static_cast<const Model&>(*model))) {
+                on_event(cycles - 1);
+                events++;
+            }
+        }
+        return events;
+    }
+
+    uint64_t cycleCount() const { return cycles; }
+    Model* operator->() const { return model; }
+
+private:
+    Model* model;
+    uint64_t cycles = 0;
+};
+
+// Turns a level watch into one that fires only on the cycle the level
+// rises, for outputs held high for more than one cycle
+template <typename Level>
+auto risingEdge(Level level) {
+    return [level, prev = false](const auto& model) mutable {
+        bool now = level(model);
+        bool rose = now && !prev;
+        prev = now;
+        return rose;
+    };
+}
+
+#endif // CYCLE_RUNNER_H
@@ -0,0 +1,248 @@
+/*
+ * Replay of captured NASDAQ TotalView-ITCH 5.0 feeds
+ *
+ * Accepted inputs, both mapped read-only and parsed in place:
+ * - pcap/pcap-ns captures of Ethernet/IPv4/UDP MoldUDP64 packets
+ *   (session[10] sequence[8] count[2], then [length:2][message] blocks)
+ * - raw ITCH files as distributed by NASDAQ: [length:2][message] repeated
+ *
+ * Each message is framed into 64-bit beats, byte 0 (the message type) in
+ * the most significant byte of the first beat, the final beat zero-padded,
+ * which is the layout market_data_processor assembles with data_last.
+ * Messages are scheduled from the capture time (pcap) or the ITCH
+ * timestamp (raw files), divided by the replay speed factor.
+ */
+
+#ifndef ITCH_REPLAY_H
+#define ITCH_REPLAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct ItchMessage {
+    uint64_t time_ns;           // capture or ITCH time, nanoseconds
+    const uint8_t* data;        // points into the mapping
+    uint16_t length;
+    uint32_t symbol_code;       // first 4 characters of the stock, 0 if unknown
+    bool has_symbol;
+};
+
+class ItchCapture {
+public:
+    enum class Format { Raw, Pcap };
+
+private:
+    static constexpr uint32_t PCAP_MAGIC_US = 0xa1b2c3d4;
+    static constexpr uint32_t PCAP_MAGIC_NS = 0xa1b23c4d;
+    static constexpr uint32_t LINKTYPE_ETHERNET = 1;
+    static constexpr size_t MOLD_HEADER = 20;
+
+    int fd = -1;
+    void* mapping = MAP_FAILED;
+    size_t mapped_size = 0;
+    const uint8_t* base = nullptr;
+    Format file_format = Format::Raw;
+
+    // Cursor: file offset of the next pcap record or raw message block, and
+    // for pcap the unread part of the current MoldUDP64 payload
+    size_t offset = 0;
+    const uint8_t* payload = nullptr;
+    const uint8_t* payload_end = nullptr;
+    uint64_t packet_time_ns = 0;
+    bool swapped = false;
+    bool nanosecond = false;
+
+    uint64_t skipped_packets = 0;
+
+    // Execute/Cancel/Delete/Replace only carry the order reference
+    std::unordered_map<uint64_t, uint32_t> order_symbols;
+
+    static uint16_t be16(const uint8_t* p) { return static_cast<uint16_t>(p[0] << 8 | p[1]); }
+    static uint32_t be32(const uint8_t* p) { return static_cast<uint32_t>(be16(p)) << 16 | be16(p + 2); }
+    static uint64_t be48(const uint8_t* p) { return static_cast<uint64_t>(be16(p)) << 32 | be32(p + 2); }
+    static uint64_t be64(const uint8_t* p) { return static_cast<uint64_t>(be32(p)) << 32 | be32(p + 4); }
+
+    uint32_t pcap32(const uint8_t* p) const {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return swapped ? __builtin_bswap32(v) : v;
+    }
+
+    // Advance to the next pcap record carrying a MoldUDP64 payload
+    bool nextPacket() {
+        while (offset + 16 <= mapped_size) {
+            const uint8_t* rec = base + offset;
+            uint32_t incl_len = pcap32(rec + 8);
+            if (offset + 16 + incl_len > mapped_size) break;      // truncated capture
+            packet_time_ns = pcap32(rec) * 1000000000ull + pcap32(rec + 4) * (nanosecond ? 1ull : 1000ull);
+            const uint8_t* frame = rec + 16;
+            const uint8_t* end = frame + incl_len;
+            offset += 16 + incl_len;
+
+            // Ethernet, optionally 802.1Q tagged
+            const uint8_t* p = frame + 12;
+            if (p + 2 > end) { skipped_packets++; continue; }
+            uint16_t ethertype = be16(p);
+            p += 2;
+            if (ethertype == 0x8100 && p + 4 <= end) {
+                ethertype = be16(p + 2);
+                p += 4;
+            }
+            if (ethertype != 0x0800 || p + 20 > end) { skipped_packets++; continue; }
+
+            // IPv4 / UDP
+            size_t ihl = (p[0] & 0x0f) * 4u;
+            if (p[9] != 17 || p + ihl + 8 > end) { skipped_packets++; continue; }
+            p += ihl + 8;
+            if (p + MOLD_HEADER > end) { skipped_packets++; continue; }
+
+            // MoldUDP64; heartbeats and end-of-session carry no messages
+            uint16_t count = be16(p + 18);
+            p += MOLD_HEADER;
+            if (count == 0 || count == 0xFFFF) continue;
+            payload = p;
+            payload_end = end;
+            return true;
+        }
+        return false;
+    }
+
+    void resolveSymbol(ItchMessage& msg) {
+        const uint8_t* m = msg.data;
+        msg.has_symbol = false;
+        msg.symbol_code = 0;
+        if (msg.length < 19) return;
+        uint64_t ref = be64(m + 11);
+
+        auto lookup = [&](uint64_t key) {
+            auto it = order_symbols.find(key);
+            if (it == order_symbols.end()) return false;
+            msg.symbol_code = it->second;
+            return true;
+        };
+
+        switch (m[0]) {
+            case 'A': case 'F':
+                if (msg.length < 36) return;
+                msg.symbol_code = be32(m + 24);
+                order_symbols[ref] = msg.symbol_code;
+                msg.has_symbol = true;
+                break;
+            case 'E': case 'C': case 'X':
+                msg.has_symbol = lookup(ref);
+                break;
+            case 'D':
+                msg.has_symbol = lookup(ref);
+                order_symbols.erase(ref);
+                break;
+            case 'U':
+                if (msg.length < 35) return;
+                msg.has_symbol = lookup(ref);
+                order_symbols.erase(ref);
+                if (msg.has_symbol) order_symbols[be64(m + 19)] = msg.symbol_code;
+                break;
+            default:
+                break;
+        }
+    }
+
+public:
+    explicit ItchCapture(const std::string& filename) {
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open ITCH file: " + filename);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < 4) {
+            ::close(fd);
+            throw std::runtime_error("Empty or unreadable ITCH file: " + filename);
+        }
+        mapped_size = st.st_size;
+        mapping = ::mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot mmap ITCH file: " + filename);
+        }
+        ::madvise(mapping, mapped_size, MADV_SEQUENTIAL);
+        base = static_cast<const uint8_t*>(mapping);
+
+        uint32_t magic;
+        std::memcpy(&magic, base, sizeof(magic));
+        uint32_t swapped_magic = __builtin_bswap32(magic);
+        if (magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS ||
+            swapped_magic == PCAP_MAGIC_US || swapped_magic == PCAP_MAGIC_NS) {
+            file_format = Format::Pcap;
+            swapped = (swapped_magic == PCAP_MAGIC_US || swapped_magic == PCAP_MAGIC_NS);
+            nanosecond = (magic == PCAP_MAGIC_NS || swapped_magic == PCAP_MAGIC_NS);
+            if (mapped_size < 24 || pcap32(base + 20) != LINKTYPE_ETHERNET) {
+                unmap();
+                throw std::runtime_error("Unsupported pcap link type (Ethernet required): " + filename);
+            }
+            offset = 24;
+        }
+    }
+
+    ~ItchCapture() { unmap(); }
+
+    ItchCapture(const ItchCapture&) = delete;
+    ItchCapture& operator=(const ItchCapture&) = delete;
+
+    void unmap() {
+        if (mapping != MAP_FAILED) ::munmap(mapping, mapped_size);
+        if (fd >= 0) ::close(fd);
+        mapping = MAP_FAILED;
+        fd = -1;
+    }
+
+    // Next message in file order; false at end of file
+    bool next(ItchMessage& msg) {
+        if (file_format == Format::Pcap) {
+            while (payload + 2 > payload_end || payload + 2 + be16(payload) > payload_end) {
+                if (!nextPacket()) return false;
+            }
+            msg.length = be16(payload);
+            msg.data = payload + 2;
+            msg.time_ns = packet_time_ns;
+            payload += 2 + msg.length;
+        } else {
+            if (offset + 2 > mapped_size) return false;
+            uint16_t length = be16(base + offset);
+            if (offset + 2 + length > mapped_size) return false;  // truncated tail
+            msg.length = length;
+            msg.data = base + offset + 2;
+            offset += 2 + length;
+            msg.time_ns = length >= 11 ? be48(msg.data + 5) : 0;
+        }
+        if (msg.length == 0) return next(msg);
+        resolveSymbol(msg);
+        return true;
+    }
+
+    Format format() const { return file_format; }
+    uint64_t skippedPackets() const { return skipped_packets; }
+
+    // Big-endian 64-bit beats, last one zero-padded; returns the beat count
+    static size_t toBeats(const ItchMessage& msg, uint64_t* beats, size_t max_beats) {
+        size_t count = std::min<size_t>((msg.length + 7) / 8, max_beats);
+        for (size_t b = 0; b < count; ++b) {
+            uint64_t beat = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                size_t pos = b * 8 + i;
+                beat = (beat << 8) | (pos < msg.length ? msg.data[pos] : 0);
+            }
+            beats[b] = beat;
+        }
+        return count;
+    }
+};
+
+#endif // ITCH_REPLAY_H
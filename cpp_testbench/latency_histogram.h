@@ -0,0 +1,172 @@
+/*
+ * Fixed-memory HDR-style latency histogram
+ *
+ * Values below 2^sub_bucket_bits are counted exactly; above that each
+ * power-of-two range is split into 2^(sub_bucket_bits-1) linear buckets, so
+ * the relative error is bounded by 2^-(sub_bucket_bits-1) at any magnitude.
+ * Memory is sized once from highest_value and never grows, so the histogram
+ * can record for as long as the simulation runs.
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+class LatencyHistogram {
+private:
+    unsigned sub_bucket_bits;
+    uint64_t sub_bucket_count;      // exact range [0, sub_bucket_count)
+    uint64_t sub_bucket_half;       // linear buckets per power of two above it
+    uint64_t highest_value;
+    std::vector<uint64_t> counts;
+
+    uint64_t total_count = 0;
+    uint64_t min_value = std::numeric_limits<uint64_t>::max();
+    uint64_t max_value = 0;
+    double sum = 0.0;
+
+    static unsigned msb(uint64_t value) {
+        return 63 - __builtin_clzll(value);
+    }
+
+    size_t indexOf(uint64_t value) const {
+        if (value < sub_bucket_count) return value;
+        unsigned shift = msb(value) - (sub_bucket_bits - 1);
+        return sub_bucket_count + (shift - 1) * sub_bucket_half + ((value >> shift) - sub_bucket_half);
+    }
+
+    // Largest value that maps to the same bucket as index
+    uint64_t highestEquivalent(size_t index) const {
+        if (index < sub_bucket_count) return index;
+        uint64_t offset = index - sub_bucket_count;
+        unsigned shift = static_cast<unsigned>(offset / sub_bucket_half) + 1;
+        uint64_t top = (offset % sub_bucket_half) + sub_bucket_half;
+        return ((top + 1) << shift) - 1;
+    }
+
+public:
+    explicit LatencyHistogram(uint64_t highest = 1ull << 32, unsigned precision_bits = 8) :
+        sub_bucket_bits(std::max(2u, precision_bits)),
+        sub_bucket_count(1ull << sub_bucket_bits),
+        sub_bucket_half(sub_bucket_count >> 1),
+        highest_value(std::max<uint64_t>(highest, sub_bucket_count))
+    {
+        counts.assign(indexOf(highest_value) + 1, 0);
+    }
+
+    void record(uint64_t value, uint64_t count = 1) {
+        size_t index = std::min(indexOf(std::min(value, highest_value)), counts.size() - 1);
+        counts[index] += count;
+        total_count += count;
+        sum += static_cast<double>(value) * count;
+        if (value < min_value) min_value = value;
+        if (value > max_value) max_value = value;
+    }
+
+    // Adds count samples to a bucket directly, e.g. one read back from the
+    // RTL latency_histogram built with SUB_BUCKET_BITS == precision_bits;
+    // min, max and mean then use the bucket's upper bound
+    void recordBucket(size_t index, uint64_t count) {
+        if (count == 0 || index >= counts.size()) return;
+        record(highestEquivalent(index), count);
+    }
+
+    size_t bucketCount() const { return counts.size(); }
+    uint64_t bucketHigh(size_t index) const { return highestEquivalent(index); }
+    uint64_t bucketLow(size_t index) const { return index == 0 ? 0 : highestEquivalent(index - 1) + 1; }
+
+    // Both histograms must have been built with the same parameters
+    void merge(const LatencyHistogram& other) {
+        size_t n = std::min(counts.size(), other.counts.size());
+        for (size_t i = 0; i < n; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total_count += other.total_count;
+        sum += other.sum;
+        if (other.total_count) {
+            min_value = std::min(min_value, other.min_value);
+            max_value = std::max(max_value, other.max_value);
+        }
+    }
+
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        total_count = 0;
+        min_value = std::numeric_limits<uint64_t>::max();
+        max_value = 0;
+        sum = 0.0;
+    }
+
+    // Checkpoint support. Stream provides write(const void*, size_t) and
+    // read(void*, size_t); restore into a histogram built with the same
+    // parameters.
+    template <typename Stream>
+    void save(Stream& os) const {
+        uint64_t buckets = counts.size();
+        os.write(&buckets, sizeof(buckets));
+        os.write(counts.data(), buckets * sizeof(uint64_t));
+        os.write(&total_count, sizeof(total_count));
+        os.write(&min_value, sizeof(min_value));
+        os.write(&max_value, sizeof(max_value));
+        os.write(&sum, sizeof(sum));
+    }
+
+    template <typename Stream>
+    void restore(Stream& is) {
+        uint64_t buckets = 0;
+        is.read(&buckets, sizeof(buckets));
+        if (buckets != counts.size()) throw std::runtime_error("Checkpoint histogram has a different layout");
+        is.read(counts.data(), buckets * sizeof(uint64_t));
+        is.read(&total_count, sizeof(total_count));
+        is.read(&min_value, sizeof(min_value));
+        is.read(&max_value, sizeof(max_value));
+        is.read(&sum, sizeof(sum));
+    }
+
+    uint64_t count() const { return total_count; }
+    uint64_t min() const { return total_count ? min_value : 0; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total_count ? sum / total_count : 0.0; }
+    size_t memoryBytes() const { return counts.size() * sizeof(uint64_t); }
+
+    // Value at or below which percentile% of recorded values fall
+    uint64_t percentile(double pct) const {
+        if (total_count == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(pct / 100.0 * total_count + 0.5);
+        target = std::max<uint64_t>(1, std::min(target, total_count));
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= target) return std::min(highestEquivalent(i), max_value);
+        }
+        return max_value;
+    }
+
+    // Percentile summary in cycles and nanoseconds
+    void print(std::ostream& os, const char* title, double ns_per_unit) const {
+        static const struct { const char* label; double pct; } percentiles[] = {
+            {"P50:    ", 50.0}, {"P90:    ", 90.0}, {"P99:    ", 99.0},
+            {"P99.9:  ", 99.9}, {"P99.99: ", 99.99}
+        };
+
+        os << std::dec << title << " (" << total_count << " samples, cycles / ns):" << std::endl;
+        os << std::fixed << std::setprecision(1);
+        os << "  Min:    " << std::setw(10) << min() << " / " << min() * ns_per_unit << std::endl;
+        os << "  Mean:   " << std::setw(10) << mean() << " / " << mean() * ns_per_unit << std::endl;
+        for (const auto& p : percentiles) {
+            uint64_t v = percentile(p.pct);
+            os << "  " << p.label << std::setw(10) << v << " / " << v * ns_per_unit << std::endl;
+        }
+        os << "  Max:    " << std::setw(10) << max() << " / " << max() * ns_per_unit << std::endl;
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
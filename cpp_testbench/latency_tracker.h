@@ -0,0 +1,137 @@
+/*
+ * Tick-to-trade latency tracking for the Verilator C++ testbench
+ *
+ * Every injected tick gets a sequence ID and its injection cycle. When the
+ * DUT reports an execution, it is matched to the oldest in-flight tick for
+ * the same symbol; the trading pipeline is in order, so that is the tick the
+ * order came from. Ticks that produce no execution within max_age cycles
+ * are retired as unmatched, which bounds the in-flight window and keeps
+ * memory flat however many ticks are pushed through.
+ *
+ * Matching is exact while the pipeline accepts every tick. Ticks dropped
+ * while the order path is busy sit at the head of their symbol's queue until
+ * they age out, so space injections beyond the pipeline occupancy (or call
+ * retireAll() between phases) when measuring.
+ */
+
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <cstdint>
+#include <deque>
+
+class TickLatencyTracker {
+public:
+    struct Match {
+        bool matched;
+        uint64_t sequence;
+        uint64_t latency;       // cycles from injection to execution
+    };
+
+private:
+    struct InFlightTick {
+        uint64_t sequence;
+        uint64_t inject_cycle;
+        uint32_t symbol;
+        bool done;
+    };
+
+    std::deque<InFlightTick> in_flight;
+    uint64_t max_age;
+    uint64_t live = 0;
+    uint64_t matched_count = 0;
+    uint64_t unmatched_count = 0;
+    uint64_t unexpected_count = 0;
+
+    void popFinished() {
+        while (!in_flight.empty() && in_flight.front().done) {
+            in_flight.pop_front();
+        }
+    }
+
+public:
+    explicit TickLatencyTracker(uint64_t max_age_cycles = 1000) : max_age(max_age_cycles) {}
+
+    void onTick(uint64_t sequence, uint64_t cycle, uint32_t symbol) {
+        in_flight.push_back({sequence, cycle, symbol, false});
+        live++;
+    }
+
+    Match onExecution(uint64_t cycle, uint32_t symbol) {
+        for (auto& tick : in_flight) {
+            if (!tick.done && tick.symbol == symbol) {
+                tick.done = true;
+                live--;
+                matched_count++;
+                // Build the match first: popFinished() may release this tick
+                Match match = {true, tick.sequence, cycle - tick.inject_cycle};
+                popFinished();
+                return match;
+            }
+        }
+        unexpected_count++;
+        return {false, 0, 0};
+    }
+
+    // Retire ticks that are too old to still produce an execution
+    void expire(uint64_t cycle) {
+        while (!in_flight.empty() &&
+               (in_flight.front().done || cycle - in_flight.front().inject_cycle > max_age)) {
+            if (!in_flight.front().done) {
+                live--;
+                unmatched_count++;
+            }
+            in_flight.pop_front();
+        }
+    }
+
+    // Retire everything still in flight, e.g. between test phases so that
+    // ticks which never traded cannot absorb the next phase's executions
+    void retireAll() {
+        unmatched_count += live;
+        live = 0;
+        in_flight.clear();
+    }
+
+    // First cycle on which expire() would retire the oldest in-flight tick
+    uint64_t nextExpiry() const {
+        return in_flight.empty() ? UINT64_MAX : in_flight.front().inject_cycle + max_age + 1;
+    }
+
+    // Checkpoint support, same Stream interface as LatencyHistogram::save()
+    template <typename Stream>
+    void save(Stream& os) const {
+        uint64_t ticks = in_flight.size();
+        os.write(&ticks, sizeof(ticks));
+        for (const auto& tick : in_flight) {
+            os.write(&tick, sizeof(tick));
+        }
+        os.write(&live, sizeof(live));
+        os.write(&matched_count, sizeof(matched_count));
+        os.write(&unmatched_count, sizeof(unmatched_count));
+        os.write(&unexpected_count, sizeof(unexpected_count));
+    }
+
+    template <typename Stream>
+    void restore(Stream& is) {
+        uint64_t ticks = 0;
+        is.read(&ticks, sizeof(ticks));
+        in_flight.clear();
+        for (uint64_t i = 0; i < ticks; ++i) {
+            InFlightTick tick;
+            is.read(&tick, sizeof(tick));
+            in_flight.push_back(tick);
+        }
+        is.read(&live, sizeof(live));
+        is.read(&matched_count, sizeof(matched_count));
+        is.read(&unmatched_count, sizeof(unmatched_count));
+        is.read(&unexpected_count, sizeof(unexpected_count));
+    }
+
+    uint64_t inFlight() const { return live; }
+    uint64_t matched() const { return matched_count; }
+    uint64_t unmatched() const { return unmatched_count; }
+    uint64_t unexpected() const { return unexpected_count; }
+};
+
+#endif // LATENCY_TRACKER_H
@@ -0,0 +1,195 @@
+/*
+ * Open-loop load generation for the Verilator C++ testbench
+ *
+ * Builds a message schedule whose arrival times do not depend on the DUT,
+ * so congestion shows up as queueing delay instead of silently slowing the
+ * offered load down. Arrival processes:
+ * - Poisson: exponential inter-arrival times at the target rate
+ * - Hawkes:  self-exciting bursts (exponential kernel); the background rate
+ *            is chosen so the long-run average matches the target rate
+ * - Replay:  ticks from a MarketDataGenerator binary tick file or CSV,
+ *            optionally rescaled to the target rate while keeping the
+ *            recorded burst shape
+ */
+
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tick_file.h"
+
+enum class ArrivalProcess { Poisson, Hawkes, Replay };
+
+struct LoadConfig {
+    bool enabled = false;
+    ArrivalProcess process = ArrivalProcess::Poisson;
+    std::vector<double> rates = {50e6};     // offered messages/second, one phase per rate
+    uint64_t messages = 100000;             // per phase (Replay: capped by the file)
+    double hawkes_branching = 0.7;          // mean children per event, must be < 1
+    double hawkes_decay_ns = 200.0;         // excitation time constant
+    std::string replay_file;
+    size_t queue_capacity = 4096;           // feed-side buffer; arrivals beyond it are dropped
+    uint64_t seed = 1;
+};
+
+struct LoadMessage {
+    uint64_t arrival_ns;                    // relative to the start of the phase
+    uint32_t symbol_code;
+    uint32_t price;
+    uint32_t volume;
+    uint8_t msg_type;
+};
+
+class LoadGenerator {
+private:
+    const LoadConfig& config;
+    const std::vector<uint32_t>& symbol_codes;
+    std::mt19937_64 gen;
+
+    LoadMessage randomMessage(double arrival_ns) {
+        std::uniform_int_distribution<size_t> symbol_dist(0, symbol_codes.size() - 1);
+        std::uniform_int_distribution<uint32_t> price_dist(0, 0xFFFF);
+        std::uniform_int_distribution<uint32_t> type_dist(0, 99);
+
+        uint32_t t = type_dist(gen);
+        uint8_t msg_type = t < 70 ? 0x41 : t < 85 ? 0x45 : 0x58;  // Add / Execute / Cancel
+        return {static_cast<uint64_t>(arrival_ns), symbol_codes[symbol_dist(gen)],
+                0x96000000 + price_dist(gen), 0x64000000, msg_type};
+    }
+
+    std::vector<LoadMessage> poisson(double rate) {
+        std::exponential_distribution<> gap_ns(rate / 1e9);
+        std::vector<LoadMessage> out;
+        out.reserve(config.messages);
+
+        double t = 0.0;
+        for (uint64_t i = 0; i < config.messages; ++i) {
+            t += gap_ns(gen);
+            out.push_back(randomMessage(t));
+        }
+        return out;
+    }
+
+    // Ogata thinning; between events the intensity only decays, so the
+    // intensity right after the last event bounds it until the next one
+    std::vector<LoadMessage> hawkes(double rate) {
+        double n = config.hawkes_branching;
+        if (n < 0.0 || n >= 1.0) throw std::invalid_argument("Hawkes branching ratio must be in [0, 1)");
+
+        double beta = 1.0 / config.hawkes_decay_ns;
+        double mu = rate / 1e9 * (1.0 - n);             // events per ns
+        double alpha = n * beta;                        // jump in intensity per event
+
+        std::uniform_real_distribution<> uniform(0.0, 1.0);
+        std::vector<LoadMessage> out;
+        out.reserve(config.messages);
+
+        double t = 0.0;
+        double excitation = 0.0;                        // intensity above mu at time t
+        while (out.size() < config.messages) {
+            double bound = mu + excitation;
+            double dt = -std::log(1.0 - uniform(gen)) / bound;
+            t += dt;
+            excitation *= std::exp(-beta * dt);
+            if (uniform(gen) * bound <= mu + excitation) {
+                out.push_back(randomMessage(t));
+                excitation += alpha;
+            }
+        }
+        return out;
+    }
+
+    static LoadMessage fromTick(const MarketTick& tick, uint64_t first_us) {
+        return {(tick.timestamp - first_us) * 1000, tick.symbol_code, tick.price, tick.volume, tick.msg_type};
+    }
+
+    void readTickFile(std::vector<LoadMessage>& out) {
+        TickFileReader reader(config.replay_file);
+        TickSpan ticks = reader.ticks();
+        size_t n = std::min<size_t>(ticks.size, config.messages);
+        out.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            out.push_back(fromTick(ticks[i], ticks[0].timestamp));
+        }
+    }
+
+    // MarketDataGenerator CSV: timestamp(us),symbol_code,price,volume,bid,ask,msg_type
+    void readCsv(std::vector<LoadMessage>& out) {
+        std::ifstream file(config.replay_file);
+        if (!file) throw std::runtime_error("Cannot open replay file: " + config.replay_file);
+
+        std::string line;
+        std::getline(file, line);                       // header
+        uint64_t first_us = 0;
+        while (out.size() < config.messages && std::getline(file, line)) {
+            const char* p = line.c_str();
+            char* end;
+            uint64_t fields[7];
+            size_t count = 0;
+            for (; count < 7; ++count) {
+                fields[count] = std::strtoull(p, &end, 0);
+                if (end == p) break;
+                p = (*end == ',') ? end + 1 : end;
+            }
+            if (count < 7) continue;
+
+            if (out.empty()) first_us = fields[0];
+            out.push_back({(fields[0] - first_us) * 1000, static_cast<uint32_t>(fields[1]),
+                           static_cast<uint32_t>(fields[2]), static_cast<uint32_t>(fields[3]),
+                           static_cast<uint8_t>(fields[6])});
+        }
+    }
+
+    std::vector<LoadMessage> replay(double rate) {
+        std::vector<LoadMessage> out;
+        if (TickFileReader::isTickFile(config.replay_file)) {
+            readTickFile(out);
+        } else {
+            readCsv(out);
+        }
+        if (out.empty()) throw std::runtime_error("No ticks in replay file: " + config.replay_file);
+
+        // Rescale so the recorded span carries the offered rate
+        uint64_t span = out.back().arrival_ns;
+        if (rate > 0.0 && span > 0 && out.size() > 1) {
+            double scale = (out.size() - 1) / (rate / 1e9) / span;
+            for (auto& msg : out) msg.arrival_ns = static_cast<uint64_t>(msg.arrival_ns * scale);
+        }
+        return out;
+    }
+
+public:
+    LoadGenerator(const LoadConfig& cfg, const std::vector<uint32_t>& codes) :
+        config(cfg), symbol_codes(codes), gen(cfg.seed) {}
+
+    // Schedule for one phase, sorted by arrival_ns
+    std::vector<LoadMessage> build(double rate) {
+        if (rate <= 0.0 && config.process != ArrivalProcess::Replay) {
+            throw std::invalid_argument("Offered load rate must be positive");
+        }
+        switch (config.process) {
+            case ArrivalProcess::Hawkes: return hawkes(rate);
+            case ArrivalProcess::Replay: return replay(rate);
+            default:                     return poisson(rate);
+        }
+    }
+
+    static const char* processName(ArrivalProcess process) {
+        switch (process) {
+            case ArrivalProcess::Hawkes: return "hawkes";
+            case ArrivalProcess::Replay: return "replay";
+            default:                     return "poisson";
+        }
+    }
+};
+
+#endif // LOAD_GENERATOR_H
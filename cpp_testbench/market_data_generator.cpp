@@ -1,12 +1,11 @@
 /*
  * Market Data Generator for C++ Testbench
- * Realistic market data generation for FPGA trading system testing
+ * Standalone utility around MarketDataGenerator (market_data_generator.h)
  * 
  * Features:
- * - Realistic price movements
- * - Volume profile simulation
- * - Multiple message types
- * - Configurable market conditions
+ * - CSV or binary tick file output
+ * - Deterministic multi-threaded streams (tick_streams.h)
+ * - Generation rate benchmark
  */
 
 #include <iostream>
@@ -19,157 +18,148 @@
 #include <thread>
 #include <iomanip>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>
 
-class MarketDataGenerator {
-private:
-    std::mt19937 gen;
-    std::normal_distribution<> price_change_dist;
-    std::exponential_distribution<> volume_dist;
-    std::uniform_real_distribution<> uniform_dist;
-    
-    struct Symbol {
-        std::string name;
-        uint32_t code;
-        double price;
-        double volatility;
-        uint32_t avg_volume;
-        uint32_t tick_size;
-    };
+#include "tick_file.h"
+#include "tick_streams.h"
+#include "market_data_generator.h"
+
+// Standalone market data generator utility
+//   market_data_generator [--ticks=N] [--format=csv|bin] [--output=FILE]
+//                         [--seed=S [--symbols=N] [--threads=T] [--day-seconds=D]]
+// --seed switches to the deterministic Philox streams in tick_streams.h
+static void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [--ticks=N] [--format=csv|bin] [--output=FILE]" << std::endl
+              << "       [--seed=S [--symbols=N] [--threads=T] [--day-seconds=D]]" << std::endl
+              << "       [--benchmark]" << std::endl;
+}
+
+// Generation rate of the wall-clock path (generateBurst) vs the high-rate
+// path (generateInto into a reused buffer)
+static void runBenchmark(MarketDataGenerator& generator, size_t num_ticks) {
+    using clock = std::chrono::steady_clock;
     
-    std::vector<Symbol> symbols;
+    auto start = clock::now();
+    auto ticks = generator.generateBurst(num_ticks);
+    double burst_s = std::chrono::duration<double>(clock::now() - start).count();
     
-public:
-    MarketDataGenerator() : 
-        gen(std::random_device{}()),
-        price_change_dist(0.0, 0.01),
-        volume_dist(1.0),
-        uniform_dist(0.0, 1.0)
-    {
-        initializeSymbols();
+    std::vector<MarketTick> buffer(1 << 16);
+    uint64_t checksum = ticks.back().price;
+    start = clock::now();
+    for (size_t done = 0; done < num_ticks; ) {
+        size_t n = std::min(buffer.size(), num_ticks - done);
+        generator.generateInto(buffer.data(), n);
+        checksum += buffer[n - 1].price;
+        done += n;
     }
+    double into_s = std::chrono::duration<double>(clock::now() - start).count();
     
-    void initializeSymbols() {
-        symbols = {
-            {"AAPL", 0x41415054, 150.0, 0.02, 1000, 1},
-            {"GOOGL", 0x474f4f47, 2800.0, 0.025, 500, 1},
-            {"MSFT", 0x4d534654, 300.0, 0.02, 800, 1},
-            {"TSLA", 0x54534c41, 800.0, 0.04, 1200, 1},
-            {"NVDA", 0x4e564441, 500.0, 0.035, 900, 1}
-        };
-    }
-    
-    struct MarketTick {
-        uint32_t symbol_code;
-        uint32_t price;
-        uint32_t volume;
-        uint32_t bid;
-        uint32_t ask;
-        uint8_t msg_type;
-        uint64_t timestamp;
-    };
+    std::cout << std::fixed << std::setprecision(1)
+              << "generateBurst: " << num_ticks / burst_s / 1e6 << " M ticks/s" << std::endl
+              << "generateInto:  " << num_ticks / into_s / 1e6 << " M ticks/s" << std::endl
+              << "Speedup:       " << std::setprecision(2) << burst_s / into_s << "x"
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t num_ticks = 10000;
+    bool binary = false;
+    std::string output;
+    bool deterministic = false;
+    bool benchmark = false;
+    TickStreamConfig stream_config;
     
-    MarketTick generateTick(size_t symbol_idx) {
-        if (symbol_idx >= symbols.size()) {
-            symbol_idx = 0;
-        }
-        
-        Symbol& sym = symbols[symbol_idx];
-        
-        // Generate price change
-        double price_change = price_change_dist(gen) * sym.volatility;
-        sym.price += price_change;
-        
-        // Keep price positive
-        if (sym.price < 1.0) sym.price = 1.0;
-        
-        // Generate volume
-        uint32_t volume = static_cast<uint32_t>(
-            sym.avg_volume * volume_dist(gen)
-        );
-        
-        // Generate bid/ask spread
-        double spread = sym.price * 0.001; // 0.1% spread
-        uint32_t bid = static_cast<uint32_t>((sym.price - spread/2) * 1000000);
-        uint32_t ask = static_cast<uint32_t>((sym.price + spread/2) * 1000000);
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t len = std::strlen(name);
+            return (std::strncmp(arg, name, len) == 0 && arg[len] == '=') ? arg + len + 1 : nullptr;
+        };
         
-        // Determine message type
-        uint8_t msg_type = 0x41; // Default to Add
-        double rand_val = uniform_dist(gen);
-        if (rand_val < 0.7) {
-            msg_type = 0x41; // Add Order
-        } else if (rand_val < 0.85) {
-            msg_type = 0x45; // Execute
-        } else if (rand_val < 0.95) {
-            msg_type = 0x58; // Cancel
+        if (const char* v = value("--ticks")) {
+            num_ticks = std::strtoull(v, nullptr, 10);
+        } else if (std::strcmp(arg, "--format=bin") == 0) {
+            binary = true;
+        } else if (std::strcmp(arg, "--format=csv") == 0) {
+            binary = false;
+        } else if (const char* v = value("--output")) {
+            output = v;
+        } else if (const char* v = value("--seed")) {
+            deterministic = true;
+            stream_config.seed = std::strtoull(v, nullptr, 0);
+        } else if (const char* v = value("--symbols")) {
+            stream_config.num_symbols = std::strtoull(v, nullptr, 10);
+        } else if (const char* v = value("--threads")) {
+            stream_config.threads = std::strtoul(v, nullptr, 10);
+        } else if (const char* v = value("--day-seconds")) {
+            stream_config.day_seconds = std::strtod(v, nullptr);
+        } else if (std::strcmp(arg, "--benchmark") == 0) {
+            benchmark = true;
         } else {
-            msg_type = 0x44; // Delete
+            printUsage(argv[0]);
+            return 1;
         }
-        
-        return {
-            sym.code,
-            static_cast<uint32_t>(sym.price * 1000000),
-            volume,
-            bid,
-            ask,
-            msg_type,
-            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::steady_clock::now().time_since_epoch()).count())
-        };
+    }
+    if (stream_config.num_symbols > MAX_SYNTHETIC_SYMBOLS) {
+        std::cerr << "--symbols: at most " << MAX_SYNTHETIC_SYMBOLS << " symbols have distinct codes" << std::endl;
+        return 1;
+    }
+    if (output.empty()) {
+        output = binary ? "market_data_sample.ticks" : "market_data_sample.csv";
     }
     
-    std::vector<MarketTick> generateBurst(size_t num_ticks) {
-        std::vector<MarketTick> ticks;
-        ticks.reserve(num_ticks);
-        
-        for (size_t i = 0; i < num_ticks; ++i) {
-            size_t symbol_idx = i % symbols.size();
-            ticks.push_back(generateTick(symbol_idx));
-        }
-        
-        return ticks;
+    std::cout << "=== Market Data Generator ===" << std::endl;
+    
+    MarketDataGenerator generator;
+    
+    if (benchmark) {
+        runBenchmark(generator, std::max<size_t>(num_ticks, 1));
+        return 0;
     }
     
-    void saveToFile(const std::vector<MarketTick>& ticks, const std::string& filename) {
-        std::ofstream file(filename);
-        
-        file << "timestamp,symbol_code,price,volume,bid,ask,msg_type" << std::endl;
+    if (deterministic) {
+        stream_config.total_ticks = num_ticks;
+        TickStreamGenerator streams(stream_config);
+        auto start = std::chrono::steady_clock::now();
         
-        for (const auto& tick : ticks) {
-            file << tick.timestamp << ","
-                 << "0x" << std::hex << tick.symbol_code << ","
-                 << std::dec << tick.price << ","
-                 << tick.volume << ","
-                 << tick.bid << ","
-                 << tick.ask << ","
-                 << "0x" << std::hex << static_cast<int>(tick.msg_type) << std::endl;
+        std::vector<MarketTick> ticks;
+        uint64_t generated;
+        if (binary) {
+            TickFileWriter writer(output, streams.symbolTable());
+            generated = streams.run([&](const MarketTick* chunk, size_t n) { writer.append(chunk, n); });
+            writer.close();
+        } else {
+            generated = streams.run([&](const MarketTick* chunk, size_t n) { ticks.insert(ticks.end(), chunk, chunk + n); });
+            generator.saveToFile(ticks, output);
         }
         
-        std::cout << "Saved " << ticks.size() << " market ticks to " << filename << std::endl;
-    }
-    
-    void printTick(const MarketTick& tick) {
-        std::cout << "Tick: Symbol=0x" << std::hex << tick.symbol_code
-                  << ", Price=" << std::dec << tick.price
-                  << ", Volume=" << tick.volume
-                  << ", Type=0x" << std::hex << static_cast<int>(tick.msg_type)
-                  << std::endl;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Generated " << generated << " ticks for " << stream_config.num_symbols <<
+                     " symbols (seed " << stream_config.seed << ") in " << std::fixed << std::setprecision(2) <<
+                     seconds << " s (" << std::setprecision(1) << generated / seconds / 1e6 << " M ticks/s)" << std::endl;
+        if (binary) std::cout << "Saved " << generated << " market ticks to " << output << std::endl;
+    } else if (binary) {
+        generator.generateToBinary(num_ticks, output);
+    } else {
+        // Generate sample data
+        auto ticks = generator.generateBurst(num_ticks);
+        generator.saveToFile(ticks, output);
+        
+        // Print first few ticks
+        std::cout << "\nFirst 10 ticks:" << std::endl;
+        for (size_t i = 0; i < std::min(10UL, ticks.size()); ++i) {
+            generator.printTick(ticks[i]);
+        }
+        return 0;
     }
-};
-
-// Standalone market data generator utility
-int main() {
-    MarketDataGenerator generator;
-    
-    std::cout << "=== Market Data Generator ===" << std::endl;
     
-    // Generate sample data
-    auto ticks = generator.generateBurst(10000);
-    generator.saveToFile(ticks, "market_data_sample.csv");
-    
-    // Print first few ticks
-    std::cout << "\nFirst 10 ticks:" << std::endl;
-    for (size_t i = 0; i < std::min(10UL, ticks.size()); ++i) {
-        generator.printTick(ticks[i]);
+    if (binary) {
+        TickFileReader reader(output);
+        std::cout << "\nFirst 10 ticks:" << std::endl;
+        for (size_t i = 0; i < std::min<size_t>(10, reader.ticks().size); ++i) {
+            generator.printTick(reader.ticks()[i]);
+        }
     }
     
     return 0;
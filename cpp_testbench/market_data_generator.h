@@ -0,0 +1,293 @@
+/*
+ * Market data generator shared by the standalone generator utility and the
+ * threaded Verilator testbench
+ *
+ * Features:
+ * - Realistic price movements
+ * - Volume profile simulation
+ * - Multiple message types
+ * - High-rate generation into caller buffers (generateInto)
+ */
+
+#ifndef MARKET_DATA_GENERATOR_H
+#define MARKET_DATA_GENERATOR_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tick_file.h"
+
+class MarketDataGenerator {
+private:
+    std::mt19937 gen;
+    std::normal_distribution<> price_change_dist;
+    std::exponential_distribution<> volume_dist;
+    std::uniform_real_distribution<> uniform_dist;
+    
+    struct Symbol {
+        std::string name;
+        uint32_t code;
+        double price;
+        double volatility;
+        uint32_t avg_volume;
+        uint32_t tick_size;
+    };
+    
+    std::vector<Symbol> symbols;
+    
+    // High-rate mode state (generateInto): structure of arrays, one lane per
+    // symbol, so each round's price update is a plain loop over contiguous
+    // doubles the compiler can vectorise
+    struct SymbolLanes {
+        std::vector<uint32_t> code;
+        std::vector<uint32_t> avg_volume;
+        std::vector<double> price;
+        std::vector<double> volatility;
+        std::vector<uint64_t> rng;          // splitmix64 state per lane
+        std::vector<double> step;           // this round's price change
+        std::vector<uint64_t> bits;         // this round's volume/type draw
+    } lanes;
+    double sim_time_us = 0.0;
+    double mean_gap_us = 0.1;               // 10M ticks/s simulated arrival rate
+    uint64_t arrival_rng = 0;
+    
+    static uint64_t splitmix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    
+    // Uniform in (0, 1) from the top 32 bits
+    static double unitFromBits(uint64_t bits) {
+        return ((bits >> 32) + 0.5) * (1.0 / 4294967296.0);
+    }
+    
+    void initializeLanes(uint64_t seed) {
+        size_t n = symbols.size();
+        lanes.code.resize(n);
+        lanes.avg_volume.resize(n);
+        lanes.price.resize(n);
+        lanes.volatility.resize(n);
+        lanes.rng.resize(n);
+        lanes.step.resize(n);
+        lanes.bits.resize(n);
+        for (size_t j = 0; j < n; ++j) {
+            lanes.code[j] = symbols[j].code;
+            lanes.avg_volume[j] = symbols[j].avg_volume;
+            lanes.price[j] = symbols[j].price;
+            lanes.volatility[j] = symbols[j].volatility;
+            lanes.rng[j] = seed + j * 0x632BE59BD9B4E019ull;
+        }
+        arrival_rng = seed ^ 0xD1B54A32D192ED03ull;
+        sim_time_us = 0.0;
+    }
+    
+    // Advance every symbol's price by one step
+    void stepLanes() {
+        size_t n = lanes.price.size();
+        for (size_t j = 0; j < n; ++j) {
+            uint64_t r = splitmix64(lanes.rng[j]);
+            // Irwin-Hall: four 16-bit uniforms give a unit-variance, zero-mean
+            // step without log/cos, so this loop stays branch- and call-free
+            double sum = static_cast<double>((r & 0xFFFF) + ((r >> 16) & 0xFFFF) +
+                                             ((r >> 32) & 0xFFFF) + (r >> 48));
+            lanes.step[j] = (sum * (1.0 / 65536.0) - 2.0) * 1.7320508075688772;
+            lanes.bits[j] = splitmix64(lanes.rng[j]);
+        }
+        for (size_t j = 0; j < n; ++j) {
+            double p = lanes.price[j] + lanes.step[j] * 0.01 * lanes.volatility[j];
+            lanes.price[j] = p < 1.0 ? 1.0 : p;
+        }
+    }
+    
+public:
+    MarketDataGenerator() : 
+        gen(std::random_device{}()),
+        price_change_dist(0.0, 0.01),
+        volume_dist(1.0),
+        uniform_dist(0.0, 1.0)
+    {
+        initializeSymbols();
+        initializeLanes(std::random_device{}());
+    }
+    
+    // Simulated arrival rate for generateInto() timestamps
+    void setArrivalRate(double ticks_per_second) {
+        mean_gap_us = 1e6 / ticks_per_second;
+    }
+    
+    // High-rate generation into a caller-provided buffer. Ticks cycle through
+    // the symbols like generateBurst(), but timestamps are simulated time from
+    // a Poisson arrival process instead of the wall clock, and there is no
+    // allocation per call. Returns n.
+    size_t generateInto(MarketTick* out, size_t n) {
+        size_t num_symbols = lanes.price.size();
+        size_t i = 0;
+        while (i < n) {
+            stepLanes();
+            size_t round = std::min(num_symbols, n - i);
+            for (size_t j = 0; j < round; ++j, ++i) {
+                sim_time_us -= std::log(unitFromBits(splitmix64(arrival_rng))) * mean_gap_us;
+                
+                double price = lanes.price[j];
+                double spread = price * 0.001;
+                uint64_t bits = lanes.bits[j];
+                uint32_t type_draw = static_cast<uint32_t>(bits & 0xFFFF) * 100 >> 16;
+                
+                MarketTick& tick = out[i];
+                tick.timestamp = static_cast<uint64_t>(sim_time_us);
+                tick.symbol_code = lanes.code[j];
+                tick.price = static_cast<uint32_t>(price * 1000000);
+                tick.volume = static_cast<uint32_t>(-std::log(unitFromBits(bits)) * lanes.avg_volume[j]);
+                tick.bid = static_cast<uint32_t>((price - spread / 2) * 1000000);
+                tick.ask = static_cast<uint32_t>((price + spread / 2) * 1000000);
+                tick.msg_type = type_draw < 70 ? 0x41 : type_draw < 85 ? 0x45 : type_draw < 95 ? 0x58 : 0x44;
+                std::memset(tick.reserved, 0, sizeof(tick.reserved));
+            }
+        }
+        return n;
+    }
+    
+    void initializeSymbols() {
+        symbols = {
+            {"AAPL", 0x41415054, 150.0, 0.02, 1000, 1},
+            {"GOOGL", 0x474f4f47, 2800.0, 0.025, 500, 1},
+            {"MSFT", 0x4d534654, 300.0, 0.02, 800, 1},
+            {"TSLA", 0x54534c41, 800.0, 0.04, 1200, 1},
+            {"NVDA", 0x4e564441, 500.0, 0.035, 900, 1}
+        };
+    }
+    
+    MarketTick generateTick(size_t symbol_idx) {
+        if (symbol_idx >= symbols.size()) {
+            symbol_idx = 0;
+        }
+        
+        Symbol& sym = symbols[symbol_idx];
+        
+        // Generate price change
+        double price_change = price_change_dist(gen) * sym.volatility;
+        sym.price += price_change;
+        
+        // Keep price positive
+        if (sym.price < 1.0) sym.price = 1.0;
+        
+        // Generate volume
+        uint32_t volume = static_cast<uint32_t>(
+            sym.avg_volume * volume_dist(gen)
+        );
+        
+        // Generate bid/ask spread
+        double spread = sym.price * 0.001; // 0.1% spread
+        uint32_t bid = static_cast<uint32_t>((sym.price - spread/2) * 1000000);
+        uint32_t ask = static_cast<uint32_t>((sym.price + spread/2) * 1000000);
+        
+        // Determine message type
+        uint8_t msg_type = 0x41; // Default to Add
+        double rand_val = uniform_dist(gen);
+        if (rand_val < 0.7) {
+            msg_type = 0x41; // Add Order
+        } else if (rand_val < 0.85) {
+            msg_type = 0x45; // Execute
+        } else if (rand_val < 0.95) {
+            msg_type = 0x58; // Cancel
+        } else {
+            msg_type = 0x44; // Delete
+        }
+        
+        MarketTick tick = {};
+        tick.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        tick.symbol_code = sym.code;
+        tick.price = static_cast<uint32_t>(sym.price * 1000000);
+        tick.volume = volume;
+        tick.bid = bid;
+        tick.ask = ask;
+        tick.msg_type = msg_type;
+        return tick;
+    }
+    
+    std::vector<MarketTick> generateBurst(size_t num_ticks) {
+        std::vector<MarketTick> ticks;
+        ticks.reserve(num_ticks);
+        
+        for (size_t i = 0; i < num_ticks; ++i) {
+            size_t symbol_idx = i % symbols.size();
+            ticks.push_back(generateTick(symbol_idx));
+        }
+        
+        return ticks;
+    }
+    
+    void saveToFile(const std::vector<MarketTick>& ticks, const std::string& filename) {
+        std::ofstream file(filename);
+        
+        file << "timestamp,symbol_code,price,volume,bid,ask,msg_type\n";
+        
+        // One formatted line per tick, no per-line flush
+        char line[128];
+        for (const auto& tick : ticks) {
+            int len = std::snprintf(line, sizeof(line), "%llu,0x%x,%u,%u,%u,%u,0x%x\n",
+                                    static_cast<unsigned long long>(tick.timestamp), tick.symbol_code,
+                                    tick.price, tick.volume, tick.bid, tick.ask, tick.msg_type);
+            file.write(line, len);
+        }
+        
+        std::cout << "Saved " << ticks.size() << " market ticks to " << filename << std::endl;
+    }
+    
+    std::vector<TickFileSymbol> symbolTable() const {
+        std::vector<TickFileSymbol> table;
+        for (const auto& sym : symbols) {
+            TickFileSymbol entry = {};
+            entry.code = sym.code;
+            std::strncpy(entry.name, sym.name.c_str(), sizeof(entry.name) - 1);
+            table.push_back(entry);
+        }
+        return table;
+    }
+    
+    // Binary tick file (see tick_file.h), readable in place via TickFileReader
+    void saveToBinary(const std::vector<MarketTick>& ticks, const std::string& filename) {
+        TickFileWriter writer(filename, symbolTable());
+        writer.append(ticks.data(), ticks.size());
+        writer.close();
+        
+        std::cout << "Saved " << ticks.size() << " market ticks to " << filename << std::endl;
+    }
+    
+    // Generate straight to disk through one reused buffer, without holding
+    // the whole set in memory
+    void generateToBinary(size_t num_ticks, const std::string& filename) {
+        TickFileWriter writer(filename, symbolTable());
+        std::vector<MarketTick> chunk(1 << 16);
+        for (size_t done = 0; done < num_ticks; ) {
+            size_t n = std::min(chunk.size(), num_ticks - done);
+            generateInto(chunk.data(), n);
+            writer.append(chunk.data(), n);
+            done += n;
+        }
+        writer.close();
+        
+        std::cout << "Saved " << num_ticks << " market ticks to " << filename << std::endl;
+    }
+    
+    void printTick(const MarketTick& tick) {
+        std::cout << "Tick: Symbol=0x" << std::hex << tick.symbol_code
+                  << ", Price=" << std::dec << tick.price
+                  << ", Volume=" << tick.volume
+                  << ", Type=0x" << std::hex << static_cast<int>(tick.msg_type)
+                  << std::endl;
+    }
+};
+
+#endif // MARKET_DATA_GENERATOR_H
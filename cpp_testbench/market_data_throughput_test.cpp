@@ -0,0 +1,206 @@
+/*
+ * Market data processor line-rate test
+ * Verilates market_data_processor on its own and drives a beat on every
+ * cycle: first single-beat messages (one message per cycle), then
+ * back-to-back multi-beat ITCH Add/Delete pairs. Checks that data_ready
+ * never drops, that packets_processed accounts for every message without
+ * parse errors, that one result leaves per message and that each result
+ * arrives exactly pipeline_depth cycles after the message's last beat.
+ *
+ * Usage: Vmarket_data_processor [messages]
+ * Exits non-zero on any violation.
+ */
+
+#include "verilated.h"
+#include "Vmarket_data_processor.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class MarketDataDriver {
+private:
+    std::unique_ptr<Vmarket_data_processor> dut;
+    uint64_t cycles = 0;
+
+    // Cycle on which each message's last beat was accepted, oldest first
+    std::deque<uint64_t> in_flight;
+
+public:
+    uint64_t stalls = 0;
+    uint64_t results = 0;
+    uint64_t ticks = 0;
+    uint64_t latency_mismatches = 0;
+    uint64_t unexpected_results = 0;
+
+    explicit MarketDataDriver(VerilatedContext* context) : dut(new Vmarket_data_processor(context)) {
+        dut->clk = 0;
+        dut->rst_n = 0;
+        dut->data_valid = 0;
+        dut->data_in = 0;
+        dut->data_type = 0;
+        dut->data_last = 1;
+        for (int i = 0; i < 4; ++i) tick();
+        dut->rst_n = 1;
+        tick();
+    }
+
+    ~MarketDataDriver() { dut->final(); }
+
+    // One clock; results on the outputs are matched to the oldest message
+    void tick() {
+        dut->clk = 1;
+        dut->eval();
+        dut->clk = 0;
+        dut->eval();
+        cycles++;
+
+        if (dut->book_update_valid || dut->tick_valid) {
+            results++;
+            ticks += dut->tick_valid;
+            if (in_flight.empty()) {
+                unexpected_results++;
+            } else {
+                if (cycles - in_flight.front() != dut->pipeline_depth) latency_mismatches++;
+                in_flight.pop_front();
+            }
+        }
+    }
+
+    // Presents one beat and clocks it in
+    void beat(uint64_t data, uint8_t type, bool last) {
+        if (!dut->data_ready) stalls++;
+        if (last) in_flight.push_back(cycles);     // cycle the last beat is on the bus
+        dut->data_in = data;
+        dut->data_type = type;
+        dut->data_last = last;
+        dut->data_valid = 1;
+        tick();
+    }
+
+    void idle(int n) {
+        dut->data_valid = 0;
+        dut->data_last = 1;
+        for (int i = 0; i < n; ++i) tick();
+    }
+
+    uint64_t cycleCount() const { return cycles; }
+    uint32_t packets() const { return dut->packets_processed; }
+    uint32_t errors() const { return dut->parse_errors; }
+    uint32_t depth() const { return dut->pipeline_depth; }
+    size_t pending() const { return in_flight.size(); }
+};
+
+// Raw ITCH 5.0 message as big-endian 64-bit beats
+static std::vector<uint64_t> itchBeats(const std::vector<uint8_t>& msg) {
+    std::vector<uint64_t> beats((msg.size() + 7) / 8, 0);
+    for (size_t i = 0; i < msg.size(); ++i) {
+        beats[i / 8] |= static_cast<uint64_t>(msg[i]) << (56 - 8 * (i % 8));
+    }
+    return beats;
+}
+
+static void put(std::vector<uint8_t>& msg, size_t offset, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) msg[offset + i] = static_cast<uint8_t>(value >> (8 * (bytes - 1 - i)));
+}
+
+static std::vector<uint64_t> addOrder(uint64_t ref, uint32_t price) {
+    std::vector<uint8_t> msg(36, ' ');
+    msg[0] = 'A';
+    put(msg, 1, 1, 2);                       // stock locate
+    put(msg, 3, 0, 2);                       // tracking number
+    put(msg, 5, 34200000000000ull, 6);       // 09:30:00
+    put(msg, 11, ref, 8);
+    msg[19] = 'B';
+    put(msg, 20, 100, 4);
+    put(msg, 24, 0x4141504c, 4);             // "AAPL"
+    put(msg, 32, price, 4);
+    return itchBeats(msg);
+}
+
+static std::vector<uint64_t> deleteOrder(uint64_t ref) {
+    std::vector<uint8_t> msg(19, 0);
+    msg[0] = 'D';
+    put(msg, 1, 1, 2);
+    put(msg, 5, 34200000000500ull, 6);
+    put(msg, 11, ref, 8);
+    return itchBeats(msg);
+}
+
+int main(int argc, char** argv) {
+    uint64_t messages = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    auto context = std::make_unique<VerilatedContext>();
+    MarketDataDriver driver(context.get());
+    bool ok = true;
+
+    auto report = [&](const char* phase, uint64_t sent, uint64_t beats, uint64_t cycles,
+                      uint32_t packets, uint32_t errors, double wall) {
+        bool pass = driver.stalls == 0 && packets == sent && errors == 0 && driver.pending() == 0 &&
+                    driver.latency_mismatches == 0 && driver.unexpected_results == 0;
+        std::printf("%-22s %10lu msgs %10lu beats %10lu cycles  %.3f msg/cycle  %.0f cycles/s  %s\n",
+                    phase, static_cast<unsigned long>(sent), static_cast<unsigned long>(beats),
+                    static_cast<unsigned long>(cycles), cycles ? static_cast<double>(sent) / cycles : 0.0,
+                    wall > 0 ? cycles / wall : 0.0, pass ? "PASS" : "FAIL");
+        if (!pass) {
+            std::printf("  stalls=%lu packets=%u errors=%u pending=%zu latency_mismatches=%lu unexpected=%lu\n",
+                        static_cast<unsigned long>(driver.stalls), packets, errors, driver.pending(),
+                        static_cast<unsigned long>(driver.latency_mismatches),
+                        static_cast<unsigned long>(driver.unexpected_results));
+        }
+        ok = ok && pass;
+    };
+
+    std::printf("market_data_processor line-rate test, pipeline depth %u\n", driver.depth());
+
+    // Phase 1: single-beat messages, one per cycle
+    {
+        uint32_t packets_before = driver.packets(), errors_before = driver.errors();
+        uint64_t cycles_before = driver.cycleCount();
+        auto start = std::chrono::steady_clock::now();
+        static const uint8_t types[] = {'A', 'E', 'X'};
+        for (uint64_t i = 0; i < messages; ++i) {
+            uint64_t data = (static_cast<uint64_t>(0x41415054u + (i & 0xFF)) << 32) | (0x96000000u + (i & 0xFFFF));
+            driver.beat(data, types[i % 3], true);
+        }
+        uint64_t streamed = driver.cycleCount() - cycles_before;
+        driver.idle(static_cast<int>(driver.depth()) + 2);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report("single-beat", messages, messages, streamed,
+               driver.packets() - packets_before, driver.errors() - errors_before, wall);
+    }
+
+    // Phase 2: ITCH Add (5 beats) + Delete (3 beats) pairs, no idle beats
+    {
+        uint32_t packets_before = driver.packets(), errors_before = driver.errors();
+        uint64_t cycles_before = driver.cycleCount();
+        uint64_t beats = 0, sent = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t ref = 1; sent < messages; ++ref) {
+            for (const auto& msg : {addOrder(ref, 1500000 + static_cast<uint32_t>(ref & 0xFF)), deleteOrder(ref)}) {
+                for (size_t b = 0; b < msg.size(); ++b) {
+                    driver.beat(msg[b], static_cast<uint8_t>(msg[0] >> 56), b + 1 == msg.size());
+                }
+                beats += msg.size();
+                sent++;
+            }
+        }
+        uint64_t streamed = driver.cycleCount() - cycles_before;
+        driver.idle(static_cast<int>(driver.depth()) + 2);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report("itch add/delete", sent, beats, streamed,
+               driver.packets() - packets_before, driver.errors() - errors_before, wall);
+        if (streamed != beats) {
+            std::printf("  %lu beats took %lu cycles\n", static_cast<unsigned long>(beats),
+                        static_cast<unsigned long>(streamed));
+            ok = false;
+        }
+    }
+
+    std::printf("%s\n", ok ? "Line-rate test PASSED" : "Line-rate test FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,275 @@
+/*
+ * Per-cycle signal sampling without waveform tracing
+ *
+ * Probes read one internal signal each (an FSM state, a FIFO level, a valid
+ * flag) from the model after every rising edge. Each probe keeps a cycle
+ * count per state, and every change of value is pushed through an SPSC ring
+ * to a background thread that appends it to a compact binary event log, so
+ * multi-million-cycle runs can be analysed for stalls where a VCD would be
+ * impossibly large. The simulation thread only reads the probes, bumps a
+ * counter and, on a change, pushes one 16-byte event.
+ *
+ * Log layout (little-endian):
+ *   SignalLogHeader                     64 bytes
+ *   SignalLogProbe[probe_count]         32 bytes each
+ *   SignalLogRecord[record_count]       8 bytes each
+ *
+ * The first record of every probe is its value on start_cycle. A record's
+ * cycle is the previous record's cycle (start_cycle for the first) plus
+ * cycle_delta; gaps of 2^32 cycles or more are bridged by records with
+ * probe == SIGNAL_LOG_GAP, which only advance the cycle. Values saturate
+ * at 0xFFFF in the log; the occupancy counters see the full value.
+ */
+
+#ifndef SIGNAL_SAMPLER_H
+#define SIGNAL_SAMPLER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+struct SignalLogHeader {
+    char magic[8];              // "VTSIGLG\0"
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;
+    uint64_t start_cycle;
+    uint32_t probe_count;
+    uint8_t reserved[28];
+};
+static_assert(sizeof(SignalLogHeader) == 64, "SignalLogHeader must stay 64 bytes");
+
+struct SignalLogProbe {
+    char name[24];              // NUL-padded
+    uint32_t states;            // occupancy buckets; larger values share the last
+    uint32_t reserved;
+};
+static_assert(sizeof(SignalLogProbe) == 32, "SignalLogProbe must stay 32 bytes");
+
+struct SignalLogRecord {
+    uint32_t cycle_delta;
+    uint16_t probe;
+    uint16_t value;
+};
+static_assert(sizeof(SignalLogRecord) == 8, "SignalLogRecord must stay a packed 8-byte record");
+
+static constexpr char SIGNAL_LOG_MAGIC[8] = {'V', 'T', 'S', 'I', 'G', 'L', 'G', '\0'};
+static constexpr uint32_t SIGNAL_LOG_VERSION = 1;
+static constexpr uint16_t SIGNAL_LOG_GAP = 0xFFFF;
+
+template <typename Model>
+class SignalSampler {
+public:
+    using Read = uint32_t (*)(const Model&);
+
+    // State names label the occupancy buckets; their count is the number of
+    // buckets
+    void addProbe(const std::string& name, std::vector<std::string> state_names, Read read) {
+        if (running) throw std::logic_error("Probes must be added before the sampler starts");
+        if (state_names.empty()) throw std::invalid_argument("Probe " + name + " needs at least one state");
+        if (name.size() >= sizeof(SignalLogProbe::name)) throw std::invalid_argument("Probe name too long: " + name);
+        Probe probe;
+        probe.name = name;
+        probe.state_names = std::move(state_names);
+        probe.occupancy.assign(probe.state_names.size(), 0);
+        probe.read = read;
+        probes.push_back(std::move(probe));
+    }
+
+    // Counting starts with the sample taken after cycle; an empty log_file
+    // keeps only the occupancy counters
+    void start(uint64_t cycle, const std::string& log_file, size_t ring_capacity = 1 << 16) {
+        next_cycle = cycle;
+        first_sample = true;
+        running = !probes.empty();
+        if (!running || log_file.empty()) return;
+
+        log_path = log_file;
+        file = std::fopen(log_file.c_str(), "wb");
+        if (!file) throw std::runtime_error("Cannot create signal log: " + log_file);
+
+        SignalLogHeader header = {};
+        std::memcpy(header.magic, SIGNAL_LOG_MAGIC, sizeof(header.magic));
+        header.version = SIGNAL_LOG_VERSION;
+        header.record_size = sizeof(SignalLogRecord);
+        header.start_cycle = cycle;
+        header.probe_count = static_cast<uint32_t>(probes.size());
+        std::vector<SignalLogProbe> table(probes.size());
+        for (size_t i = 0; i < probes.size(); ++i) {
+            std::memset(&table[i], 0, sizeof(table[i]));
+            std::memcpy(table[i].name, probes[i].name.data(), probes[i].name.size());
+            table[i].states = static_cast<uint32_t>(probes[i].state_names.size());
+        }
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+            std::fwrite(table.data(), sizeof(SignalLogProbe), table.size(), file) != table.size()) {
+            std::fclose(file);
+            file = nullptr;
+            throw std::runtime_error("Short write to signal log: " + log_file);
+        }
+
+        ring = std::make_unique<SpscRing<SignalEvent>>(ring_capacity);
+        writer = std::thread([this, cycle] { writeLoop(cycle); });
+    }
+
+    ~SignalSampler() {
+        try { stop(); } catch (...) {}
+    }
+
+    // True while sample() needs to be called; the hot path only tests this
+    bool active() const { return running; }
+
+    // Once per cycle, after the rising edge
+    void sample(const Model& model) {
+        for (size_t i = 0; i < probes.size(); ++i) {
+            Probe& probe = probes[i];
+            uint32_t value = probe.read(model);
+            probe.occupancy[std::min<size_t>(value, probe.occupancy.size() - 1)]++;
+            if ((value != probe.last || first_sample) && ring) {
+                SignalEvent event = {next_cycle, value, static_cast<uint32_t>(i)};
+                while (!ring->tryPush(event)) {
+                    ring_waits++;
+                    std::this_thread::yield();
+                }
+                events++;
+            }
+            probe.last = value;
+        }
+        first_sample = false;
+        next_cycle++;
+    }
+
+    // Flushes the log and patches its record count; counters stay readable
+    void stop() {
+        running = false;
+        if (!writer.joinable()) return;
+        ring->close();
+        writer.join();
+        ring.reset();
+
+        std::fseek(file, offsetof(SignalLogHeader, record_count), SEEK_SET);
+        std::fwrite(&records_written, sizeof(records_written), 1, file);
+        bool ok = !write_failed && std::fclose(file) == 0;
+        file = nullptr;
+        if (!ok) throw std::runtime_error("Short write to signal log: " + log_path);
+    }
+
+    // Cycles sampled so far; every probe's buckets add up to this
+    uint64_t cycles() const {
+        if (probes.empty()) return 0;
+        const auto& occupancy = probes.front().occupancy;
+        return std::accumulate(occupancy.begin(), occupancy.end(), uint64_t(0));
+    }
+
+    // Cycles and share of the sampled cycles spent in each state
+    void print(std::ostream& os) const {
+        if (probes.empty()) return;
+        uint64_t total = cycles();
+        os << "Signal occupancy over " << total << " cycles:" << std::endl;
+        for (const Probe& probe : probes) {
+            os << "  " << probe.name << ":";
+            for (size_t s = 0; s < probe.occupancy.size(); ++s) {
+                if (!probe.occupancy[s]) continue;
+                os << " " << probe.state_names[s] << " " << std::fixed << std::setprecision(1) <<
+                      (total ? 100.0 * probe.occupancy[s] / total : 0.0) << "%";
+            }
+            os << std::endl;
+        }
+        if (!log_path.empty()) {
+            os << "Signal log: " << records_written << " records in " << log_path;
+            if (ring_waits) os << " (" << ring_waits << " waits for the writer)";
+            os << std::endl;
+        }
+    }
+
+    // Visits (probe, state, cycles) for every bucket, for the JSON report
+    template <typename Fn>
+    void forEachState(Fn&& fn) const {
+        for (const Probe& probe : probes) {
+            for (size_t s = 0; s < probe.occupancy.size(); ++s) {
+                fn(probe.name, probe.state_names[s], probe.occupancy[s]);
+            }
+        }
+    }
+
+    size_t probeCount() const { return probes.size(); }
+    uint64_t eventCount() const { return events; }
+    uint64_t ringWaits() const { return ring_waits; }
+
+private:
+    struct Probe {
+        std::string name;
+        std::vector<std::string> state_names;
+        std::vector<uint64_t> occupancy;
+        Read read = nullptr;
+        uint32_t last = 0;
+    };
+
+    // One value change, as handed to the writer thread
+    struct SignalEvent {
+        uint64_t cycle;
+        uint32_t value;
+        uint32_t probe;
+    };
+
+    static constexpr size_t BATCH_EVENTS = 4096;
+
+    // Writer thread: drains the ring into delta-coded records, one fwrite
+    // per batch
+    void writeLoop(uint64_t last_cycle) {
+        std::vector<SignalEvent> batch(BATCH_EVENTS);
+        std::vector<SignalLogRecord> records;
+        records.reserve(BATCH_EVENTS * 2);
+        for (;;) {
+            size_t n = ring->pop(batch.data(), batch.size());
+            if (n == 0) {
+                if (ring->drained()) break;
+                std::this_thread::yield();
+                continue;
+            }
+            records.clear();
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t delta = batch[i].cycle - last_cycle;
+                while (delta > UINT32_MAX) {
+                    records.push_back({UINT32_MAX, SIGNAL_LOG_GAP, 0});
+                    delta -= UINT32_MAX;
+                }
+                records.push_back({static_cast<uint32_t>(delta), static_cast<uint16_t>(batch[i].probe),
+                                   static_cast<uint16_t>(std::min<uint32_t>(batch[i].value, 0xFFFF))});
+                last_cycle = batch[i].cycle;
+            }
+            if (!write_failed &&
+                std::fwrite(records.data(), sizeof(SignalLogRecord), records.size(), file) != records.size()) {
+                write_failed = true;
+            }
+            if (!write_failed) records_written += records.size();
+        }
+    }
+
+    std::vector<Probe> probes;
+    bool running = false;
+    bool first_sample = true;
+    uint64_t next_cycle = 0;
+    uint64_t events = 0;
+    uint64_t ring_waits = 0;
+
+    std::string log_path;
+    std::FILE* file = nullptr;
+    std::unique_ptr<SpscRing<SignalEvent>> ring;
+    std::thread writer;
+    uint64_t records_written = 0;       // owned by the writer until join()
+    bool write_failed = false;          // likewise
+};
+
+#endif // SIGNAL_SAMPLER_H
@@ -0,0 +1,105 @@
+/*
+ * Lock-free single-producer/single-consumer ring for the threaded testbench
+ *
+ * One thread pushes, one thread pops. The producer owns tail and the
+ * consumer owns head; each side keeps a cached copy of the other's index
+ * and only reloads it when the ring looks full (or empty), so in steady
+ * state a batch costs one acquire load and one release store per side.
+ * The two sides' state sits on separate cache lines so the indices do not
+ * false-share.
+ *
+ * close() marks the end of the stream: once the producer has closed the
+ * ring and the consumer has popped everything, drained() is true.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing copies elements as plain data");
+
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(size_t min_capacity) {
+        capacity = 2;
+        while (capacity < min_capacity) capacity <<= 1;
+        mask = capacity - 1;
+        slots.reset(new T[capacity]);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t size() const { return capacity; }
+
+    // Producer: push up to n items, returns how many fit
+    size_t push(const T* items, size_t n) {
+        size_t t = producer.tail.load(std::memory_order_relaxed);
+        if (capacity - (t - producer.cached_head) < n) {
+            producer.cached_head = consumer.head.load(std::memory_order_acquire);
+        }
+        n = std::min(n, capacity - (t - producer.cached_head));
+        for (size_t i = 0; i < n; ++i) {
+            slots[(t + i) & mask] = items[i];
+        }
+        if (n) producer.tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    bool tryPush(const T& item) { return push(&item, 1) == 1; }
+
+    // Producer: no more items will be pushed
+    void close() { closed_flag.store(true, std::memory_order_release); }
+
+    // Consumer: pop up to max items, returns how many were available
+    size_t pop(T* out, size_t max) {
+        size_t h = consumer.head.load(std::memory_order_relaxed);
+        if (consumer.cached_tail == h) {
+            consumer.cached_tail = producer.tail.load(std::memory_order_acquire);
+        }
+        size_t n = std::min(max, consumer.cached_tail - h);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = slots[(h + i) & mask];
+        }
+        if (n) consumer.head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    bool tryPop(T& item) { return pop(&item, 1) == 1; }
+
+    // Consumer: closed and nothing left. The flag is read before the tail so
+    // items pushed before close() are never missed.
+    bool drained() const {
+        if (!closed_flag.load(std::memory_order_acquire)) return false;
+        return producer.tail.load(std::memory_order_acquire) == consumer.head.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(CACHE_LINE) ProducerState {
+        std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+    };
+
+    struct alignas(CACHE_LINE) ConsumerState {
+        std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+    };
+
+    ProducerState producer;
+    ConsumerState consumer;
+    alignas(CACHE_LINE) std::atomic<bool> closed_flag{false};
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<T[]> slots;
+};
+
+#endif // SPSC_RING_H
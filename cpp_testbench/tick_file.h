@@ -0,0 +1,227 @@
+/*
+ * Binary tick file format shared by MarketDataGenerator, the Verilator
+ * testbench and run_simulation.py
+ *
+ * Layout (little-endian):
+ *   TickFileHeader                      64 bytes
+ *   TickFileSymbol[symbol_count]        16 bytes each
+ *   padding up to data_offset           records start 64-byte aligned
+ *   MarketTick[record_count]            32 bytes each, fixed size
+ *
+ * Records are fixed-size and naturally aligned, so a reader can mmap the
+ * file and use the records in place without parsing or copying.
+ */
+
+#ifndef TICK_FILE_H
+#define TICK_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MarketTick {
+    uint64_t timestamp;         // microseconds
+    uint32_t symbol_code;
+    uint32_t price;             // price * 1e6
+    uint32_t volume;
+    uint32_t bid;
+    uint32_t ask;
+    uint8_t msg_type;           // ITCH message type
+    uint8_t reserved[3];
+};
+static_assert(sizeof(MarketTick) == 32, "MarketTick must stay a packed 32-byte record");
+
+struct TickFileSymbol {
+    uint32_t code;
+    char name[12];              // NUL-padded
+};
+static_assert(sizeof(TickFileSymbol) == 16, "TickFileSymbol must stay 16 bytes");
+
+struct TickFileHeader {
+    char magic[8];              // "VTTICKS\0"
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;
+    uint64_t data_offset;       // byte offset of the first record
+    uint32_t symbol_count;
+    uint8_t reserved[28];
+};
+static_assert(sizeof(TickFileHeader) == 64, "TickFileHeader must stay 64 bytes");
+
+static constexpr char TICK_FILE_MAGIC[8] = {'V', 'T', 'T', 'I', 'C', 'K', 'S', '\0'};
+static constexpr uint32_t TICK_FILE_VERSION = 1;
+
+// Contiguous read-only view over ticks (C++17 has no std::span)
+struct TickSpan {
+    const MarketTick* data = nullptr;
+    size_t size = 0;
+
+    const MarketTick* begin() const { return data; }
+    const MarketTick* end() const { return data + size; }
+    const MarketTick& operator[](size_t i) const { return data[i]; }
+    bool empty() const { return size == 0; }
+};
+
+// Streams ticks to disk through one large buffer; the record count in the
+// header is patched on close()
+class TickFileWriter {
+private:
+    static constexpr size_t BUFFER_TICKS = 1 << 15;    // 1 MiB per write
+
+    std::FILE* file = nullptr;
+    std::string path;
+    std::vector<MarketTick> buffer;
+    uint64_t written = 0;
+
+    void flush() {
+        if (buffer.empty()) return;
+        if (std::fwrite(buffer.data(), sizeof(MarketTick), buffer.size(), file) != buffer.size()) {
+            throw std::runtime_error("Short write to tick file: " + path);
+        }
+        written += buffer.size();
+        buffer.clear();
+    }
+
+public:
+    TickFileWriter(const std::string& filename, const std::vector<TickFileSymbol>& symbols) : path(filename) {
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) throw std::runtime_error("Cannot create tick file: " + filename);
+        std::setvbuf(file, nullptr, _IONBF, 0);         // we already write in large blocks
+
+        TickFileHeader header = {};
+        std::memcpy(header.magic, TICK_FILE_MAGIC, sizeof(header.magic));
+        header.version = TICK_FILE_VERSION;
+        header.record_size = sizeof(MarketTick);
+        header.symbol_count = static_cast<uint32_t>(symbols.size());
+        uint64_t table_end = sizeof(TickFileHeader) + symbols.size() * sizeof(TickFileSymbol);
+        header.data_offset = (table_end + 63) & ~uint64_t(63);
+
+        std::vector<char> prefix(header.data_offset, 0);
+        std::memcpy(prefix.data(), &header, sizeof(header));
+        if (!symbols.empty()) {
+            std::memcpy(prefix.data() + sizeof(header), symbols.data(), symbols.size() * sizeof(TickFileSymbol));
+        }
+        if (std::fwrite(prefix.data(), 1, prefix.size(), file) != prefix.size()) {
+            throw std::runtime_error("Short write to tick file: " + path);
+        }
+        buffer.reserve(BUFFER_TICKS);
+    }
+
+    ~TickFileWriter() {
+        if (file) {
+            try { close(); } catch (...) {}
+        }
+    }
+
+    void append(const MarketTick& tick) {
+        buffer.push_back(tick);
+        if (buffer.size() == BUFFER_TICKS) flush();
+    }
+
+    // Large contiguous runs bypass the buffer
+    void append(const MarketTick* ticks, size_t n) {
+        if (n < BUFFER_TICKS) {
+            for (size_t i = 0; i < n; ++i) append(ticks[i]);
+            return;
+        }
+        flush();
+        if (std::fwrite(ticks, sizeof(MarketTick), n, file) != n) {
+            throw std::runtime_error("Short write to tick file: " + path);
+        }
+        written += n;
+    }
+
+    uint64_t count() const { return written + buffer.size(); }
+
+    void close() {
+        flush();
+        std::fseek(file, offsetof(TickFileHeader, record_count), SEEK_SET);
+        std::fwrite(&written, sizeof(written), 1, file);
+        int rc = std::fclose(file);
+        file = nullptr;
+        if (rc != 0) throw std::runtime_error("Failed to close tick file: " + path);
+    }
+};
+
+// Maps a tick file read-only; ticks() points straight into the mapping
+class TickFileReader {
+private:
+    int fd = -1;
+    void* mapping = MAP_FAILED;
+    size_t mapped_size = 0;
+    TickFileHeader header = {};
+    std::vector<TickFileSymbol> symbol_table;
+    TickSpan span;
+
+public:
+    explicit TickFileReader(const std::string& filename) {
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open tick file: " + filename);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TickFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Not a tick file: " + filename);
+        }
+        mapped_size = st.st_size;
+        mapping = ::mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot mmap tick file: " + filename);
+        }
+        ::madvise(mapping, mapped_size, MADV_SEQUENTIAL);
+
+        const char* base = static_cast<const char*>(mapping);
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, TICK_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != TICK_FILE_VERSION || header.record_size != sizeof(MarketTick) ||
+            header.data_offset < sizeof(TickFileHeader) + header.symbol_count * sizeof(TickFileSymbol) ||
+            header.data_offset + header.record_count * sizeof(MarketTick) > mapped_size) {
+            unmap();
+            throw std::runtime_error("Invalid or truncated tick file: " + filename);
+        }
+
+        symbol_table.resize(header.symbol_count);
+        if (header.symbol_count) {
+            std::memcpy(symbol_table.data(), base + sizeof(header), header.symbol_count * sizeof(TickFileSymbol));
+        }
+        span.data = reinterpret_cast<const MarketTick*>(base + header.data_offset);
+        span.size = header.record_count;
+    }
+
+    ~TickFileReader() { unmap(); }
+
+    TickFileReader(const TickFileReader&) = delete;
+    TickFileReader& operator=(const TickFileReader&) = delete;
+
+    void unmap() {
+        if (mapping != MAP_FAILED) ::munmap(mapping, mapped_size);
+        if (fd >= 0) ::close(fd);
+        mapping = MAP_FAILED;
+        fd = -1;
+    }
+
+    TickSpan ticks() const { return span; }
+    const std::vector<TickFileSymbol>& symbols() const { return symbol_table; }
+
+    // Cheap check used to pick between the binary and CSV readers
+    static bool isTickFile(const std::string& filename) {
+        char magic[sizeof(TICK_FILE_MAGIC)] = {};
+        std::FILE* f = std::fopen(filename.c_str(), "rb");
+        if (!f) return false;
+        size_t n = std::fread(magic, 1, sizeof(magic), f);
+        std::fclose(f);
+        return n == sizeof(magic) && std::memcmp(magic, TICK_FILE_MAGIC, sizeof(magic)) == 0;
+    }
+};
+
+#endif // TICK_FILE_H
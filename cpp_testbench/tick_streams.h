@@ -0,0 +1,277 @@
+/*
+ * Deterministic, parallel multi-stream tick generation
+ *
+ * Every symbol is an independent stream driven by a Philox4x32-10 counter
+ * RNG: the random numbers for tick k of stream s are a pure function of
+ * (seed, s, k), so streams can be generated on any number of threads and
+ * the output is bit-identical for a given seed. Timestamps are simulated
+ * time (exponential inter-arrival per symbol), never the wall clock.
+ *
+ * Generation runs in fixed simulated-time windows. Within a window each
+ * thread advances its streams to the window end, then the per-stream
+ * buffers are merged by (timestamp, stream) and handed to the sink, so
+ * memory stays bounded however long the day is.
+ */
+
+#ifndef TICK_STREAMS_H
+#define TICK_STREAMS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tick_file.h"
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+class Philox4x32 {
+public:
+    struct Block { uint32_t v[4]; };
+
+    static Block generate(Block ctr, uint64_t key) {
+        uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * ctr.v[0];
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * ctr.v[2];
+            ctr = {{static_cast<uint32_t>(p1 >> 32) ^ ctr.v[1] ^ k0, static_cast<uint32_t>(p1),
+                    static_cast<uint32_t>(p0 >> 32) ^ ctr.v[3] ^ k1, static_cast<uint32_t>(p0)}};
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        return ctr;
+    }
+
+    // Uniform in (0, 1), never exactly 0 so log() is safe
+    static double uniform(uint32_t x) {
+        return (x + 0.5) * (1.0 / 4294967296.0);
+    }
+};
+
+struct SymbolProfile {
+    std::string name;
+    uint32_t code;
+    double price;
+    double volatility;
+    uint32_t avg_volume;
+};
+
+// Synthetic symbols are "S" and three characters, all four packed into
+// the code: "S000".."S999", then "SA00".."SZZZ" (letter, two base-36
+// digits), so no two indices share a code
+static constexpr size_t MAX_SYNTHETIC_SYMBOLS = 1000 + 26 * 36 * 36;
+
+inline std::string syntheticSymbolName(size_t index) {
+    static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    char name[8];
+    if (index < 1000) {
+        std::snprintf(name, sizeof(name), "S%03zu", index);
+    } else {
+        size_t n = index - 1000;
+        name[0] = 'S';
+        name[1] = static_cast<char>('A' + n / (36 * 36));
+        name[2] = digits[n / 36 % 36];
+        name[3] = digits[n % 36];
+        name[4] = '\0';
+    }
+    return name;
+}
+
+// The five symbols MarketDataGenerator has always used, then synthetic
+// symbols whose parameters are derived from the seed
+inline std::vector<SymbolProfile> makeSymbolUniverse(size_t count, uint64_t seed) {
+    if (count > MAX_SYNTHETIC_SYMBOLS) {
+        throw std::invalid_argument("At most " + std::to_string(MAX_SYNTHETIC_SYMBOLS) +
+                                    " symbols have distinct codes, " + std::to_string(count) + " requested");
+    }
+    std::vector<SymbolProfile> universe = {
+        {"AAPL", 0x41415054, 150.0, 0.02, 1000},
+        {"GOOGL", 0x474f4f47, 2800.0, 0.025, 500},
+        {"MSFT", 0x4d534654, 300.0, 0.02, 800},
+        {"TSLA", 0x54534c41, 800.0, 0.04, 1200},
+        {"NVDA", 0x4e564441, 500.0, 0.035, 900}
+    };
+    universe.resize(std::min(count, universe.size()));
+
+    for (size_t i = universe.size(); i < count; ++i) {
+        std::string name = syntheticSymbolName(i);
+        uint32_t code = 0;
+        for (int c = 0; c < 4; ++c) code |= static_cast<uint32_t>(name[c]) << (24 - c * 8);
+
+        // Stream index ~0 is reserved for symbol parameters
+        auto r = Philox4x32::generate({{static_cast<uint32_t>(i), 0, 0xFFFFFFFFu, 0}}, seed);
+        universe.push_back({name, code,
+                            10.0 + 990.0 * Philox4x32::uniform(r.v[0]),
+                            0.01 + 0.04 * Philox4x32::uniform(r.v[1]),
+                            200 + r.v[2] % 1800});
+    }
+    return universe;
+}
+
+struct TickStreamConfig {
+    uint64_t seed = 1;
+    size_t num_symbols = 5;
+    uint64_t total_ticks = 10000000;
+    double day_seconds = 23400.0;           // 6.5 hour session
+    unsigned threads = 0;                   // 0 = hardware concurrency
+    uint64_t window_ticks = 1 << 22;        // approximate merged ticks per window
+};
+
+class TickStreamGenerator {
+private:
+    struct Stream {
+        SymbolProfile profile;
+        uint32_t index;
+        uint64_t quota;                     // ticks this stream emits
+        uint64_t emitted = 0;
+        double time_ns = 0.0;
+        double mean_gap_ns;
+        std::vector<MarketTick> window;
+    };
+
+    TickStreamConfig config;
+    uint64_t start_us;
+    std::vector<Stream> streams;
+    std::vector<std::vector<MarketTick>> scratch;
+
+    // All randomness for one tick comes from two Philox blocks at counter
+    // (k, stream, 0|1), so the result does not depend on scheduling
+    void advance(Stream& s, double window_end_ns) {
+        s.window.clear();
+        while (s.emitted < s.quota) {
+            uint32_t lo = static_cast<uint32_t>(s.emitted), hi = static_cast<uint32_t>(s.emitted >> 32);
+            auto a = Philox4x32::generate({{lo, hi, s.index, 0}}, config.seed);
+
+            double next_ns = s.time_ns - std::log(Philox4x32::uniform(a.v[0])) * s.mean_gap_ns;
+            if (next_ns >= window_end_ns) break;    // redrawn identically next window
+            auto b = Philox4x32::generate({{lo, hi, s.index, 1}}, config.seed);
+            s.time_ns = next_ns;
+            s.emitted++;
+
+            // Box-Muller normal for the price step, as MarketDataGenerator does
+            double normal = std::sqrt(-2.0 * std::log(Philox4x32::uniform(a.v[1]))) *
+                            std::cos(6.283185307179586 * Philox4x32::uniform(a.v[2]));
+            s.profile.price = std::max(1.0, s.profile.price + normal * 0.01 * s.profile.volatility);
+
+            double spread = s.profile.price * 0.001;
+            double type_draw = Philox4x32::uniform(b.v[1]);
+
+            MarketTick tick = {};
+            tick.timestamp = start_us + static_cast<uint64_t>(s.time_ns / 1000.0);
+            tick.symbol_code = s.profile.code;
+            tick.price = static_cast<uint32_t>(s.profile.price * 1000000);
+            tick.volume = static_cast<uint32_t>(-std::log(Philox4x32::uniform(b.v[0])) * s.profile.avg_volume);
+            tick.bid = static_cast<uint32_t>((s.profile.price - spread / 2) * 1000000);
+            tick.ask = static_cast<uint32_t>((s.profile.price + spread / 2) * 1000000);
+            tick.msg_type = type_draw < 0.7 ? 0x41 : type_draw < 0.85 ? 0x45 : type_draw < 0.95 ? 0x58 : 0x44;
+            s.window.push_back(tick);
+        }
+    }
+
+    // Pairwise merge tree over the stream buffers in index order. std::merge
+    // is stable, so equal timestamps keep stream order and the result is the
+    // same every run; each level's merges are independent and run in parallel.
+    void mergeWindow(std::vector<MarketTick>& out, unsigned threads) {
+        auto by_time = [](const MarketTick& x, const MarketTick& y) { return x.timestamp < y.timestamp; };
+        std::vector<std::vector<MarketTick>*> runs;
+        for (auto& s : streams) runs.push_back(&s.window);
+
+        while (runs.size() > 1) {
+            size_t pairs = runs.size() / 2;
+            if (scratch.size() < pairs) scratch.resize(pairs);
+
+            auto mergePair = [&](size_t p) {
+                auto& a = *runs[2 * p];
+                auto& b = *runs[2 * p + 1];
+                scratch[p].resize(a.size() + b.size());
+                std::merge(a.begin(), a.end(), b.begin(), b.end(), scratch[p].begin(), by_time);
+            };
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < std::min<size_t>(threads, pairs); ++t) {
+                pool.emplace_back([&, t] { for (size_t p = t; p < pairs; p += threads) mergePair(p); });
+            }
+            for (size_t p = 0; p < pairs; p += threads) mergePair(p);
+            for (auto& worker : pool) worker.join();
+
+            // Swap merged data back into the first run of each pair so the
+            // scratch buffers keep their capacity for the next level
+            std::vector<std::vector<MarketTick>*> next;
+            for (size_t p = 0; p < pairs; ++p) {
+                runs[2 * p]->swap(scratch[p]);
+                next.push_back(runs[2 * p]);
+            }
+            if (runs.size() % 2) next.push_back(runs.back());
+            runs.swap(next);
+        }
+        out.swap(*runs.front());
+    }
+
+public:
+    explicit TickStreamGenerator(const TickStreamConfig& cfg, uint64_t start_timestamp_us = 0) :
+        config(cfg), start_us(start_timestamp_us)
+    {
+        auto universe = makeSymbolUniverse(config.num_symbols, config.seed);
+        double day_ns = config.day_seconds * 1e9;
+        for (size_t i = 0; i < universe.size(); ++i) {
+            uint64_t quota = config.total_ticks / universe.size() + (i < config.total_ticks % universe.size());
+            Stream s;
+            s.profile = universe[i];
+            s.index = static_cast<uint32_t>(i);
+            s.quota = quota;
+            s.mean_gap_ns = quota ? day_ns / quota : day_ns;
+            streams.push_back(std::move(s));
+        }
+    }
+
+    std::vector<TickFileSymbol> symbolTable() const {
+        std::vector<TickFileSymbol> table;
+        for (const auto& s : streams) {
+            TickFileSymbol entry = {};
+            entry.code = s.profile.code;
+            std::snprintf(entry.name, sizeof(entry.name), "%s", s.profile.name.c_str());
+            table.push_back(entry);
+        }
+        return table;
+    }
+
+    // Calls sink(const MarketTick*, size_t) with consecutive, time-ordered chunks
+    template <typename Sink>
+    uint64_t run(Sink&& sink) {
+        if (streams.empty()) return 0;
+        unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min<unsigned>(threads, std::max<size_t>(1, streams.size()));
+
+        // Window length depends only on the configuration, never on threads
+        double day_ns = config.day_seconds * 1e9;
+        double window_ns = config.total_ticks ?
+            day_ns * std::min(1.0, static_cast<double>(config.window_ticks) / config.total_ticks) : day_ns;
+
+        std::vector<MarketTick> merged;
+        uint64_t total = 0;
+        for (double end_ns = window_ns; ; end_ns += window_ns) {
+            bool last = std::all_of(streams.begin(), streams.end(),
+                                    [](const Stream& s) { return s.emitted == s.quota; });
+            if (last) break;
+            // Past the nominal day every remaining tick goes into this window
+            double limit = end_ns >= day_ns ? INFINITY : end_ns;
+
+            std::vector<std::thread> pool;
+            for (unsigned t = 0; t < threads; ++t) {
+                pool.emplace_back([this, t, threads, limit] {
+                    for (size_t i = t; i < streams.size(); i += threads) advance(streams[i], limit);
+                });
+            }
+            for (auto& worker : pool) worker.join();
+
+            mergeWindow(merged, threads);
+            if (!merged.empty()) sink(merged.data(), merged.size());
+            total += merged.size();
+        }
+        return total;
+    }
+};
+
+#endif // TICK_STREAMS_H
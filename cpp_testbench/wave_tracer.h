@@ -0,0 +1,181 @@
+/*
+ * Waveform tracing control for the Verilator C++ testbenches
+ *
+ * Modes:
+ * - Off:     no trace file is opened and dump() is never reached
+ * - Full:    every cycle is dumped to one file (the original behaviour)
+ * - Trigger: the trace rolls over two segment files of pre_cycles each, so
+ *            at least pre_cycles of history are on disk when a trigger fires;
+ *            tracing then runs for post_cycles more and the two segments are
+ *            kept as <base>.trigN.pre/.post
+ *
+ * The file format follows the Verilator build: FST when the model was
+ * Verilated with --trace-fst, VCD with --trace.
+ */
+
+#ifndef WAVE_TRACER_H
+#define WAVE_TRACER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "verilated.h"
+
+#if VM_TRACE_FST
+#include "verilated_fst_c.h"
+using TraceFile = VerilatedFstC;
+#define WAVE_TRACE_EXT ".fst"
+#elif VM_TRACE
+#include "verilated_vcd_c.h"
+using TraceFile = VerilatedVcdC;
+#define WAVE_TRACE_EXT ".vcd"
+#endif
+
+enum class TraceMode { Off, Full, Trigger };
+
+struct TraceConfig {
+    TraceMode mode = TraceMode::Off;
+    std::string base_name = "fpga_trading_system_cpp";
+    uint64_t pre_cycles = 1000;
+    uint64_t post_cycles = 1000;
+    uint32_t max_triggers = 1;
+    int depth = 99;
+};
+
+template <typename Model>
+class WaveTracer {
+private:
+    TraceConfig config;
+    Model* model = nullptr;
+#if VM_TRACE
+    std::unique_ptr<TraceFile> trace;
+#endif
+
+    bool dumping = false;        // a file is open and receiving dumps
+    bool triggered = false;      // trigger fired, counting down post_cycles
+    uint64_t segment_start = 0;
+    uint64_t trigger_cycle = 0;
+    uint32_t segment = 0;        // 0/1, current rolling segment
+    bool have_previous = false;  // the other segment holds a complete window
+    uint32_t triggers = 0;
+
+    std::string segmentName(uint32_t seg) const {
+        return config.base_name + ".seg" + std::to_string(seg) + extension();
+    }
+
+    void openFile(const std::string& name) {
+#if VM_TRACE
+        trace->open(name.c_str());
+        dumping = true;
+#else
+        (void)name;
+#endif
+    }
+
+    void closeFile() {
+#if VM_TRACE
+        if (dumping) trace->close();
+#endif
+        dumping = false;
+    }
+
+    // Keep the previous and current segments for this trigger
+    void finishTrigger(uint64_t cycle) {
+        closeFile();
+        std::string stem = config.base_name + ".trig" + std::to_string(triggers);
+        if (have_previous) {
+            std::rename(segmentName(segment ^ 1).c_str(), (stem + ".pre" + extension()).c_str());
+        }
+        std::rename(segmentName(segment).c_str(), (stem + ".post" + extension()).c_str());
+        std::cout << "Trace window for trigger at cycle " << trigger_cycle
+                  << " saved to " << stem << ".{pre,post}" << extension() << std::endl;
+
+        triggered = false;
+        triggers++;
+        if (triggers < config.max_triggers) {
+            segment = 0;
+            have_previous = false;
+            segment_start = cycle;
+            openFile(segmentName(segment));
+        }
+    }
+
+public:
+    static const char* extension() {
+#if VM_TRACE
+        return WAVE_TRACE_EXT;
+#else
+        return "";
+#endif
+    }
+
+    void start(Model* dut, const TraceConfig& cfg, uint64_t cycle) {
+        config = cfg;
+        model = dut;
+        if (config.mode == TraceMode::Off) return;
+
+#if VM_TRACE
+        Verilated::traceEverOn(true);
+        trace = std::make_unique<TraceFile>();
+        model->trace(trace.get(), config.depth);
+        segment_start = cycle;
+        openFile(config.mode == TraceMode::Full ? config.base_name + extension() : segmentName(0));
+#else
+        (void)cycle;
+        std::cerr << "Tracing requested but the model was built without --trace" << std::endl;
+        config.mode = TraceMode::Off;
+#endif
+    }
+
+    ~WaveTracer() { closeFile(); }
+
+    // True while dump() needs to be called; the hot path only tests this
+    bool active() const { return dumping; }
+
+    void dump(uint64_t time) {
+#if VM_TRACE
+        trace->dump(time);
+#else
+        (void)time;
+#endif
+    }
+
+    // Called once per cycle while active(): rolls segments and ends windows
+    void endCycle(uint64_t cycle) {
+        if (config.mode != TraceMode::Trigger) return;
+
+        if (triggered) {
+            if (cycle - trigger_cycle >= config.post_cycles) finishTrigger(cycle);
+        } else if (cycle - segment_start >= config.pre_cycles) {
+            closeFile();
+            segment ^= 1;
+            have_previous = true;
+            segment_start = cycle;
+            openFile(segmentName(segment));
+        }
+    }
+
+    // Request a capture window around this cycle (latency outlier, risk violation...)
+    void trigger(uint64_t cycle, const char* reason) {
+        if (config.mode != TraceMode::Trigger || triggered || !dumping) return;
+        triggered = true;
+        trigger_cycle = cycle;
+        std::cout << "Trace trigger at cycle " << cycle << ": " << reason << std::endl;
+    }
+
+    const char* modeName() const {
+        switch (config.mode) {
+            case TraceMode::Full:    return "full";
+            case TraceMode::Trigger: return "triggered windows";
+            default:                 return "off";
+        }
+    }
+
+    TraceMode mode() const { return config.mode; }
+    std::string fileName() const { return config.base_name + extension(); }
+};
+
+#endif // WAVE_TRACER_H
@@ -0,0 +1,268 @@
+/*
+ * Wide market data ingest benchmark
+ * Verilates market_data_processor_wide on its own and feeds it ticks from
+ * the binary tick format (tick_file.h), or a generated multi-symbol day
+ * when no file is given. Each tick becomes an ITCH 5.0 message: Add for
+ * 'A' ticks, Execute/Cancel/Delete against the symbol's newest resting
+ * order otherwise. Messages are packed into MoldUDP64-sized packets of
+ * [length:2][message] blocks and driven as AXI-Stream beats with tkeep.
+ *
+ * Reports messages per cycle, payload bytes per cycle and the line rate
+ * that corresponds to at 250 MHz, and fails when a message is lost, a
+ * parse error occurs or the lane outputs do not account for every message.
+ *
+ * Usage: Vmarket_data_processor_wide [tick_file | tick_count] [packet_bytes]
+ * WIDE_DATA_WIDTH / WIDE_LANES / WIDE_MAX_ORDERS must match the -G
+ * parameters of the build.
+ */
+
+#include "verilated.h"
+#include "Vmarket_data_processor_wide.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "tick_file.h"
+#include "tick_streams.h"
+
+#ifndef WIDE_DATA_WIDTH
+#define WIDE_DATA_WIDTH 512
+#endif
+#ifndef WIDE_LANES
+#define WIDE_LANES 4
+#endif
+#ifndef WIDE_MAX_ORDERS
+#define WIDE_MAX_ORDERS 1024
+#endif
+
+static constexpr size_t BEAT_BYTES = WIDE_DATA_WIDTH / 8;
+static constexpr double CLOCK_HZ = 250e6;
+
+// Ticks -> ITCH 5.0 message blocks. Resting orders are tracked per symbol
+// and the DUT's direct-mapped order table is mirrored, so Execute/Cancel/
+// Delete only ever reference an order the DUT still holds.
+class ItchEncoder {
+private:
+    std::unordered_map<uint32_t, std::deque<uint64_t>> resting;
+    std::vector<uint64_t> table_owner = std::vector<uint64_t>(WIDE_MAX_ORDERS, 0);
+    uint64_t next_ref = 1;
+
+    bool live(uint64_t ref) const { return table_owner[ref % WIDE_MAX_ORDERS] == ref; }
+
+    static void put(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * (bytes - 1 - i))));
+    }
+
+    static void header(std::vector<uint8_t>& out, char type, size_t length, uint64_t time_ns, uint64_t ref) {
+        put(out, length, 2);
+        out.push_back(static_cast<uint8_t>(type));
+        put(out, 1, 2);                         // stock locate
+        put(out, 0, 2);                         // tracking number
+        put(out, time_ns, 6);
+        put(out, ref, 8);
+    }
+
+public:
+    uint64_t messages = 0;
+
+    // Appends one [length:2][message] block for the tick
+    void encode(const MarketTick& tick, std::vector<uint8_t>& out) {
+        uint64_t time_ns = (tick.timestamp * 1000) % 86400000000000ull;
+        uint32_t price = tick.price / 100;      // 1e-6 -> ITCH 1e-4
+        uint32_t shares = tick.volume ? tick.volume : 1;
+        auto& orders = resting[tick.symbol_code];
+        while (!orders.empty() && !live(orders.back())) orders.pop_back();
+        messages++;
+
+        if (tick.msg_type == 0x41 || orders.empty()) {
+            uint64_t ref = next_ref++;
+            header(out, 'A', 36, time_ns, ref);
+            out.push_back((ref & 1) ? 'S' : 'B');
+            put(out, shares, 4);
+            put(out, tick.symbol_code, 4);
+            put(out, 0x20202020, 4);            // stock padded to 8 characters
+            put(out, price, 4);
+            orders.push_back(ref);
+            table_owner[ref % WIDE_MAX_ORDERS] = ref;
+            return;
+        }
+
+        uint64_t ref = orders.back();
+        switch (tick.msg_type) {
+            case 0x45:                          // Execute
+                header(out, 'E', 31, time_ns, ref);
+                put(out, shares, 4);
+                put(out, messages, 8);          // match number
+                break;
+            case 0x58:                          // Cancel
+                header(out, 'X', 23, time_ns, ref);
+                put(out, shares, 4);
+                break;
+            default:                            // Delete
+                header(out, 'D', 19, time_ns, ref);
+                orders.pop_back();
+                table_owner[ref % WIDE_MAX_ORDERS] = 0;
+                break;
+        }
+    }
+};
+
+class WideIngestDriver {
+private:
+    std::unique_ptr<Vmarket_data_processor_wide> dut;
+    uint64_t cycles = 0;
+
+public:
+    uint64_t lane_outputs = 0;
+    uint64_t lane_ticks = 0;
+    uint64_t stalls = 0;
+    uint64_t busiest_cycle = 0;
+
+    explicit WideIngestDriver(VerilatedContext* context) : dut(new Vmarket_data_processor_wide(context)) {
+        static_assert(sizeof(dut->s_axis_tdata) * 8 == WIDE_DATA_WIDTH,
+                      "WIDE_DATA_WIDTH does not match the verilated DATA_WIDTH");
+        dut->clk = 0;
+        dut->rst_n = 0;
+        dut->s_axis_tvalid = 0;
+        dut->s_axis_tkeep = 0;
+        dut->s_axis_tlast = 0;
+        for (int i = 0; i < 4; ++i) tick();
+        dut->rst_n = 1;
+        tick();
+    }
+
+    ~WideIngestDriver() { dut->final(); }
+
+    void tick() {
+        dut->clk = 1;
+        dut->eval();
+        dut->clk = 0;
+        dut->eval();
+        cycles++;
+
+        uint64_t lanes = __builtin_popcountll(dut->lane_valid);
+        lane_outputs += lanes;
+        lane_ticks += __builtin_popcountll(dut->lane_tick);
+        if (lanes > busiest_cycle) busiest_cycle = lanes;
+    }
+
+    // Presents one beat until the DUT takes it; byte 0 in tdata[7:0]
+    void beat(const uint8_t* data, size_t bytes, bool last) {
+        for (size_t w = 0; w < BEAT_BYTES / 4; ++w) {
+            uint32_t word = 0;
+            for (size_t b = 0; b < 4; ++b) {
+                size_t pos = w * 4 + b;
+                if (pos < bytes) word |= static_cast<uint32_t>(data[pos]) << (8 * b);
+            }
+            dut->s_axis_tdata[w] = word;
+        }
+        dut->s_axis_tkeep = bytes >= 64 ? ~0ull : ((1ull << bytes) - 1);
+        dut->s_axis_tlast = last;
+        dut->s_axis_tvalid = 1;
+        dut->eval();
+        while (!dut->s_axis_tready) {
+            stalls++;
+            tick();
+        }
+        tick();
+        dut->s_axis_tvalid = 0;
+    }
+
+    void idle(int n) {
+        dut->s_axis_tvalid = 0;
+        for (int i = 0; i < n; ++i) tick();
+    }
+
+    uint64_t cycleCount() const { return cycles; }
+    uint32_t packets() const { return dut->packets_processed; }
+    uint32_t errors() const { return dut->parse_errors; }
+    uint64_t bytes() const { return dut->bytes_received; }
+    uint32_t depth() const { return dut->pipeline_depth; }
+};
+
+int main(int argc, char** argv) {
+    std::string source = (argc > 1) ? argv[1] : "200000";
+    size_t packet_bytes = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1400;
+
+    try {
+        // Ticks from a file, or a reproducible generated day
+        std::vector<MarketTick> ticks;
+        if (TickFileReader::isTickFile(source)) {
+            TickFileReader reader(source);
+            ticks.assign(reader.ticks().begin(), reader.ticks().end());
+        } else {
+            TickStreamConfig config;
+            config.total_ticks = std::strtoull(source.c_str(), nullptr, 10);
+            config.num_symbols = 100;
+            TickStreamGenerator generator(config);
+            generator.run([&](const MarketTick* chunk, size_t n) { ticks.insert(ticks.end(), chunk, chunk + n); });
+        }
+        if (ticks.empty()) throw std::runtime_error("No ticks to replay: " + source);
+
+        // Packets of whole message blocks, at most packet_bytes each
+        ItchEncoder encoder;
+        std::vector<std::vector<uint8_t>> packets(1);
+        std::vector<uint8_t> block;
+        for (const auto& tick : ticks) {
+            block.clear();
+            encoder.encode(tick, block);
+            if (!packets.back().empty() && packets.back().size() + block.size() > packet_bytes) packets.emplace_back();
+            packets.back().insert(packets.back().end(), block.begin(), block.end());
+        }
+
+        auto context = std::make_unique<VerilatedContext>();
+        WideIngestDriver driver(context.get());
+
+        uint64_t payload = 0, beats = 0;
+        uint64_t cycles_before = driver.cycleCount();
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& packet : packets) {
+            for (size_t pos = 0; pos < packet.size(); pos += BEAT_BYTES) {
+                size_t n = std::min(BEAT_BYTES, packet.size() - pos);
+                driver.beat(packet.data() + pos, n, pos + n == packet.size());
+                beats++;
+            }
+            payload += packet.size();
+        }
+        uint64_t streamed = driver.cycleCount() - cycles_before;
+        driver.idle(static_cast<int>(driver.depth()) + 4);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double msgs_per_cycle = static_cast<double>(encoder.messages) / streamed;
+        double bytes_per_cycle = static_cast<double>(payload) / streamed;
+        std::printf("market_data_processor_wide: %d-bit, %d lanes, %zu-byte packets\n",
+                    WIDE_DATA_WIDTH, WIDE_LANES, packet_bytes);
+        std::printf("Messages:            %lu in %zu packets, %lu beats, %lu cycles\n",
+                    static_cast<unsigned long>(encoder.messages), packets.size(),
+                    static_cast<unsigned long>(beats), static_cast<unsigned long>(streamed));
+        std::printf("Messages per cycle:  %.3f (busiest cycle %lu)\n", msgs_per_cycle,
+                    static_cast<unsigned long>(driver.busiest_cycle));
+        std::printf("Payload bytes/cycle: %.2f = %.1f Gb/s at 250 MHz\n", bytes_per_cycle,
+                    bytes_per_cycle * 8 * CLOCK_HZ / 1e9);
+        std::printf("Stall cycles:        %lu\n", static_cast<unsigned long>(driver.stalls));
+        std::printf("Simulation speed:    %.0f cycles/s, %.0f messages/s\n",
+                    wall > 0 ? streamed / wall : 0.0, wall > 0 ? encoder.messages / wall : 0.0);
+
+        bool ok = driver.packets() == encoder.messages && driver.errors() == 0 &&
+                  driver.lane_outputs == encoder.messages && driver.bytes() == payload;
+        if (!ok) {
+            std::printf("packets_processed=%u parse_errors=%u lane_outputs=%lu bytes_received=%lu (expected %lu/%lu)\n",
+                        driver.packets(), driver.errors(), static_cast<unsigned long>(driver.lane_outputs),
+                        static_cast<unsigned long>(driver.bytes()), static_cast<unsigned long>(encoder.messages),
+                        static_cast<unsigned long>(payload));
+        }
+        std::printf("%s\n", ok ? "Wide ingest benchmark PASSED" : "Wide ingest benchmark FAILED");
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+}
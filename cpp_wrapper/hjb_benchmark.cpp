@@ -0,0 +1,175 @@
+/*
+ * HJB wrapper benchmark
+ * Compares quotes/second through the scalar hjb_calculate() path against
+ * hjb_calculate_batch() and the pipelined streaming core on the same
+ * inputs, times the native C++ model and cross-checks it against the RTL
+ * and every scalar call, streams the fixed-point core and bounds its error
+ * against the double-precision Avellaneda-Stoikov quotes, then scales the
+ * engine pool from one worker up to the number of cores
+ */
+
+#include "hjb_wrapper.h"
+#include "hjb_model.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Parameters the fixed-point core is checked with, and the largest quote
+// error against double precision it may show (price units)
+static constexpr double HJB_GAMMA = 0.1;
+static constexpr double HJB_KAPPA = 1.5;
+static constexpr double FIXED_TOLERANCE = 1e-4;
+
+int main(int argc, char** argv) {
+    size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100000;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> mid_dist(90000.0, 110000.0);
+    std::uniform_int_distribution<> inv_dist(-100, 100);
+    std::uniform_real_distribution<> vol_dist(0.1, 0.5);
+
+    std::vector<double> mid(n), vol(n);
+    std::vector<int32_t> inv(n);
+    for (size_t i = 0; i < n; i++) {
+        mid[i] = mid_dist(gen);
+        inv[i] = inv_dist(gen);
+        vol[i] = vol_dist(gen);
+    }
+
+    std::vector<HJBResult> scalar_out(n), batch_out(n);
+
+    hjb_init();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        hjb_calculate(mid[i], inv[i], vol[i], &scalar_out[i]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double scalar_s = std::chrono::duration<double>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    size_t done = hjb_calculate_batch(mid.data(), inv.data(), vol.data(), n, batch_out.data());
+    end = std::chrono::high_resolution_clock::now();
+    double batch_s = std::chrono::duration<double>(end - start).count();
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < done; i++) {
+        if (scalar_out[i].bid != batch_out[i].bid || scalar_out[i].ask != batch_out[i].ask) {
+            mismatches++;
+        }
+    }
+
+    hjb_cleanup();
+
+    // Pipelined core, one request per clock
+    std::vector<HJBResult> stream_out(n);
+    HJBStreamEngine* stream = hjb_stream_create();
+    start = std::chrono::high_resolution_clock::now();
+    size_t stream_done = hjb_stream_calculate_batch(stream, mid.data(), inv.data(), vol.data(),
+                                                    n, stream_out.data());
+    end = std::chrono::high_resolution_clock::now();
+    double stream_s = std::chrono::duration<double>(end - start).count();
+    hjb_stream_destroy(stream);
+
+    for (size_t i = 0; i < stream_done; i++) {
+        if (scalar_out[i].bid != stream_out[i].bid || scalar_out[i].ask != stream_out[i].ask) {
+            mismatches++;
+        }
+    }
+    if (stream_done != n) done = stream_done;
+
+    // Native C++ model and bit-exact check against the RTL
+    std::vector<HJBResult> native_out(n);
+    start = std::chrono::high_resolution_clock::now();
+    hjb_calculate_native_batch(mid.data(), inv.data(), vol.data(), n, native_out.data());
+    end = std::chrono::high_resolution_clock::now();
+    double native_s = std::chrono::duration<double>(end - start).count();
+
+    // Every scalar call must return its own quote. hjb_calculate() once left
+    // the FSM in DONE, so every other call read back the previous result;
+    // the batch path shares that handshake, so only the model can catch it.
+    size_t scalar_mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (scalar_out[i].bid != native_out[i].bid || scalar_out[i].ask != native_out[i].ask) {
+            scalar_mismatches++;
+        }
+    }
+    mismatches += scalar_mismatches;
+
+    std::vector<HJBResult> check_out(n);
+    HJBEngine* engine = hjb_create();
+    size_t crosscheck_timeouts = 0;
+    size_t crosscheck_mismatches = hjb_crosscheck_batch(engine, mid.data(), inv.data(), vol.data(),
+                                                        n, check_out.data(), &crosscheck_timeouts);
+    hjb_destroy(engine);
+    mismatches += crosscheck_mismatches;
+    if (crosscheck_timeouts) done = n - crosscheck_timeouts;
+
+    // Fixed-point core against the double-precision model
+    std::vector<HJBResult> fixed_out(n);
+    HJBFixedEngine* fixed = hjb_fixed_create(HJB_GAMMA, HJB_KAPPA);
+    start = std::chrono::high_resolution_clock::now();
+    size_t fixed_done = hjb_fixed_calculate_batch(fixed, mid.data(), inv.data(), vol.data(),
+                                                  n, fixed_out.data());
+    end = std::chrono::high_resolution_clock::now();
+    double fixed_s = std::chrono::duration<double>(end - start).count();
+    hjb_fixed_destroy(fixed);
+
+    double fixed_error = 0.0;
+    for (size_t i = 0; i < fixed_done; i++) {
+        double bid, ask;
+        HJBModel::avellanedaStoikov(mid[i], inv[i], vol[i], HJB_GAMMA, HJB_KAPPA, bid, ask);
+        fixed_error = std::max({fixed_error, std::fabs(fixed_out[i].bid - bid), std::fabs(fixed_out[i].ask - ask)});
+    }
+    if (fixed_error > FIXED_TOLERANCE) mismatches++;
+    if (fixed_done != n) done = fixed_done;
+
+    std::printf("=== HJB Wrapper Benchmark (%zu quotes) ===\n", n);
+    std::printf("Scalar hjb_calculate:       %12.0f calls/s\n", n / scalar_s);
+    std::printf("Batch  hjb_calculate_batch: %12.0f quotes/s\n", done / batch_s);
+    std::printf("Speedup: %.2fx\n", scalar_s / batch_s * done / n);
+    std::printf("Stream pipelined core:      %12.0f quotes/s\n", stream_done / stream_s);
+    std::printf("Native %-7s model:        %12.0f quotes/s\n", HJBModel().isaName(), n / native_s);
+    std::printf("Scalar vs native mismatches:%12zu\n", scalar_mismatches);
+    std::printf("Native vs RTL mismatches:   %12zu\n", crosscheck_mismatches);
+    std::printf("Native vs RTL timeouts:     %12zu\n", crosscheck_timeouts);
+    std::printf("Fixed-point Q32.32 core:    %12.0f quotes/s\n", fixed_done / fixed_s);
+    std::printf("Fixed vs double max error:  %12.3g\n", fixed_error);
+
+    // Engine pool scaling
+    std::vector<HJBResult> pool_out(n);
+    unsigned max_workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> worker_counts;
+    for (unsigned w = 1; w < max_workers; w *= 2) worker_counts.push_back(w);
+    worker_counts.push_back(max_workers);
+
+    for (unsigned workers : worker_counts) {
+        HJBPool* pool = hjb_pool_create(workers, 1);
+
+        start = std::chrono::high_resolution_clock::now();
+        size_t pool_done = hjb_pool_calculate_batch(pool, mid.data(), inv.data(), vol.data(),
+                                                    n, pool_out.data());
+        end = std::chrono::high_resolution_clock::now();
+        double pool_s = std::chrono::duration<double>(end - start).count();
+
+        hjb_pool_destroy(pool);
+
+        for (size_t i = 0; i < pool_done; i++) {
+            if (scalar_out[i].bid != pool_out[i].bid || scalar_out[i].ask != pool_out[i].ask) {
+                mismatches++;
+            }
+        }
+        if (pool_done != n) done = pool_done;
+
+        std::printf("Pool   %2u workers:          %12.0f quotes/s\n", workers, pool_done / pool_s);
+    }
+
+    std::printf("Mismatches: %zu\n", mismatches);
+
+    return (done == n && mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+#include "hjb_model.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HJB_MODEL_X86 1
+#endif
+
+HJBModel::HJBModel() : isa_(bestIsa()) {}
+
+HJBModel::HJBModel(Isa isa) : isa_(isa) {
+    // Never run a kernel the CPU cannot execute
+    if (isa_ == Isa::AVX512 && bestIsa() != Isa::AVX512) isa_ = bestIsa();
+    if (isa_ == Isa::AVX2 && bestIsa() == Isa::Scalar) isa_ = Isa::Scalar;
+}
+
+HJBModel::Isa HJBModel::bestIsa() {
+#ifdef HJB_MODEL_X86
+    if (__builtin_cpu_supports("avx512f")) return Isa::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+#endif
+    return Isa::Scalar;
+}
+
+const char* HJBModel::isaName() const {
+    switch (isa_) {
+        case Isa::AVX512: return "AVX-512";
+        case Isa::AVX2:   return "AVX2";
+        default:          return "scalar";
+    }
+}
+
+void HJBModel::calculateBatch(const double* mid, const int32_t* inv, const double* vol,
+                              size_t n, HJBResult* out) const {
+    (void)vol;
+    switch (isa_) {
+        case Isa::AVX512: batchAVX512(mid, inv, n, out); break;
+        case Isa::AVX2:   batchAVX2(mid, inv, n, out); break;
+        default:          batchScalar(mid, inv, n, out); break;
+    }
+}
+
+// Write one lane's bit patterns back into the AoS result
+static inline void storeQuote(HJBResult& result, uint64_t bid_bits, uint64_t ask_bits) {
+    std::memcpy(&result.bid, &bid_bits, sizeof(double));
+    std::memcpy(&result.ask, &ask_bits, sizeof(double));
+    result.latency_ns = HJBModel::LATENCY_NS;
+}
+
+void HJBModel::batchScalar(const double* mid, const int32_t* inv, size_t n, HJBResult* out) {
+    for (size_t i = 0; i < n; i++) {
+        uint64_t mid_bits, bid_bits, ask_bits;
+        std::memcpy(&mid_bits, &mid[i], sizeof(double));
+        quote(mid_bits, inv[i], bid_bits, ask_bits);
+        storeQuote(out[i], bid_bits, ask_bits);
+    }
+}
+
+#ifdef HJB_MODEL_X86
+
+// 4 symbols per instruction
+__attribute__((target("avx2")))
+void HJBModel::batchAVX2(const double* mid, const int32_t* inv, size_t n, HJBResult* out) {
+    alignas(32) uint64_t bid[4], ask[4];
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i mid_bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mid + i));
+        // Zero-extend inventory like {32'h0, inventory}
+        __m256i inventory = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inv + i)));
+
+        __m256i reservation = _mm256_sub_epi64(mid_bits, _mm256_slli_epi64(inventory, 10));
+        __m256i half_spread = _mm256_srli_epi64(mid_bits, 8);
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bid), _mm256_sub_epi64(reservation, half_spread));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ask), _mm256_add_epi64(reservation, half_spread));
+
+        for (size_t lane = 0; lane < 4; lane++) {
+            storeQuote(out[i + lane], bid[lane], ask[lane]);
+        }
+    }
+
+    batchScalar(mid + i, inv + i, n - i, out + i);
+}
+
+// 8 symbols per instruction
+__attribute__((target("avx512f")))
+void HJBModel::batchAVX512(const double* mid, const int32_t* inv, size_t n, HJBResult* out) {
+    alignas(64) uint64_t bid[8], ask[8];
+    size_t i = 0;
+
+    // Zero-masked forms with every lane set: the unmasked intrinsics merge
+    // into an undefined vector, which g++ 12 reports as maybe-uninitialized
+    const __mmask8 lanes = 0xFF;
+
+    for (; i + 8 <= n; i += 8) {
+        __m512i mid_bits = _mm512_loadu_si512(mid + i);
+        __m512i inventory = _mm512_maskz_cvtepu32_epi64(lanes,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inv + i)));
+
+        __m512i reservation = _mm512_sub_epi64(mid_bits, _mm512_maskz_slli_epi64(lanes, inventory, 10));
+        __m512i half_spread = _mm512_maskz_srli_epi64(lanes, mid_bits, 8);
+
+        _mm512_store_si512(bid, _mm512_sub_epi64(reservation, half_spread));
+        _mm512_store_si512(ask, _mm512_add_epi64(reservation, half_spread));
+
+        for (size_t lane = 0; lane < 8; lane++) {
+            storeQuote(out[i + lane], bid[lane], ask[lane]);
+        }
+    }
+
+    batchScalar(mid + i, inv + i, n - i, out + i);
+}
+
+#else
+
+void HJBModel::batchAVX2(const double* mid, const int32_t* inv, size_t n, HJBResult* out) {
+    batchScalar(mid, inv, n, out);
+}
+
+void HJBModel::batchAVX512(const double* mid, const int32_t* inv, size_t n, HJBResult* out) {
+    batchScalar(mid, inv, n, out);
+}
+
+#endif
+
+extern "C" {
+
+    size_t hjb_calculate_native_batch(const double* mid, const int32_t* inv, const double* vol,
+                                      size_t n, HJBResult* out) {
+        static const HJBModel model;
+        model.calculateBatch(mid, inv, vol, n, out);
+        return n;
+    }
+}
@@ -0,0 +1,63 @@
+// Native C++ model of hjb_calculator
+// Reproduces the RTL quote arithmetic bit for bit so it can stand in for the
+// Verilated core on the fast path; the RTL stays the golden reference.
+#ifndef HJB_MODEL_H
+#define HJB_MODEL_H
+
+#include "hjb_wrapper.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+class HJBModel {
+public:
+    enum class Isa { Scalar, AVX2, AVX512 };
+
+    // Latency hjb_calculator reports for a request issued from IDLE
+    static constexpr uint32_t LATENCY_CYCLES = 4;
+    static constexpr uint32_t LATENCY_NS = LATENCY_CYCLES * 4; // 4ns per cycle @ 250MHz
+
+    // Picks the widest kernel the CPU supports
+    HJBModel();
+    explicit HJBModel(Isa isa);
+
+    Isa isa() const { return isa_; }
+    const char* isaName() const;
+    static Isa bestIsa();
+
+    // Quote one symbol; operates on the raw IEEE 754 bit patterns like the RTL
+    static void quote(uint64_t mid_bits, int32_t inventory, uint64_t& bid_bits, uint64_t& ask_bits) {
+        // reservation_price = mid_price - ({32'h0, inventory} << 10)
+        uint64_t reservation = mid_bits - (static_cast<uint64_t>(static_cast<uint32_t>(inventory)) << 10);
+        // spread = mid_price >> 7, quotes at reservation -/+ spread >> 1
+        uint64_t half_spread = (mid_bits >> 7) >> 1;
+        bid_bits = reservation - half_spread;
+        ask_bits = reservation + half_spread;
+    }
+
+    // Avellaneda-Stoikov quotes in double precision, the reference for
+    // hjb_calculator_fixed: r = mid - q*gamma*sigma^2, spread
+    // gamma*sigma^2 + (2/gamma)*ln(1 + gamma/kappa), quotes r -/+ spread/2
+    static void avellanedaStoikov(double mid, int32_t inventory, double sigma, double gamma,
+                                  double kappa, double& bid, double& ask) {
+        double gs2 = gamma * sigma * sigma;
+        double reservation = mid - inventory * gs2;
+        double half_spread = 0.5 * (gs2 + (2.0 / gamma) * std::log(1.0 + gamma / kappa));
+        bid = reservation - half_spread;
+        ask = reservation + half_spread;
+    }
+
+    // Quote n symbols with the selected kernel. volatility is accepted for
+    // interface parity; hjb_calculator does not use it yet.
+    void calculateBatch(const double* mid, const int32_t* inv, const double* vol,
+                        size_t n, HJBResult* out) const;
+
+private:
+    Isa isa_;
+
+    static void batchScalar(const double* mid, const int32_t* inv, size_t n, HJBResult* out);
+    static void batchAVX2(const double* mid, const int32_t* inv, size_t n, HJBResult* out);
+    static void batchAVX512(const double* mid, const int32_t* inv, size_t n, HJBResult* out);
+};
+
+#endif // HJB_MODEL_H
@@ -0,0 +1,418 @@
+// Python extension module over the HJB C interface (make python-hjb)
+//
+// Every engine type takes one-dimensional C-contiguous float64 mid and
+// volatility and int32 inventory through the buffer protocol, so NumPy
+// arrays are read in place rather than copied. Results are written straight
+// into a structured array with the HJBResult layout (bid, ask, latency_ns);
+// pass out= to reuse one across calls. The GIL is released while the model
+// runs, and each engine has its own lock, so engines can be driven from
+// separate Python threads while one engine is never run by two at once.
+//
+//   import numpy as np, veritrade_hjb
+//   pool = veritrade_hjb.Pool(workers=4)
+//   quotes = pool.calculate_batch(mid, inventory.astype(np.int32), vol)
+//   quotes["bid"], quotes["ask"], quotes["latency_ns"]
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <pythread.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hjb_wrapper.h"
+
+// Batch entry points differ only in the handle type
+typedef size_t (*BatchFn)(void* handle, const double* mid, const int32_t* inv,
+                          const double* vol, size_t n, HJBResult* out);
+typedef void (*DestroyFn)(void* handle);
+
+struct EngineObject {
+    PyObject_HEAD
+    void* handle;
+    BatchFn batch;
+    DestroyFn destroy;
+    PyThread_type_lock lock;
+};
+
+static size_t engineBatch(void* h, const double* mid, const int32_t* inv, const double* vol,
+                          size_t n, HJBResult* out) {
+    return hjb_engine_calculate_batch(static_cast<HJBEngine*>(h), mid, inv, vol, n, out);
+}
+static size_t poolBatch(void* h, const double* mid, const int32_t* inv, const double* vol,
+                        size_t n, HJBResult* out) {
+    return hjb_pool_calculate_batch(static_cast<HJBPool*>(h), mid, inv, vol, n, out);
+}
+static size_t streamBatch(void* h, const double* mid, const int32_t* inv, const double* vol,
+                          size_t n, HJBResult* out) {
+    return hjb_stream_calculate_batch(static_cast<HJBStreamEngine*>(h), mid, inv, vol, n, out);
+}
+static size_t fixedBatch(void* h, const double* mid, const int32_t* inv, const double* vol,
+                         size_t n, HJBResult* out) {
+    return hjb_fixed_calculate_batch(static_cast<HJBFixedEngine*>(h), mid, inv, vol, n, out);
+}
+
+static void engineDestroy(void* h) { hjb_destroy(static_cast<HJBEngine*>(h)); }
+static void poolDestroy(void* h) { hjb_pool_destroy(static_cast<HJBPool*>(h)); }
+static void streamDestroy(void* h) { hjb_stream_destroy(static_cast<HJBStreamEngine*>(h)); }
+static void fixedDestroy(void* h) { hjb_fixed_destroy(static_cast<HJBFixedEngine*>(h)); }
+
+// Holds a buffer view for the length of a call
+struct BufferView {
+    Py_buffer view{};
+    bool held = false;
+
+    ~BufferView() {
+        if (held) PyBuffer_Release(&view);
+    }
+};
+
+// Module-level dtype for results, built on first use so that passing out=
+// works without NumPy installed
+static PyObject* result_dtype = nullptr;
+
+// True when a struct-module format string names one native-size item of
+// type code; '@', '=' and '<' prefixes are all little-endian here
+static bool formatIs(const char* format, const char* codes) {
+    if (!format) return false;
+    if (*format == '@' || *format == '=' || *format == '<') format++;
+    if (!format[0] || format[1]) return false;
+    for (const char* c = codes; *c; ++c) {
+        if (*format == *c) return true;
+    }
+    return false;
+}
+
+static bool getInput(PyObject* obj, const char* name, const char* codes, Py_ssize_t itemsize,
+                     const char* type_name, BufferView& buffer) {
+    if (PyObject_GetBuffer(obj, &buffer.view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) return false;
+    buffer.held = true;
+    if (buffer.view.ndim != 1 || buffer.view.itemsize != itemsize ||
+        !formatIs(buffer.view.format, codes)) {
+        PyErr_Format(PyExc_TypeError, "%s must be a one-dimensional contiguous %s array",
+                     name, type_name);
+        return false;
+    }
+    return true;
+}
+
+// numpy.empty(n) of (bid, ask, latency_ns) records, aligned so its
+// itemsize and trailing padding match HJBResult
+static PyObject* newResultArray(Py_ssize_t n) {
+    PyObject* numpy = PyImport_ImportModule("numpy");
+    if (!numpy) return nullptr;
+    if (!result_dtype) {
+        PyObject* fields = Py_BuildValue("[(ss)(ss)(ss)]", "bid", "<f8", "ask", "<f8",
+                                         "latency_ns", "<u4");
+        if (fields) result_dtype = PyObject_CallMethod(numpy, "dtype", "(OO)", fields, Py_True);
+        Py_XDECREF(fields);
+    }
+    PyObject* array = result_dtype ? PyObject_CallMethod(numpy, "empty", "(nO)", n, result_dtype)
+                                   : nullptr;
+    Py_DECREF(numpy);
+    return array;
+}
+
+// Parses (mid, inventory, volatility[, out]) and returns a new reference to
+// the result array, or nullptr with an exception set
+static PyObject* getArrays(PyObject* args, PyObject* kwargs, BufferView& mid, BufferView& inv,
+                           BufferView& vol, BufferView& out) {
+    static const char* keywords[] = {"mid", "inventory", "volatility", "out", nullptr};
+    PyObject *mid_obj, *inv_obj, *vol_obj, *out_obj = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|O", const_cast<char**>(keywords),
+                                     &mid_obj, &inv_obj, &vol_obj, &out_obj))
+        return nullptr;
+
+    if (!getInput(mid_obj, "mid", "d", sizeof(double), "float64", mid) ||
+        !getInput(inv_obj, "inventory", "il", sizeof(int32_t), "int32", inv) ||
+        !getInput(vol_obj, "volatility", "d", sizeof(double), "float64", vol))
+        return nullptr;
+
+    Py_ssize_t n = mid.view.shape[0];
+    if (inv.view.shape[0] != n || vol.view.shape[0] != n) {
+        PyErr_SetString(PyExc_ValueError, "mid, inventory and volatility must have the same length");
+        return nullptr;
+    }
+
+    if (out_obj == Py_None) {
+        out_obj = newResultArray(n);
+        if (!out_obj) return nullptr;
+    } else {
+        Py_INCREF(out_obj);
+    }
+
+    if (PyObject_GetBuffer(out_obj, &out.view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) < 0) {
+        Py_DECREF(out_obj);
+        return nullptr;
+    }
+    out.held = true;
+    if (out.view.ndim != 1 || out.view.itemsize != sizeof(HJBResult) || out.view.shape[0] != n) {
+        PyErr_Format(PyExc_ValueError,
+                     "out must be a contiguous array of %zd %zu-byte (bid, ask, latency_ns) records",
+                     n, sizeof(HJBResult));
+        Py_DECREF(out_obj);
+        return nullptr;
+    }
+    return out_obj;
+}
+
+// Runs fn() with the GIL released and this engine's lock held
+template <typename Fn>
+static auto runLocked(EngineObject* self, Fn&& fn) -> decltype(fn()) {
+    decltype(fn()) done;
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->lock, WAIT_LOCK);
+    done = fn();
+    PyThread_release_lock(self->lock);
+    Py_END_ALLOW_THREADS
+    return done;
+}
+
+static bool checkOpen(EngineObject* self) {
+    if (self->handle) return true;
+    PyErr_SetString(PyExc_RuntimeError, "engine was not created");
+    return false;
+}
+
+static PyObject* Engine_calculate_batch(EngineObject* self, PyObject* args, PyObject* kwargs) {
+    if (!checkOpen(self)) return nullptr;
+    BufferView mid, inv, vol, out;
+    PyObject* result = getArrays(args, kwargs, mid, inv, vol, out);
+    if (!result) return nullptr;
+
+    size_t n = static_cast<size_t>(mid.view.shape[0]);
+    size_t done = runLocked(self, [&] {
+        return self->batch(self->handle, static_cast<const double*>(mid.view.buf),
+                           static_cast<const int32_t*>(inv.view.buf),
+                           static_cast<const double*>(vol.view.buf), n,
+                           static_cast<HJBResult*>(out.view.buf));
+    });
+    if (done < n) {
+        PyErr_Format(PyExc_RuntimeError, "HJB model timed out on quote %zu of %zu", done, n);
+        Py_DECREF(result);
+        return nullptr;
+    }
+    return result;
+}
+
+static PyObject* Engine_calculate(EngineObject* self, PyObject* args) {
+    if (!checkOpen(self)) return nullptr;
+    double mid, vol;
+    int inventory;
+    if (!PyArg_ParseTuple(args, "did", &mid, &inventory, &vol)) return nullptr;
+
+    HJBResult result;
+    int rc = runLocked(self, [&] {
+        return hjb_engine_calculate(static_cast<HJBEngine*>(self->handle), mid, inventory, vol,
+                                    &result);
+    });
+    if (rc) {
+        PyErr_SetString(PyExc_RuntimeError, "HJB model timed out");
+        return nullptr;
+    }
+    return Py_BuildValue("(ddI)", result.bid, result.ask, static_cast<unsigned>(result.latency_ns));
+}
+
+static PyObject* Engine_crosscheck(EngineObject* self, PyObject* args, PyObject* kwargs) {
+    if (!checkOpen(self)) return nullptr;
+    BufferView mid, inv, vol, out;
+    PyObject* result = getArrays(args, kwargs, mid, inv, vol, out);
+    if (!result) return nullptr;
+
+    size_t n = static_cast<size_t>(mid.view.shape[0]);
+    size_t timeouts = 0;
+    size_t mismatches = runLocked(self, [&] {
+        return hjb_crosscheck_batch(static_cast<HJBEngine*>(self->handle),
+                                    static_cast<const double*>(mid.view.buf),
+                                    static_cast<const int32_t*>(inv.view.buf),
+                                    static_cast<const double*>(vol.view.buf), n,
+                                    static_cast<HJBResult*>(out.view.buf), &timeouts);
+    });
+    return Py_BuildValue("(Nnn)", result, static_cast<Py_ssize_t>(mismatches),
+                         static_cast<Py_ssize_t>(timeouts));
+}
+
+static void Engine_dealloc(EngineObject* self) {
+    if (self->handle) self->destroy(self->handle);
+    if (self->lock) PyThread_free_lock(self->lock);
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+static PyObject* Engine_new(PyTypeObject* type, PyObject*, PyObject*) {
+    EngineObject* self = reinterpret_cast<EngineObject*>(type->tp_alloc(type, 0));
+    if (!self) return nullptr;
+    self->lock = PyThread_allocate_lock();
+    if (!self->lock) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+// Stores a freshly created handle, replacing any from an earlier __init__
+static int setHandle(EngineObject* self, void* handle, BatchFn batch, DestroyFn destroy) {
+    if (!handle) {
+        PyErr_SetString(PyExc_RuntimeError, "failed to create HJB engine");
+        return -1;
+    }
+    if (self->handle) self->destroy(self->handle);
+    self->handle = handle;
+    self->batch = batch;
+    self->destroy = destroy;
+    return 0;
+}
+
+static int Engine_init(EngineObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", const_cast<char**>(keywords))) return -1;
+    return setHandle(self, hjb_create(), engineBatch, engineDestroy);
+}
+
+static int Pool_init(EngineObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"workers", "pin_threads", nullptr};
+    Py_ssize_t workers = 0;
+    int pin_threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|np", const_cast<char**>(keywords),
+                                     &workers, &pin_threads))
+        return -1;
+    if (workers < 0) {
+        PyErr_SetString(PyExc_ValueError, "workers must be >= 0");
+        return -1;
+    }
+    void* pool;
+    Py_BEGIN_ALLOW_THREADS
+    pool = hjb_pool_create(static_cast<size_t>(workers), pin_threads);
+    Py_END_ALLOW_THREADS
+    return setHandle(self, pool, poolBatch, poolDestroy);
+}
+
+static int StreamEngine_init(EngineObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", const_cast<char**>(keywords))) return -1;
+    return setHandle(self, hjb_stream_create(), streamBatch, streamDestroy);
+}
+
+static int FixedEngine_init(EngineObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"gamma", "kappa", nullptr};
+    double gamma = 0.1, kappa = 1.5;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|dd", const_cast<char**>(keywords),
+                                     &gamma, &kappa))
+        return -1;
+    if (!(gamma > 0.0) || !(kappa > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "gamma and kappa must be positive");
+        return -1;
+    }
+    return setHandle(self, hjb_fixed_create(gamma, kappa), fixedBatch, fixedDestroy);
+}
+
+#define BATCH_DOC \
+    "calculate_batch(mid, inventory, volatility, out=None) -> out\n\n" \
+    "Quotes one-dimensional contiguous float64 mid and volatility and int32\n" \
+    "inventory arrays, filling a (bid, ask, latency_ns) record array."
+
+static PyMethodDef batch_methods[] = {
+    {"calculate_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Engine_calculate_batch)),
+     METH_VARARGS | METH_KEYWORDS, BATCH_DOC},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyMethodDef engine_methods[] = {
+    {"calculate_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Engine_calculate_batch)),
+     METH_VARARGS | METH_KEYWORDS, BATCH_DOC},
+    {"calculate", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Engine_calculate)),
+     METH_VARARGS, "calculate(mid, inventory, volatility) -> (bid, ask, latency_ns)"},
+    {"crosscheck", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Engine_crosscheck)),
+     METH_VARARGS | METH_KEYWORDS,
+     "crosscheck(mid, inventory, volatility, out=None) -> (out, mismatches, timeouts)\n\n"
+     "Runs the batch through the RTL and the native model and counts quotes\n"
+     "whose bit patterns differ; out holds the RTL results and timeouts\n"
+     "counts the quotes the RTL never produced."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyTypeObject makeType(const char* name, const char* doc, PyMethodDef* methods, initproc init) {
+    PyTypeObject type{};
+    Py_SET_REFCNT(reinterpret_cast<PyObject*>(&type), 1);
+    type.tp_name = name;
+    type.tp_basicsize = sizeof(EngineObject);
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_doc = doc;
+    type.tp_methods = methods;
+    type.tp_new = Engine_new;
+    type.tp_init = init;
+    type.tp_dealloc = reinterpret_cast<destructor>(Engine_dealloc);
+    return type;
+}
+
+static PyTypeObject EngineType = makeType(
+    "veritrade_hjb.Engine",
+    "Engine()\n\nOne Verilated FSM HJB core, quotes computed one at a time.",
+    engine_methods, reinterpret_cast<initproc>(Engine_init));
+static PyTypeObject PoolType = makeType(
+    "veritrade_hjb.Pool",
+    "Pool(workers=0, pin_threads=False)\n\n"
+    "Persistent workers, each with its own FSM core; a batch is split across\n"
+    "them. workers=0 uses one per hardware thread.",
+    batch_methods, reinterpret_cast<initproc>(Pool_init));
+static PyTypeObject StreamEngineType = makeType(
+    "veritrade_hjb.StreamEngine",
+    "StreamEngine()\n\nThe pipelined HJB core, one quote accepted per cycle.",
+    batch_methods, reinterpret_cast<initproc>(StreamEngine_init));
+static PyTypeObject FixedEngineType = makeType(
+    "veritrade_hjb.FixedEngine",
+    "FixedEngine(gamma=0.1, kappa=1.5)\n\n"
+    "The Q32.32 fixed-point pipelined core; results are converted to double.",
+    batch_methods, reinterpret_cast<initproc>(FixedEngine_init));
+
+static PyObject* native_batch(PyObject*, PyObject* args, PyObject* kwargs) {
+    BufferView mid, inv, vol, out;
+    PyObject* result = getArrays(args, kwargs, mid, inv, vol, out);
+    if (!result) return nullptr;
+
+    size_t n = static_cast<size_t>(mid.view.shape[0]);
+    Py_BEGIN_ALLOW_THREADS
+    hjb_calculate_native_batch(static_cast<const double*>(mid.view.buf),
+                               static_cast<const int32_t*>(inv.view.buf),
+                               static_cast<const double*>(vol.view.buf), n,
+                               static_cast<HJBResult*>(out.view.buf));
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+static PyMethodDef module_methods[] = {
+    {"native_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(native_batch)),
+     METH_VARARGS | METH_KEYWORDS,
+     "native_batch(mid, inventory, volatility, out=None) -> out\n\n"
+     "The same quotes from the host reference model, without the RTL."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static struct PyModuleDef hjb_module = {
+    PyModuleDef_HEAD_INIT, "veritrade_hjb",
+    "HJB market-making quotes from the Verilated RTL cores", -1, module_methods,
+    nullptr, nullptr, nullptr, nullptr
+};
+
+PyMODINIT_FUNC PyInit_veritrade_hjb(void) {
+    PyTypeObject* types[] = {&EngineType, &PoolType, &StreamEngineType, &FixedEngineType};
+    for (PyTypeObject* type : types) {
+        if (PyType_Ready(type) < 0) return nullptr;
+    }
+
+    PyObject* module = PyModule_Create(&hjb_module);
+    if (!module) return nullptr;
+    for (PyTypeObject* type : types) {
+        const char* name = type->tp_name + sizeof("veritrade_hjb.") - 1;
+        Py_INCREF(type);
+        if (PyModule_AddObject(module, name, reinterpret_cast<PyObject*>(type)) < 0) {
+            Py_DECREF(type);
+            Py_DECREF(module);
+            return nullptr;
+        }
+    }
+    if (PyModule_AddIntConstant(module, "RESULT_ITEMSIZE", sizeof(HJBResult)) < 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+veritrade_hjb smoke test (run by make python-hjb)
+
+Features:
+- Engine, Pool and StreamEngine batches bit-identical to native_batch, and
+  Engine.calculate() and crosscheck() agreeing with them
+- FixedEngine within the benchmark's error bound of the double-precision
+  Avellaneda-Stoikov quotes
+- One out= buffer reused across calls and engines
+- Wrong dtypes, non-contiguous and mismatched inputs raise
+
+Inputs are array.array and results a ctypes array with the HJBResult layout,
+so the test needs nothing beyond the standard library.
+
+    PYTHONPATH=obj_dir_python_hjb python3 cpp_wrapper/hjb_python_test.py
+"""
+
+import array
+import ctypes
+import math
+import random
+import sys
+
+import veritrade_hjb
+
+QUOTES = 1000
+GAMMA = 0.1
+KAPPA = 1.5
+FIXED_TOLERANCE = 1e-4  # same bound as hjb_benchmark
+
+
+class HJBResult(ctypes.Structure):
+    _fields_ = [("bid", ctypes.c_double), ("ask", ctypes.c_double),
+                ("latency_ns", ctypes.c_uint32)]
+
+
+failures = 0
+
+
+def check(ok: bool, message: str):
+    global failures
+    print(f"{'✓' if ok else '✗'} {message}")
+    if not ok:
+        failures += 1
+
+
+def quotes(out) -> list:
+    return [(r.bid, r.ask) for r in out]
+
+
+def raises(fn, *exceptions) -> bool:
+    try:
+        fn()
+    except exceptions:
+        return True
+    return False
+
+
+def avellaneda_stoikov(mid: float, inventory: int, sigma: float) -> tuple:
+    gs2 = GAMMA * sigma * sigma
+    reservation = mid - inventory * gs2
+    half_spread = 0.5 * (gs2 + (2.0 / GAMMA) * math.log(1.0 + GAMMA / KAPPA))
+    return reservation - half_spread, reservation + half_spread
+
+
+def main() -> int:
+    check(ctypes.sizeof(HJBResult) == veritrade_hjb.RESULT_ITEMSIZE,
+          f"HJBResult is {veritrade_hjb.RESULT_ITEMSIZE} bytes")
+
+    # Same ranges as hjb_benchmark
+    rng = random.Random(42)
+    mid = array.array("d", (rng.uniform(90000.0, 110000.0) for _ in range(QUOTES)))
+    inv = array.array("i", (rng.randint(-100, 100) for _ in range(QUOTES)))
+    vol = array.array("d", (rng.uniform(0.1, 0.5) for _ in range(QUOTES)))
+
+    reference = (HJBResult * QUOTES)()
+    check(veritrade_hjb.native_batch(mid, inv, vol, out=reference) is reference,
+          "native_batch fills and returns out")
+    expected = quotes(reference)
+
+    # One buffer for every engine; it is cleared first so a call that
+    # writes nothing cannot pass on the last engine's results
+    out = (HJBResult * QUOTES)()
+    engine = veritrade_hjb.Engine()
+    for name, quoter in (("Engine", engine), ("Pool", veritrade_hjb.Pool(workers=2)),
+                         ("StreamEngine", veritrade_hjb.StreamEngine())):
+        ctypes.memset(out, 0, ctypes.sizeof(out))
+        result = quoter.calculate_batch(mid, inv, vol, out=out)
+        check(result is out and quotes(out) == expected,
+              f"{name} batch matches native_batch in the reused out buffer")
+
+    scalar = [engine.calculate(mid[i], inv[i], vol[i])[:2] for i in range(16)]
+    check(scalar == expected[:16], "Engine.calculate matches native_batch")
+
+    _, mismatches, timeouts = engine.crosscheck(mid, inv, vol, out=out)
+    check(mismatches == 0 and timeouts == 0,
+          f"crosscheck: {mismatches} mismatches, {timeouts} timeouts")
+
+    ctypes.memset(out, 0, ctypes.sizeof(out))
+    veritrade_hjb.FixedEngine(gamma=GAMMA, kappa=KAPPA).calculate_batch(mid, inv, vol, out=out)
+    error = max(max(abs(r.bid - bid), abs(r.ask - ask))
+                for r, (bid, ask) in zip(out, map(avellaneda_stoikov, mid, inv, vol)))
+    check(error <= FIXED_TOLERANCE, f"FixedEngine max error {error:.3g} against double precision")
+
+    # Bad inputs are refused before any engine runs
+    float32_mid = array.array("f", mid)
+    int64_inv = array.array("q", inv)
+    strided_mid = memoryview(array.array("d", mid) * 2)[::2]
+    check(raises(lambda: engine.calculate_batch(float32_mid, inv, vol), TypeError),
+          "float32 mid raises TypeError")
+    check(raises(lambda: veritrade_hjb.native_batch(mid, int64_inv, vol), TypeError),
+          "int64 inventory raises TypeError")
+    check(raises(lambda: engine.calculate_batch(strided_mid, inv, vol), BufferError),
+          "non-contiguous mid raises BufferError")
+    check(raises(lambda: engine.calculate_batch(mid, inv[:-1], vol), ValueError),
+          "mismatched lengths raise ValueError")
+    check(raises(lambda: engine.calculate_batch(mid, inv, vol, out=(HJBResult * 10)()), ValueError),
+          "short out buffer raises ValueError")
+    check(raises(lambda: veritrade_hjb.FixedEngine(gamma=0.0), ValueError),
+          "FixedEngine(gamma=0) raises ValueError")
+
+    print(f"\n{failures} failures" if failures else "\nveritrade_hjb smoke test passed")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,85 +1,525 @@
 #include "Vhjb_calculator.h"
+#include "Vhjb_calculator_pipelined.h"
+#include "Vhjb_calculator_fixed.h"
 #include "verilated.h"
+#include "hjb_wrapper.h"
+#include "hjb_model.h"
+#include "cycle_runner.h"
+#include <algorithm>
+#include <cinttypes>
 #include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Timeout for a single calculation, in half-cycles
+static constexpr uint64_t HJB_TIMEOUT = 1000;
+
+// One Verilated model with its own context and simulation time
+struct HJBEngine {
+    std::unique_ptr<VerilatedContext> context;
+    std::unique_ptr<Vhjb_calculator> module;
+    uint64_t main_time = 0;
+};
+
+// Pipelined model used by the streaming API
+struct HJBStreamEngine {
+    std::unique_ptr<VerilatedContext> context;
+    std::unique_ptr<Vhjb_calculator_pipelined> module;
+    uint64_t main_time = 0;
+};
+
+// Fixed-point model, with its Q32.32 parameters and per-batch scratch
+struct HJBFixedEngine {
+    std::unique_ptr<VerilatedContext> context;
+    std::unique_ptr<Vhjb_calculator_fixed> module;
+    uint64_t main_time = 0;
+    uint64_t gamma_q = 0;
+    uint64_t two_over_gamma_q = 0;
+    uint64_t inv_kappa_q = 0;
+    std::vector<uint64_t> mid_q, vol_q, bid_q, ask_q;
+};
+
+// Q32.32 conversions for hjb_calculator_fixed
+static inline uint64_t to_q32_32(double value) {
+    return static_cast<uint64_t>(std::llround(value * 4294967296.0));
+}
+
+static inline double from_q32_32(uint64_t value) {
+    return static_cast<double>(static_cast<int64_t>(value)) / 4294967296.0;
+}
+
+// Default engine behind the original hjb_init()/hjb_calculate() API
+static HJBEngine* default_engine = nullptr;
+
+// Advance the model by one full clock cycle (two half-cycles)
+template <typename Engine>
+static inline void hjb_clock(Engine* engine) {
+    auto* hjb_module = engine->module.get();
+    hjb_module->clk = 1;
+    hjb_module->eval();
+    hjb_module->clk = 0;
+    hjb_module->eval();
+    engine->main_time += 2;
+}
+
+// Clock until watch(module) fires, for at most HJB_TIMEOUT half-cycles.
+// Returns false on timeout.
+template <typename Engine, typename Watch>
+static inline bool hjb_run_until(Engine* engine, Watch&& watch) {
+    CycleRunner<typename decltype(engine->module)::element_type> runner(engine->module.get());
+    auto run = runner.runUntil(HJB_TIMEOUT / 2, watch);
+    engine->main_time += 2 * run.cycles;
+    return run.fired;
+}
+
+// Hold reset for a few half-cycles and release it with clk low
+template <typename Engine>
+static void hjb_reset(Engine* engine) {
+    auto* hjb_module = engine->module.get();
+    hjb_module->rst_n = 0;
+    hjb_module->clk = 0;
+    hjb_module->eval();
+
+    // Clock cycles for reset
+    for (int i = 0; i < 5; i++) {
+        hjb_module->clk = !hjb_module->clk;
+        hjb_module->eval();
+        engine->main_time++;
+    }
+
+    hjb_module->rst_n = 1;
+    hjb_module->clk = 0;
+    hjb_module->eval();
+}
+
+// Drive one request through the FSM and leave it back in IDLE for the next one
+static int hjb_run_one(HJBEngine* engine, uint64_t mid_bits, int32_t inventory, uint64_t vol_bits,
+                       HJBResult* result) {
+    Vhjb_calculator* hjb_module = engine->module.get();
+
+    hjb_module->mid_price = mid_bits;
+    hjb_module->inventory = inventory;
+    hjb_module->volatility = vol_bits;
+    hjb_module->calculate_en = 1;
+
+    // Clock until done
+    if (!hjb_module->calculation_done &&
+        !hjb_run_until(engine, [](const Vhjb_calculator& m) { return m.calculation_done; })) {
+        return -1; // Timeout
+    }
+
+    // Convert results back to double
+    uint64_t bid_bits = hjb_module->optimal_bid;
+    uint64_t ask_bits = hjb_module->optimal_ask;
+    std::memcpy(&result->bid, &bid_bits, sizeof(double));
+    std::memcpy(&result->ask, &ask_bits, sizeof(double));
+    result->latency_ns = hjb_module->latency_cycles * 4; // 4ns per cycle @ 250MHz
+
+    // Release calculate_en and clock until calculation_done drops. DONE only
+    // returns to IDLE on a clock edge and IDLE clears the flag one edge later;
+    // stopping any earlier would make the next request read back this result
+    hjb_module->calculate_en = 0;
+    if (hjb_module->calculation_done) {
+        hjb_run_until(engine, [](const Vhjb_calculator& m) { return !m.calculation_done; });
+    }
+    return 0;
+}
+
+static size_t hjb_run_batch(HJBEngine* engine, const double* mid, const int32_t* inv,
+                            const double* vol, size_t n, HJBResult* out) {
+    // Same FSM handshake as hjb_calculate, but the whole batch runs in one
+    // FFI call so the per-quote cost is just the simulated cycles
+    for (size_t i = 0; i < n; i++) {
+        uint64_t mid_bits, vol_bits;
+        std::memcpy(&mid_bits, &mid[i], sizeof(double));
+        std::memcpy(&vol_bits, &vol[i], sizeof(double));
+
+        if (hjb_run_one(engine, mid_bits, inv[i], vol_bits, &out[i]) != 0) {
+            return i; // Timeout
+        }
+    }
+
+    return n;
+}
+
+// Worker threads for hjb_pool_*. Each worker builds its engine on its own
+// thread and waits for the next batch generation.
+struct HJBPool {
+    std::vector<std::thread> workers;
+    std::mutex batch_mutex;     // Serializes callers of hjb_pool_calculate_batch
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    uint64_t generation = 0;
+    size_t pending = 0;
+    bool shutdown = false;
+
+    // Current batch, valid while pending > 0
+    const double* mid = nullptr;
+    const int32_t* inv = nullptr;
+    const double* vol = nullptr;
+    size_t n = 0;
+    HJBResult* out = nullptr;
+    size_t first_failure = 0;
+};
+
+static void hjb_pool_worker(HJBPool* pool, size_t worker_id, size_t num_workers, bool pin) {
+#ifdef __linux__
+    if (pin) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(worker_id % std::max(1u, std::thread::hardware_concurrency()), &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    }
+#else
+    (void)pin;
+#endif
+
+    HJBEngine* engine = hjb_create();
+    uint64_t seen_generation = 0;
+
+    for (;;) {
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        pool->work_cv.wait(lock, [&] { return pool->shutdown || pool->generation != seen_generation; });
+        if (pool->shutdown) break;
+        seen_generation = pool->generation;
+
+        // Contiguous shard of the batch for this worker
+        size_t begin = pool->n * worker_id / num_workers;
+        size_t end = pool->n * (worker_id + 1) / num_workers;
+        const double* mid = pool->mid;
+        const int32_t* inv = pool->inv;
+        const double* vol = pool->vol;
+        HJBResult* out = pool->out;
+        lock.unlock();
+
+        size_t done = begin + hjb_run_batch(engine, mid + begin, inv + begin, vol + begin,
+                                            end - begin, out + begin);
+
+        lock.lock();
+        if (done < end) {
+            pool->first_failure = std::min(pool->first_failure, done);
+        }
+        if (--pool->pending == 0) {
+            pool->done_cv.notify_one();
+        }
+    }
+
+    hjb_destroy(engine);
+}
 
 extern "C" {
-    struct HJBResult {
-        double bid;
-        double ask;
-        uint32_t latency_ns;
-    };
 
-    static Vhjb_calculator* hjb_module = nullptr;
-    static uint64_t main_time = 0;
+    HJBEngine* hjb_create() {
+        HJBEngine* engine = new HJBEngine;
+        engine->context = std::make_unique<VerilatedContext>();
+        engine->module = std::make_unique<Vhjb_calculator>(engine->context.get());
+
+        engine->module->calculate_en = 0;
+        hjb_reset(engine);
+
+        return engine;
+    }
+
+    void hjb_destroy(HJBEngine* engine) {
+        if (engine) {
+            engine->module->final();
+            delete engine;
+        }
+    }
+
+    int hjb_engine_calculate(HJBEngine* engine, double mid_price, int32_t inventory,
+                             double volatility, HJBResult* result) {
+        if (!engine) return -1;
+
+        // Convert double to 64-bit representation for Verilog
+        uint64_t mid_bits, vol_bits;
+        std::memcpy(&mid_bits, &mid_price, sizeof(double));
+        std::memcpy(&vol_bits, &volatility, sizeof(double));
+
+        return hjb_run_one(engine, mid_bits, inventory, vol_bits, result);
+    }
+
+    size_t hjb_engine_calculate_batch(HJBEngine* engine, const double* mid, const int32_t* inv,
+                                      const double* vol, size_t n, HJBResult* out) {
+        if (!engine) return 0;
+        return hjb_run_batch(engine, mid, inv, vol, n, out);
+    }
+
+    HJBPool* hjb_pool_create(size_t num_workers, int pin_threads) {
+        if (num_workers == 0) {
+            num_workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        HJBPool* pool = new HJBPool;
+        pool->workers.reserve(num_workers);
+        for (size_t w = 0; w < num_workers; w++) {
+            pool->workers.emplace_back(hjb_pool_worker, pool, w, num_workers, pin_threads != 0);
+        }
+        return pool;
+    }
+
+    void hjb_pool_destroy(HJBPool* pool) {
+        if (!pool) return;
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            pool->shutdown = true;
+        }
+        pool->work_cv.notify_all();
+        for (auto& worker : pool->workers) {
+            worker.join();
+        }
+        delete pool;
+    }
+
+    size_t hjb_pool_calculate_batch(HJBPool* pool, const double* mid, const int32_t* inv,
+                                    const double* vol, size_t n, HJBResult* out) {
+        if (!pool) return 0;
+
+        std::lock_guard<std::mutex> batch_lock(pool->batch_mutex);
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        pool->mid = mid;
+        pool->inv = inv;
+        pool->vol = vol;
+        pool->n = n;
+        pool->out = out;
+        pool->first_failure = n;
+        pool->pending = pool->workers.size();
+        pool->generation++;
+        pool->work_cv.notify_all();
+
+        pool->done_cv.wait(lock, [&] { return pool->pending == 0; });
+        return pool->first_failure;
+    }
+
+    HJBStreamEngine* hjb_stream_create() {
+        HJBStreamEngine* engine = new HJBStreamEngine;
+        engine->context = std::make_unique<VerilatedContext>();
+        engine->module = std::make_unique<Vhjb_calculator_pipelined>(engine->context.get());
+
+        engine->module->in_valid = 0;
+        engine->module->out_ready = 1;
+        hjb_reset(engine);
+
+        return engine;
+    }
+
+    void hjb_stream_destroy(HJBStreamEngine* engine) {
+        if (engine) {
+            engine->module->final();
+            delete engine;
+        }
+    }
+
+    size_t hjb_stream_calculate_batch(HJBStreamEngine* engine, const double* mid, const int32_t* inv,
+                                      const double* vol, size_t n, HJBResult* out) {
+        if (!engine) return 0;
+
+        Vhjb_calculator_pipelined* hjb_module = engine->module.get();
+        uint32_t latency_ns = hjb_module->latency_cycles * 4; // 4ns per cycle @ 250MHz
+        size_t issued = 0;
+        size_t received = 0;
+        uint64_t last_progress = engine->main_time;
+
+        // Results are always taken, so the pipeline never stalls and a new
+        // request goes in on every edge until the batch is exhausted
+        hjb_module->out_ready = 1;
+
+        while (received < n) {
+            if (issued < n) {
+                uint64_t mid_bits, vol_bits;
+                std::memcpy(&mid_bits, &mid[issued], sizeof(double));
+                std::memcpy(&vol_bits, &vol[issued], sizeof(double));
+                hjb_module->in_mid_price = mid_bits;
+                hjb_module->in_inventory = inv[issued];
+                hjb_module->in_volatility = vol_bits;
+                hjb_module->in_tag = static_cast<uint32_t>(issued);
+                hjb_module->in_valid = 1;
+
+                bool accepted = hjb_module->in_ready;
+                hjb_clock(engine);
+                if (accepted) issued++;
+            } else {
+                // Everything issued: run straight to the next result
+                hjb_module->in_valid = 0;
+                if (!hjb_run_until(engine, [](const Vhjb_calculator_pipelined& m) { return m.out_valid; })) {
+                    break; // Timeout
+                }
+            }
+
+            if (hjb_module->out_valid) {
+                HJBResult& result = out[hjb_module->out_tag];
+                uint64_t bid_bits = hjb_module->out_bid;
+                uint64_t ask_bits = hjb_module->out_ask;
+                std::memcpy(&result.bid, &bid_bits, sizeof(double));
+                std::memcpy(&result.ask, &ask_bits, sizeof(double));
+                result.latency_ns = latency_ns;
+                received++;
+                last_progress = engine->main_time;
+            } else if (engine->main_time - last_progress >= HJB_TIMEOUT) {
+                break; // Timeout
+            }
+        }
+
+        hjb_module->in_valid = 0;
+        return received;
+    }
+
+    HJBFixedEngine* hjb_fixed_create(double gamma, double kappa) {
+        HJBFixedEngine* engine = new HJBFixedEngine;
+        engine->context = std::make_unique<VerilatedContext>();
+        engine->module = std::make_unique<Vhjb_calculator_fixed>(engine->context.get());
+
+        // The core has no divider, so 2/gamma and 1/kappa are set up here
+        engine->gamma_q = to_q32_32(gamma);
+        engine->two_over_gamma_q = to_q32_32(2.0 / gamma);
+        engine->inv_kappa_q = to_q32_32(1.0 / kappa);
+        engine->module->cfg_gamma = engine->gamma_q;
+        engine->module->cfg_two_over_gamma = engine->two_over_gamma_q;
+        engine->module->cfg_inv_kappa = engine->inv_kappa_q;
+
+        engine->module->in_valid = 0;
+        engine->module->out_ready = 1;
+        hjb_reset(engine);
+
+        return engine;
+    }
+
+    void hjb_fixed_destroy(HJBFixedEngine* engine) {
+        if (engine) {
+            engine->module->final();
+            delete engine;
+        }
+    }
+
+    size_t hjb_fixed_calculate_batch(HJBFixedEngine* engine, const double* mid, const int32_t* inv,
+                                     const double* vol, size_t n, HJBResult* out) {
+        if (!engine) return 0;
+
+        // double -> Q32.32 once for the whole batch, outside the clock loop
+        engine->mid_q.resize(n);
+        engine->vol_q.resize(n);
+        engine->bid_q.resize(n);
+        engine->ask_q.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            engine->mid_q[i] = to_q32_32(mid[i]);
+            engine->vol_q[i] = to_q32_32(vol[i]);
+        }
+
+        Vhjb_calculator_fixed* hjb_module = engine->module.get();
+        uint32_t latency_ns = hjb_module->latency_cycles * 4; // 4ns per cycle @ 250MHz
+        size_t issued = 0;
+        size_t received = 0;
+        uint64_t last_progress = engine->main_time;
+
+        hjb_module->out_ready = 1;
+
+        while (received < n) {
+            if (issued < n) {
+                hjb_module->in_mid_price = engine->mid_q[issued];
+                hjb_module->in_inventory = inv[issued];
+                hjb_module->in_volatility = engine->vol_q[issued];
+                hjb_module->in_tag = static_cast<uint32_t>(issued);
+                hjb_module->in_valid = 1;
+
+                bool accepted = hjb_module->in_ready;
+                hjb_clock(engine);
+                if (accepted) issued++;
+            } else {
+                // Everything issued: run straight to the next result
+                hjb_module->in_valid = 0;
+                if (!hjb_run_until(engine, [](const Vhjb_calculator_fixed& m) { return m.out_valid; })) {
+                    break; // Timeout
+                }
+            }
+
+            if (hjb_module->out_valid) {
+                engine->bid_q[hjb_module->out_tag] = hjb_module->out_bid;
+                engine->ask_q[hjb_module->out_tag] = hjb_module->out_ask;
+                received++;
+                last_progress = engine->main_time;
+            } else if (engine->main_time - last_progress >= HJB_TIMEOUT) {
+                break; // Timeout
+            }
+        }
+
+        hjb_module->in_valid = 0;
+
+        // Q32.32 -> double once on the way out. Quotes come back in order, so
+        // the first received slots are the completed ones.
+        for (size_t i = 0; i < received; i++) {
+            out[i].bid = from_q32_32(engine->bid_q[i]);
+            out[i].ask = from_q32_32(engine->ask_q[i]);
+            out[i].latency_ns = latency_ns;
+        }
+        return received;
+    }
+
+    size_t hjb_crosscheck_batch(HJBEngine* engine, const double* mid, const int32_t* inv,
+                                const double* vol, size_t n, HJBResult* out, size_t* timeouts) {
+        static constexpr size_t MAX_REPORTED = 10;
+
+        std::vector<HJBResult> native(n);
+        HJBModel().calculateBatch(mid, inv, vol, n, native.data());
+        size_t done = engine ? hjb_run_batch(engine, mid, inv, vol, n, out) : 0;
+
+        // Quotes the RTL never produced are timeouts, not mismatches, and
+        // leave the report budget to the values that actually differ
+        size_t mismatches = 0;
+        for (size_t i = 0; i < done; i++) {
+            uint64_t rtl_bid, rtl_ask, model_bid, model_ask;
+            std::memcpy(&rtl_bid, &out[i].bid, sizeof(double));
+            std::memcpy(&rtl_ask, &out[i].ask, sizeof(double));
+            std::memcpy(&model_bid, &native[i].bid, sizeof(double));
+            std::memcpy(&model_ask, &native[i].ask, sizeof(double));
+
+            if (rtl_bid != model_bid || rtl_ask != model_ask) {
+                if (mismatches < MAX_REPORTED) {
+                    std::fprintf(stderr,
+                                 "HJB mismatch [%zu] mid=%.17g inv=%d: "
+                                 "rtl bid=%016" PRIx64 " ask=%016" PRIx64 ", "
+                                 "model bid=%016" PRIx64 " ask=%016" PRIx64 "\n",
+                                 i, mid[i], inv[i], rtl_bid, rtl_ask, model_bid, model_ask);
+                }
+                mismatches++;
+            }
+        }
+
+        if (done < n) {
+            std::fprintf(stderr, "HJB crosscheck: RTL timed out at quote %zu of %zu (%zu quotes missing)\n",
+                         done, n, n - done);
+        }
+        if (timeouts) *timeouts = n - done;
+        return mismatches;
+    }
 
     int hjb_init() {
-        if (hjb_module) return 0;
-        
-        Verilated::commandArgs(0, (const char**)nullptr);
-        hjb_module = new Vhjb_calculator;
-        
-        // Reset
-        hjb_module->rst_n = 0;
-        hjb_module->clk = 0;
-        hjb_module->calculate_en = 0;
-        hjb_module->eval();
-        
-        // Clock cycles for reset
-        for (int i = 0; i < 5; i++) {
-            hjb_module->clk = !hjb_module->clk;
-            hjb_module->eval();
-            main_time++;
-        }
-        
-        hjb_module->rst_n = 1;
-        hjb_module->eval();
-        
+        if (default_engine) return 0;
+        default_engine = hjb_create();
         return 0;
     }
 
     int hjb_calculate(double mid_price, int32_t inventory, double volatility, HJBResult* result) {
-        if (!hjb_module) return -1;
-        
-        uint64_t start_time = main_time;
-        
-        // Convert double to 64-bit representation for Verilog
-        union { double d; uint64_t i; } mid_conv = {mid_price};
-        union { double d; uint64_t i; } vol_conv = {volatility};
-        
-        hjb_module->mid_price = mid_conv.i;
-        hjb_module->inventory = inventory;
-        hjb_module->volatility = vol_conv.i;
-        hjb_module->calculate_en = 1;
-        hjb_module->eval();
-        
-        // Clock until done
-        while (!hjb_module->calculation_done && (main_time - start_time) < 1000) {
-            hjb_module->clk = !hjb_module->clk;
-            hjb_module->eval();
-            main_time++;
-        }
-        
-        if (hjb_module->calculation_done) {
-            // Convert results back to double
-            union { uint64_t i; double d; } bid_conv = {hjb_module->optimal_bid};
-            union { uint64_t i; double d; } ask_conv = {hjb_module->optimal_ask};
-            
-            result->bid = bid_conv.d;
-            result->ask = ask_conv.d;
-            result->latency_ns = hjb_module->latency_cycles * 4; // 4ns per cycle @ 250MHz
-            
-            hjb_module->calculate_en = 0;
-            hjb_module->eval();
-            return 0;
-        }
-        
-        return -1; // Timeout
+        return hjb_engine_calculate(default_engine, mid_price, inventory, volatility, result);
+    }
+
+    size_t hjb_calculate_batch(const double* mid, const int32_t* inv, const double* vol,
+                               size_t n, HJBResult* out) {
+        return hjb_engine_calculate_batch(default_engine, mid, inv, vol, n, out);
     }
 
     void hjb_cleanup() {
-        if (hjb_module) {
-            delete hjb_module;
-            hjb_module = nullptr;
-        }
+        hjb_destroy(default_engine);
+        default_engine = nullptr;
     }
-}
\ No newline at end of file
+}
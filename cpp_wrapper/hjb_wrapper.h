@@ -0,0 +1,93 @@
+// C interface to the Verilated HJB calculator (verilator-hjb-lib)
+#ifndef HJB_WRAPPER_H
+#define HJB_WRAPPER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct HJBResult {
+    double bid;
+    double ask;
+    uint32_t latency_ns;
+} HJBResult;
+
+int hjb_init();
+int hjb_calculate(double mid_price, int32_t inventory, double volatility, HJBResult* result);
+
+// Streams n requests through the model in one call; out[i] holds the quote for
+// (mid[i], inv[i], vol[i]). Returns the number of quotes completed, which is
+// less than n only if the model timed out.
+size_t hjb_calculate_batch(const double* mid, const int32_t* inv, const double* vol,
+                           size_t n, HJBResult* out);
+
+void hjb_cleanup();
+
+// Handle-based API. Each engine owns its own Verilated model and context, so
+// separate engines can be driven from separate threads; a single engine must
+// only be used by one thread at a time.
+typedef struct HJBEngine HJBEngine;
+
+HJBEngine* hjb_create();
+void hjb_destroy(HJBEngine* engine);
+int hjb_engine_calculate(HJBEngine* engine, double mid_price, int32_t inventory,
+                         double volatility, HJBResult* result);
+size_t hjb_engine_calculate_batch(HJBEngine* engine, const double* mid, const int32_t* inv,
+                                  const double* vol, size_t n, HJBResult* out);
+
+// Engine pool: num_workers threads, each owning one engine. A batch is split
+// into num_workers contiguous symbol shards that are priced in parallel.
+// Worker w is pinned to CPU w when pin_threads is non-zero. Returns the index
+// of the first quote that did not complete (n on success).
+typedef struct HJBPool HJBPool;
+
+HJBPool* hjb_pool_create(size_t num_workers, int pin_threads);
+void hjb_pool_destroy(HJBPool* pool);
+size_t hjb_pool_calculate_batch(HJBPool* pool, const double* mid, const int32_t* inv,
+                                const double* vol, size_t n, HJBResult* out);
+
+// Streaming API over hjb_calculator_pipelined. Requests are issued one per
+// clock and results matched back by tag, so a batch of n quotes costs about
+// n + pipeline depth cycles. n must fit in the 32-bit tag. Same threading
+// rules as HJBEngine.
+typedef struct HJBStreamEngine HJBStreamEngine;
+
+HJBStreamEngine* hjb_stream_create();
+void hjb_stream_destroy(HJBStreamEngine* engine);
+size_t hjb_stream_calculate_batch(HJBStreamEngine* engine, const double* mid, const int32_t* inv,
+                                  const double* vol, size_t n, HJBResult* out);
+
+// Fixed-point streaming API over hjb_calculator_fixed, which evaluates the
+// Avellaneda-Stoikov quotes in Q32.32 instead of the bit-pattern
+// approximation of the IEEE 754 cores. gamma and kappa are fixed at creation;
+// each batch is converted to Q32.32 in one pass before it is streamed and the
+// quotes back to double in one pass after. Mid prices must stay below 2^31.
+// Same tag and threading rules as HJBStreamEngine.
+typedef struct HJBFixedEngine HJBFixedEngine;
+
+HJBFixedEngine* hjb_fixed_create(double gamma, double kappa);
+void hjb_fixed_destroy(HJBFixedEngine* engine);
+size_t hjb_fixed_calculate_batch(HJBFixedEngine* engine, const double* mid, const int32_t* inv,
+                                 const double* vol, size_t n, HJBResult* out);
+
+// Native C++ model of hjb_calculator (hjb_model.cpp), vectorised with
+// AVX2/AVX-512 when available. Bit-identical to the RTL; returns n.
+size_t hjb_calculate_native_batch(const double* mid, const int32_t* inv, const double* vol,
+                                  size_t n, HJBResult* out);
+
+// Runs the batch through both the Verilated core on engine and the native
+// model, leaving the RTL results in out. Returns the number of quotes whose
+// bid or ask bit patterns differ and prints the first few to stderr. Quotes
+// the RTL failed to produce are not compared; their count goes to *timeouts
+// when timeouts is not NULL.
+size_t hjb_crosscheck_batch(HJBEngine* engine, const double* mid, const int32_t* inv,
+                            const double* vol, size_t n, HJBResult* out, size_t* timeouts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HJB_WRAPPER_H
@@ -0,0 +1,241 @@
+// Fixed-Point HJB Optimal Quote Calculator
+// Streaming Avellaneda-Stoikov quotes in Q32.32 on the same valid/ready and
+// tag interface as hjb_calculator_pipelined. Unlike the IEEE 754 cores,
+// which approximate the quotes with integer operations on the raw bit
+// patterns, this core evaluates the model terms:
+//   reservation r = s - q * gamma * sigma^2
+//   spread      d = gamma * sigma^2 + (2 / gamma) * ln(1 + gamma / kappa)
+//   quotes        r -/+ d / 2
+// All prices and parameters are signed Q32.32 (value * 2^32); inventory is
+// a signed integer. The horizon T - t is normalised to 1, so sigma is the
+// volatility over the quoting horizon.
+//
+// gamma, 2/gamma and 1/kappa come in as configuration so the datapath needs
+// no divider; they are sampled with each request, so a change takes effect
+// from the next request accepted. Every product is a registered 64x64 (or
+// 32x64 for the inventory skew) multiply that maps onto a DSP cascade, and
+// ln is a 257-entry LUT over the mantissa with linear interpolation plus
+// exponent * ln 2, accurate to about 2e-6.
+module hjb_calculator_fixed #(
+    parameter TAG_WIDTH = 32
+) (
+    input  wire                 clk,
+    input  wire                 rst_n,
+
+    // Model parameters, Q32.32
+    input  wire [63:0]          cfg_gamma,          // risk aversion
+    input  wire [63:0]          cfg_two_over_gamma, // 2 / gamma
+    input  wire [63:0]          cfg_inv_kappa,      // 1 / order arrival decay
+
+    // Request stream
+    input  wire                 in_valid,
+    output wire                 in_ready,
+    input  wire [63:0]          in_mid_price,       // Q32.32
+    input  wire [31:0]          in_inventory,       // Signed inventory
+    input  wire [63:0]          in_volatility,      // Q32.32
+    input  wire [TAG_WIDTH-1:0] in_tag,
+
+    // Result stream
+    output reg                  out_valid,
+    input  wire                 out_ready,
+    output reg  [63:0]          out_bid,            // Q32.32
+    output reg  [63:0]          out_ask,            // Q32.32
+    output reg  [TAG_WIDTH-1:0] out_tag,
+
+    output wire [31:0]          latency_cycles
+);
+
+    localparam PIPELINE_DEPTH = 5;
+    localparam LUT_BITS = 8;
+    localparam LUT_SIZE = 1 << LUT_BITS;
+    localparam FRAC_BITS = 63 - LUT_BITS - 31;  // interpolation bits below the LUT index
+
+    localparam [63:0] ONE = 64'h0000_0001_0000_0000;
+    localparam [63:0] LN2 = 64'h0000_0000_B172_17F8;
+
+    // The whole pipeline advances together; it only holds when the result
+    // register is full and the consumer is not taking it
+    wire advance = !out_valid || out_ready;
+
+    assign in_ready = advance;
+    assign latency_cycles = PIPELINE_DEPTH;
+
+    // Signed Q32.32 product; the low 128 bits of the sign-extended product
+    function [63:0] mul_q;
+        input [63:0] a;
+        input [63:0] b;
+        reg [127:0] product;
+        begin
+            product = {{64{a[63]}}, a} * {{64{b[63]}}, b};
+            mul_q = product[95:32];
+        end
+    endfunction
+
+    function [5:0] msb_index;
+        input [63:0] value;
+        integer b;
+        begin
+            msb_index = 6'd0;
+            for (b = 0; b < 64; b = b + 1) begin
+                if (value[b]) msb_index = b[5:0];
+            end
+        end
+    endfunction
+
+    // ln(1 + i / LUT_SIZE) in Q0.32. Built from two 16-bit halves because
+    // $rtoi returns a 32-bit signed integer.
+    reg [31:0] ln_lut [0:LUT_SIZE];
+    integer lut_i, lut_hi, lut_lo;
+    real lut_value;
+
+    initial begin
+        for (lut_i = 0; lut_i <= LUT_SIZE; lut_i = lut_i + 1) begin
+            lut_value = $ln(1.0 + lut_i / (1.0 * LUT_SIZE)) * 65536.0;
+            lut_hi = $rtoi(lut_value);
+            lut_lo = $rtoi((lut_value - lut_hi) * 65536.0);
+            ln_lut[lut_i] = {lut_hi[15:0], lut_lo[15:0]};
+        end
+    end
+
+    // Stage 1: sigma^2 and gamma / kappa
+    reg                 s1_valid;
+    reg signed [63:0]   s1_mid;
+    reg signed [31:0]   s1_inventory;
+    reg signed [63:0]   s1_sigma2;
+    reg signed [63:0]   s1_ratio;
+    reg signed [63:0]   s1_gamma;
+    reg signed [63:0]   s1_two_over_gamma;
+    reg [TAG_WIDTH-1:0] s1_tag;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            s1_valid <= 1'b0;
+            s1_mid <= 64'h0;
+            s1_inventory <= 32'h0;
+            s1_sigma2 <= 64'h0;
+            s1_ratio <= 64'h0;
+            s1_gamma <= 64'h0;
+            s1_two_over_gamma <= 64'h0;
+            s1_tag <= {TAG_WIDTH{1'b0}};
+        end else if (advance) begin
+            s1_valid <= in_valid;
+            s1_mid <= in_mid_price;
+            s1_inventory <= in_inventory;
+            s1_sigma2 <= mul_q(in_volatility, in_volatility);
+            s1_ratio <= mul_q(cfg_gamma, cfg_inv_kappa);
+            s1_gamma <= cfg_gamma;
+            s1_two_over_gamma <= cfg_two_over_gamma;
+            s1_tag <= in_tag;
+        end
+    end
+
+    // Stage 2: gamma * sigma^2, and 1 + gamma / kappa normalised to
+    // 2^exponent * 1.m for the ln LUT
+    wire [63:0] log_arg = ONE + s1_ratio;
+    wire [5:0]  log_msb = msb_index(log_arg);
+    wire [63:0] log_norm = log_arg << (6'd63 - log_msb);
+
+    reg                 s2_valid;
+    reg signed [63:0]   s2_mid;
+    reg signed [31:0]   s2_inventory;
+    reg signed [63:0]   s2_gs2;
+    reg [5:0]           s2_exponent;
+    reg [LUT_BITS-1:0]  s2_index;
+    reg [FRAC_BITS-1:0] s2_frac;
+    reg signed [63:0]   s2_two_over_gamma;
+    reg [TAG_WIDTH-1:0] s2_tag;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            s2_valid <= 1'b0;
+            s2_mid <= 64'h0;
+            s2_inventory <= 32'h0;
+            s2_gs2 <= 64'h0;
+            s2_exponent <= 6'h0;
+            s2_index <= {LUT_BITS{1'b0}};
+            s2_frac <= {FRAC_BITS{1'b0}};
+            s2_two_over_gamma <= 64'h0;
+            s2_tag <= {TAG_WIDTH{1'b0}};
+        end else if (advance) begin
+            s2_valid <= s1_valid;
+            s2_mid <= s1_mid;
+            s2_inventory <= s1_inventory;
+            s2_gs2 <= mul_q(s1_gamma, s1_sigma2);
+            s2_exponent <= log_msb - 6'd32;
+            s2_index <= log_norm[62 -: LUT_BITS];
+            s2_frac <= log_norm[62 - LUT_BITS -: FRAC_BITS];
+            s2_two_over_gamma <= s1_two_over_gamma;
+            s2_tag <= s1_tag;
+        end
+    end
+
+    // Stage 3: ln(1 + gamma / kappa) and the inventory skew q * gamma * sigma^2
+    wire [31:0] ln_base = ln_lut[s2_index];
+    wire [31:0] ln_next = ln_lut[{1'b0, s2_index} + 9'd1];
+    wire [55:0] ln_step = {24'h0, ln_next - ln_base} * {32'h0, s2_frac};
+    wire [63:0] ln_value = {58'h0, s2_exponent} * LN2 + {32'h0, ln_base} + {8'h0, ln_step >> FRAC_BITS};
+
+    reg                 s3_valid;
+    reg signed [63:0]   s3_mid;
+    reg signed [63:0]   s3_skew;
+    reg signed [63:0]   s3_gs2;
+    reg signed [63:0]   s3_ln;
+    reg signed [63:0]   s3_two_over_gamma;
+    reg [TAG_WIDTH-1:0] s3_tag;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            s3_valid <= 1'b0;
+            s3_mid <= 64'h0;
+            s3_skew <= 64'h0;
+            s3_gs2 <= 64'h0;
+            s3_ln <= 64'h0;
+            s3_two_over_gamma <= 64'h0;
+            s3_tag <= {TAG_WIDTH{1'b0}};
+        end else if (advance) begin
+            s3_valid <= s2_valid;
+            s3_mid <= s2_mid;
+            s3_skew <= {{32{s2_inventory[31]}}, s2_inventory} * s2_gs2;
+            s3_gs2 <= s2_gs2;
+            s3_ln <= ln_value;
+            s3_two_over_gamma <= s2_two_over_gamma;
+            s3_tag <= s2_tag;
+        end
+    end
+
+    // Stage 4: reservation price and spread
+    reg                 s4_valid;
+    reg signed [63:0]   s4_reservation;
+    reg signed [63:0]   s4_spread;
+    reg [TAG_WIDTH-1:0] s4_tag;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            s4_valid <= 1'b0;
+            s4_reservation <= 64'h0;
+            s4_spread <= 64'h0;
+            s4_tag <= {TAG_WIDTH{1'b0}};
+        end else if (advance) begin
+            s4_valid <= s3_valid;
+            s4_reservation <= s3_mid - s3_skew;
+            s4_spread <= s3_gs2 + mul_q(s3_two_over_gamma, s3_ln);
+            s4_tag <= s3_tag;
+        end
+    end
+
+    // Stage 5: quotes
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            out_valid <= 1'b0;
+            out_bid <= 64'h0;
+            out_ask <= 64'h0;
+            out_tag <= {TAG_WIDTH{1'b0}};
+        end else if (advance) begin
+            out_valid <= s4_valid;
+            out_bid <= s4_reservation - (s4_spread >>> 1);
+            out_ask <= s4_reservation + (s4_spread >>> 1);
+            out_tag <= s4_tag;
+        end
+    end
+
+endmodule
@@ -0,0 +1,74 @@
+// Pipelined HJB Optimal Quote Calculator
+// Streaming variant of hjb_calculator: accepts one request per clock on a
+// valid/ready interface and returns one quote per clock, in order, carrying
+// the request tag. Arithmetic matches hjb_calculator bit for bit.
+module hjb_calculator_pipelined #(
+    parameter TAG_WIDTH = 32
+) (
+    input  wire                 clk,
+    input  wire                 rst_n,
+
+    // Request stream
+    input  wire                 in_valid,
+    output wire                 in_ready,
+    input  wire [63:0]          in_mid_price,     // IEEE 754 double precision
+    input  wire [31:0]          in_inventory,     // Signed inventory
+    input  wire [63:0]          in_volatility,    // IEEE 754 double precision
+    input  wire [TAG_WIDTH-1:0] in_tag,
+
+    // Result stream
+    output reg                  out_valid,
+    input  wire                 out_ready,
+    output reg  [63:0]          out_bid,          // IEEE 754 double precision
+    output reg  [63:0]          out_ask,          // IEEE 754 double precision
+    output reg  [TAG_WIDTH-1:0] out_tag,
+
+    output wire [31:0]          latency_cycles
+);
+
+    localparam PIPELINE_DEPTH = 2;
+
+    // The whole pipeline advances together; it only holds when the result
+    // register is full and the consumer is not taking it
+    wire advance = !out_valid || out_ready;
+
+    assign in_ready = advance;
+    assign latency_cycles = PIPELINE_DEPTH;
+
+    // Stage 1: reservation price and half spread
+    reg                 s1_valid;
+    reg [63:0]          s1_reservation;
+    reg [63:0]          s1_half_spread;
+    reg [TAG_WIDTH-1:0] s1_tag;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            s1_valid <= 1'b0;
+            s1_reservation <= 64'h0;
+            s1_half_spread <= 64'h0;
+            s1_tag <= {TAG_WIDTH{1'b0}};
+        end else if (advance) begin
+            s1_valid <= in_valid;
+            // Same approximations as hjb_calculator CALC_RESERVATION/CALC_SPREAD
+            s1_reservation <= in_mid_price - ({32'h0, in_inventory} << 10);
+            s1_half_spread <= (in_mid_price >> 7) >> 1;
+            s1_tag <= in_tag;
+        end
+    end
+
+    // Stage 2: quotes
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            out_valid <= 1'b0;
+            out_bid <= 64'h0;
+            out_ask <= 64'h0;
+            out_tag <= {TAG_WIDTH{1'b0}};
+        end else if (advance) begin
+            out_valid <= s1_valid;
+            out_bid <= s1_reservation - s1_half_spread;
+            out_ask <= s1_reservation + s1_half_spread;
+            out_tag <= s1_tag;
+        end
+    end
+
+endmodule
@@ -0,0 +1,149 @@
+/*
+ * Latency Histogram Module
+ * On-chip tick-to-trade latency distribution, read over a register interface
+ *
+ * Features:
+ * - HDR-style buckets: latencies below 2^SUB_BUCKET_BITS cycles are counted
+ *   exactly; above that each power of two is split into
+ *   2^(SUB_BUCKET_BITS-1) linear buckets, so the bucket width never exceeds
+ *   2^-(SUB_BUCKET_BITS-1) of its value (the same layout as the C++
+ *   LatencyHistogram with precision_bits = SUB_BUCKET_BITS)
+ * - One sample per cycle with no backpressure
+ * - Exact sample count, minimum, maximum and 64-bit sum beside the buckets
+ * - Synchronous clear
+ *
+ * Register map (32-bit words; reg_rd_data is valid the cycle after reg_rd_en):
+ *   0x00 .. BUCKETS-1   bucket counts (saturating)
+ *   0xF0                {SUB_BUCKET_BITS[7:0], LATENCY_WIDTH[7:0], BUCKETS[15:0]}
+ *   0xF1                samples
+ *   0xF2                minimum latency (0xFFFFFFFF while empty)
+ *   0xF3                maximum latency
+ *   0xF4 / 0xF5         latency sum, low / high word
+ *   0xF6                samples at or above 2^LATENCY_WIDTH, counted in the top bucket
+ * BUCKETS = 2^SUB_BUCKET_BITS + (LATENCY_WIDTH - SUB_BUCKET_BITS) * 2^(SUB_BUCKET_BITS-1)
+ * must stay below 0xF0 (112 for the defaults).
+ */
+
+module latency_histogram #(
+    parameter LATENCY_WIDTH = 16,           // bucketed range 0 .. 2^LATENCY_WIDTH-1 cycles, up to 31
+    parameter SUB_BUCKET_BITS = 4           // >= 2
+) (
+    input  wire         clk,
+    input  wire         rst_n,
+    input  wire         clear,
+
+    // Latency samples
+    input  wire         sample_valid,
+    input  wire [31:0]  sample_latency,     // cycles
+
+    // Register read interface
+    input  wire         reg_rd_en,
+    input  wire [7:0]   reg_addr,
+    output reg          reg_rd_valid,
+    output reg  [31:0]  reg_rd_data
+);
+
+localparam SUB_COUNT = 1 << SUB_BUCKET_BITS;
+localparam SUB_HALF = SUB_COUNT >> 1;
+localparam BUCKETS = SUB_COUNT + (LATENCY_WIDTH - SUB_BUCKET_BITS) * SUB_HALF;
+localparam [31:0] CONFIG_WORD = (SUB_BUCKET_BITS << 24) | (LATENCY_WIDTH << 16) | BUCKETS;
+
+// Register addresses
+localparam REG_CONFIG = 8'hF0;
+localparam REG_SAMPLES = 8'hF1;
+localparam REG_MIN = 8'hF2;
+localparam REG_MAX = 8'hF3;
+localparam REG_SUM_LO = 8'hF4;
+localparam REG_SUM_HI = 8'hF5;
+localparam REG_CLAMPED = 8'hF6;
+
+reg [31:0] bucket_count [0:BUCKETS-1];
+reg [31:0] sample_counter;
+reg [31:0] min_latency;
+reg [31:0] max_latency;
+reg [63:0] latency_sum;
+reg [31:0] clamp_counter;
+integer i;
+
+// Bucket of a latency: exact below SUB_COUNT, else the top SUB_BUCKET_BITS
+// bits below and including the leading one select the bucket
+function [7:0] bucket_of;
+    input [31:0] latency;
+    reg [LATENCY_WIDTH-1:0] value;
+    integer b, top;
+    begin
+        value = (latency >> LATENCY_WIDTH) != 0 ? {LATENCY_WIDTH{1'b1}} : latency[LATENCY_WIDTH-1:0];
+        if (value < SUB_COUNT) begin
+            bucket_of = value[7:0];
+        end else begin
+            top = 0;
+            for (b = 0; b < LATENCY_WIDTH; b = b + 1) begin
+                if (value[b]) top = b;
+            end
+            bucket_of = SUB_COUNT + (top - SUB_BUCKET_BITS) * SUB_HALF +
+                        ((value >> (top - SUB_BUCKET_BITS + 1)) - SUB_HALF);
+        end
+    end
+endfunction
+
+wire [7:0] sample_bucket = bucket_of(sample_latency);
+wire sample_clamped = (sample_latency >> LATENCY_WIDTH) != 0;
+
+// Recording: one read-modify-write of one bucket per cycle
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        for (i = 0; i < BUCKETS; i = i + 1) begin
+            bucket_count[i] <= 32'b0;
+        end
+        sample_counter <= 32'b0;
+        min_latency <= 32'hFFFFFFFF;
+        max_latency <= 32'b0;
+        latency_sum <= 64'b0;
+        clamp_counter <= 32'b0;
+
+    end else if (clear) begin
+        for (i = 0; i < BUCKETS; i = i + 1) begin
+            bucket_count[i] <= 32'b0;
+        end
+        sample_counter <= 32'b0;
+        min_latency <= 32'hFFFFFFFF;
+        max_latency <= 32'b0;
+        latency_sum <= 64'b0;
+        clamp_counter <= 32'b0;
+
+    end else if (sample_valid) begin
+        if (bucket_count[sample_bucket] != 32'hFFFFFFFF) begin
+            bucket_count[sample_bucket] <= bucket_count[sample_bucket] + 1;
+        end
+        sample_counter <= sample_counter + 1;
+        latency_sum <= latency_sum + sample_latency;
+        if (sample_latency < min_latency) min_latency <= sample_latency;
+        if (sample_latency > max_latency) max_latency <= sample_latency;
+        if (sample_clamped) clamp_counter <= clamp_counter + 1;
+    end
+end
+
+// Register reads
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        reg_rd_valid <= 1'b0;
+        reg_rd_data <= 32'b0;
+    end else begin
+        reg_rd_valid <= reg_rd_en;
+
+        if (reg_rd_en) begin
+            case (reg_addr)
+                REG_CONFIG:  reg_rd_data <= CONFIG_WORD;
+                REG_SAMPLES: reg_rd_data <= sample_counter;
+                REG_MIN:     reg_rd_data <= min_latency;
+                REG_MAX:     reg_rd_data <= max_latency;
+                REG_SUM_LO:  reg_rd_data <= latency_sum[31:0];
+                REG_SUM_HI:  reg_rd_data <= latency_sum[63:32];
+                REG_CLAMPED: reg_rd_data <= clamp_counter;
+                default:     reg_rd_data <= (reg_addr < BUCKETS) ? bucket_count[reg_addr] : 32'b0;
+            endcase
+        end
+    end
+end
+
+endmodule
@@ -4,9 +4,14 @@
  * 
  * Features:
  * - ITCH/FIX protocol parsing
+ * - Multi-beat ITCH 5.0 Add/Execute/Cancel/Delete/Replace messages
+ *   (big-endian bytes, 8 per 64-bit beat, data_last on the final beat)
  * - Real-time order book updates
  * - Sub-microsecond latency
- * - Pipelined architecture
+ * - Fully pipelined: one beat accepted every cycle with no backpressure,
+ *   results PIPELINE_STAGES cycles after the last beat of each message
+ * - Ingress timestamping: ingress_time is the timebase value on the cycle
+ *   the message's first beat was accepted, and travels with its tick
  */
 
 `timescale 1ns / 1ps
@@ -26,9 +31,13 @@ module market_data_processor #(
     // Input market data stream
     input  wire                     data_valid,
     input  wire [DATA_WIDTH-1:0]    data_in,
-    input  wire [7:0]               data_type,      // ITCH message type
+    input  wire [7:0]               data_type,      // ITCH message type (first beat)
+    input  wire                     data_last,      // last beat of the message
     output wire                     data_ready,
     
+    // Free-running system cycle counter shared with the downstream modules
+    input  wire [63:0]              timebase,
+    
     // Parsed market data output
     output reg                      tick_valid,
     output reg  [SYMBOL_WIDTH-1:0]  symbol,
@@ -37,6 +46,7 @@ module market_data_processor #(
     output reg  [PRICE_WIDTH-1:0]   bid,
     output reg  [PRICE_WIDTH-1:0]   ask,
     output reg  [63:0]              timestamp,
+    output reg  [63:0]              ingress_time,   // timebase at the message's first beat
     
     // Order book interface
     output reg                      book_update_valid,
@@ -55,24 +65,44 @@ module market_data_processor #(
 // Internal registers
 reg [31:0] packet_counter;
 reg [31:0] error_counter;
-reg [DATA_WIDTH-1:0] data_buffer;
-reg [7:0] current_msg_type;
-reg [2:0] parse_state;
-reg [15:0] msg_length;
-reg [15:0] bytes_processed;
-
-// Pipeline registers for latency optimization
-reg [DATA_WIDTH-1:0] pipeline_stage1;
-reg [DATA_WIDTH-1:0] pipeline_stage2;
-reg [DATA_WIDTH-1:0] pipeline_stage3;
-reg valid_stage1, valid_stage2, valid_stage3;
-
-// ITCH message parsing state machine
-localparam IDLE = 3'b000;
-localparam HEADER = 3'b001;
-localparam PAYLOAD = 3'b010;
-localparam VALIDATE = 3'b011;
-localparam OUTPUT = 3'b100;
+
+// Multi-beat ITCH message assembly. A message that ends on its first beat is
+// the compact format {symbol, price}; anything longer is raw ITCH 5.0 with
+// byte 0 (message type) in data_in[63:56] of the first beat.
+localparam MSG_BEATS = 5;                       // longest supported message: 40 bytes
+localparam MSG_BITS = MSG_BEATS * 64;
+localparam ORDER_IDX_BITS = $clog2(MAX_ORDERS);
+
+// Last beat to tick_valid/book_update_valid: stage 1 holds the complete
+// message, stage 2 is the decoded output register
+localparam PIPELINE_STAGES = 2;
+
+// Stage 0: beats of the message still being received
+reg [MSG_BITS-1:0] asm_buf;
+reg [3:0] asm_beats;                            // beats received so far, 0 = between messages
+reg asm_overflow;
+reg [7:0] asm_type;
+reg [63:0] asm_time;
+
+// Stage 1: one complete message
+reg s1_valid;
+reg [MSG_BITS-1:0] s1_buf;
+reg [3:0] s1_beats;
+reg s1_overflow;
+reg s1_itch;
+reg [7:0] s1_type;
+reg [63:0] s1_time;
+
+// Order reference table (direct-mapped on the low reference bits): ITCH
+// Execute/Cancel/Delete/Replace carry only the order reference, so symbol,
+// price and side come from the Add that created the order. Read and
+// written in the same stage, so the next message always sees the update.
+reg                     ot_valid [0:MAX_ORDERS-1];
+reg [31:0]              ot_tag [0:MAX_ORDERS-1];
+reg [SYMBOL_WIDTH-1:0]  ot_symbol [0:MAX_ORDERS-1];
+reg [PRICE_WIDTH-1:0]   ot_price [0:MAX_ORDERS-1];
+reg                     ot_side [0:MAX_ORDERS-1];
+integer i;
 
 // ITCH message types
 localparam MSG_ADD_ORDER = 8'h41;           // 'A'
@@ -80,160 +110,233 @@ localparam MSG_EXECUTE_ORDER = 8'h45;       // 'E'
 localparam MSG_CANCEL_ORDER = 8'h58;        // 'X'
 localparam MSG_DELETE_ORDER = 8'h44;        // 'D'
 localparam MSG_REPLACE_ORDER = 8'h55;       // 'U'
+localparam MSG_ADD_ORDER_MPID = 8'h46;      // 'F'
+localparam MSG_EXECUTE_PRICE = 8'h43;       // 'C'
+
+// ITCH 5.0 message lengths in bytes; 0 = not handled by this block
+function [5:0] itch_length;
+    input [7:0] msg_type;
+    begin
+        case (msg_type)
+            MSG_ADD_ORDER:      itch_length = 6'd36;
+            MSG_ADD_ORDER_MPID: itch_length = 6'd40;
+            MSG_EXECUTE_ORDER:  itch_length = 6'd31;
+            MSG_EXECUTE_PRICE:  itch_length = 6'd36;
+            MSG_CANCEL_ORDER:   itch_length = 6'd23;
+            MSG_DELETE_ORDER:   itch_length = 6'd19;
+            MSG_REPLACE_ORDER:  itch_length = 6'd35;
+            default:            itch_length = 6'd0;
+        endcase
+    end
+endfunction
+
+// Field at byte offset OFF of the message in stage 1, LEN bytes, big-endian
+`define ITCH_FIELD(OFF, LEN) s1_buf[MSG_BITS-1-8*(OFF) -: 8*(LEN)]
+
+// The message with the current beat in place; a first beat starts from zero
+reg [MSG_BITS-1:0] asm_next;
+always @(*) begin
+    asm_next = (asm_beats == 4'd0) ? {MSG_BITS{1'b0}} : asm_buf;
+    if (asm_beats < MSG_BEATS) begin
+        asm_next[MSG_BITS-1-64*asm_beats -: 64] = data_in;
+    end
+end
 
-// Internal wires
-wire [PRICE_WIDTH-1:0] extracted_price;
-wire [VOLUME_WIDTH-1:0] extracted_volume;
-wire [SYMBOL_WIDTH-1:0] extracted_symbol;
-wire [31:0] extracted_order_ref;
-wire parse_complete;
-wire parse_error;
+// Stage 1 validation and order lookup
+wire [5:0] itch_expected_len = itch_length(s1_type);
+wire [3:0] itch_expected_beats = (itch_expected_len + 6'd7) >> 3;
+wire itch_supported = (itch_expected_len != 6'd0);
+wire [63:0] itch_order_ref = `ITCH_FIELD(11, 8);
+wire [ORDER_IDX_BITS-1:0] lookup_idx = itch_order_ref[ORDER_IDX_BITS-1:0];
+wire lookup_hit = ot_valid[lookup_idx] && (ot_tag[lookup_idx] == itch_order_ref[31:0]);
+wire itch_needs_lookup = (s1_type != MSG_ADD_ORDER) && (s1_type != MSG_ADD_ORDER_MPID);
+wire [63:0] itch_new_ref = `ITCH_FIELD(19, 8);    // Replace only
+wire [ORDER_IDX_BITS-1:0] replace_idx = itch_new_ref[ORDER_IDX_BITS-1:0];
 
-// Pipeline control
-assign data_ready = (parse_state == IDLE) || (parse_state == OUTPUT);
-assign pipeline_depth = 16'd3;  // 3-stage pipeline
+// Wrong beat count for the message type, or an Execute/Cancel/Delete/Replace
+// for an order reference we never saw added
+wire parse_error = s1_itch && itch_supported &&
+                   (s1_overflow || s1_beats != itch_expected_beats ||
+                    (itch_needs_lookup && !lookup_hit));
+
+// Compact single-beat messages {symbol, price}
+wire [SYMBOL_WIDTH-1:0] compact_symbol = s1_buf[MSG_BITS-1 -: 32];
+wire [PRICE_WIDTH-1:0] compact_price = s1_buf[MSG_BITS-33 -: 32];
+wire compact_supported = (s1_type == MSG_ADD_ORDER) || (s1_type == MSG_EXECUTE_ORDER) ||
+                         (s1_type == MSG_CANCEL_ORDER);
+
+// No backpressure: every stage advances every cycle
+assign data_ready = 1'b1;
+assign pipeline_depth = PIPELINE_STAGES;
 
 // Statistics outputs
 assign packets_processed = packet_counter;
 assign parse_errors = error_counter;
 
-// Clock domain logic
+// Stage 0: message assembly, one beat per cycle. The last beat hands the
+// message to stage 1 and the next message may start on the following cycle.
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        asm_beats <= 4'b0;
+        asm_overflow <= 1'b0;
+        s1_valid <= 1'b0;
+    end else begin
+        s1_valid <= 1'b0;
+        
+        if (data_valid) begin
+            if (asm_beats == 4'd0) begin
+                asm_type <= data_type;
+                asm_time <= timebase;
+            end
+            
+            if (data_last) begin
+                s1_valid <= 1'b1;
+                s1_buf <= asm_next;
+                s1_beats <= asm_beats + 4'd1;
+                s1_overflow <= asm_overflow || (asm_beats >= MSG_BEATS);
+                s1_itch <= (asm_beats != 4'd0);
+                s1_type <= (asm_beats == 4'd0) ? data_type : asm_type;
+                s1_time <= (asm_beats == 4'd0) ? timebase : asm_time;
+                asm_beats <= 4'd0;
+                asm_overflow <= 1'b0;
+            end else begin
+                asm_buf <= asm_next;
+                if (asm_beats >= MSG_BEATS) asm_overflow <= 1'b1;
+                if (asm_beats != 4'hE) asm_beats <= asm_beats + 4'd1;
+            end
+        end
+    end
+end
+
+// Stage 1 -> 2: decode, update the order table and register the outputs
 always @(posedge clk or negedge rst_n) begin
     if (!rst_n) begin
-        // Reset all registers
         packet_counter <= 32'b0;
         error_counter <= 32'b0;
-        parse_state <= IDLE;
-        msg_length <= 16'b0;
-        bytes_processed <= 16'b0;
         tick_valid <= 1'b0;
         book_update_valid <= 1'b0;
-        
-        // Pipeline reset
-        pipeline_stage1 <= {DATA_WIDTH{1'b0}};
-        pipeline_stage2 <= {DATA_WIDTH{1'b0}};
-        pipeline_stage3 <= {DATA_WIDTH{1'b0}};
-        valid_stage1 <= 1'b0;
-        valid_stage2 <= 1'b0;
-        valid_stage3 <= 1'b0;
+        for (i = 0; i < MAX_ORDERS; i = i + 1) begin
+            ot_valid[i] <= 1'b0;
+        end
         
     end else begin
-        // Pipeline advancement
-        pipeline_stage1 <= data_in;
-        pipeline_stage2 <= pipeline_stage1;
-        pipeline_stage3 <= pipeline_stage2;
-        valid_stage1 <= data_valid;
-        valid_stage2 <= valid_stage1;
-        valid_stage3 <= valid_stage2;
+        tick_valid <= 1'b0;
+        book_update_valid <= 1'b0;
+        if (s1_valid) begin
+            ingress_time <= s1_time;
+        end
         
-        // Main parsing state machine
-        case (parse_state)
-            IDLE: begin
-                tick_valid <= 1'b0;
-                book_update_valid <= 1'b0;
-                
-                if (data_valid) begin
-                    data_buffer <= data_in;
-                    current_msg_type <= data_type;
-                    // For single-packet messages, go directly to processing
-                    case (data_type)
-                        MSG_ADD_ORDER, MSG_EXECUTE_ORDER, MSG_CANCEL_ORDER: begin
-                            parse_state <= OUTPUT;
-                        end
-                        default: begin
-                            // Invalid message type - stay in IDLE state
-                            // Error will be flagged in OUTPUT state
-                            parse_state <= OUTPUT;
-                        end
-                    endcase
-                    bytes_processed <= 16'b1;
-                end
-            end
-            
-            VALIDATE: begin
-                // Validate parsed data
-                if (parse_error) begin
-                    error_counter <= error_counter + 1;
-                    parse_state <= IDLE;
-                end else begin
-                    parse_state <= OUTPUT;
-                end
-            end
-            
-            OUTPUT: begin
-                // Output parsed data
+        if (s1_valid && s1_itch) begin
+            if (!itch_supported) begin
+                // Well-formed ITCH traffic this block does not act on
+                // (system events, stock directory, trades...)
                 packet_counter <= packet_counter + 1;
+            end else if (parse_error) begin
+                error_counter <= error_counter + 1;
+            end else begin
+                packet_counter <= packet_counter + 1;
+                tick_valid <= 1'b1;
+                book_update_valid <= 1'b1;
+                timestamp <= {16'b0, `ITCH_FIELD(5, 6)};  // ns since midnight
                 
-                // Generate tick output only for valid message types
-                if (current_msg_type == MSG_ADD_ORDER || 
-                    current_msg_type == MSG_EXECUTE_ORDER || 
-                    current_msg_type == MSG_CANCEL_ORDER) begin
+                case (s1_type)
+                    MSG_ADD_ORDER, MSG_ADD_ORDER_MPID: begin
+                        emit_itch(`ITCH_FIELD(24, 4), `ITCH_FIELD(32, 4), `ITCH_FIELD(20, 4),
+                                  (`ITCH_FIELD(19, 1) == 8'h53), 3'b000);  // 'S' = sell
+                        
+                        ot_valid[lookup_idx] <= 1'b1;
+                        ot_tag[lookup_idx] <= itch_order_ref[31:0];
+                        ot_symbol[lookup_idx] <= `ITCH_FIELD(24, 4);   // first 4 characters of Stock
+                        ot_price[lookup_idx] <= `ITCH_FIELD(32, 4);
+                        ot_side[lookup_idx] <= (`ITCH_FIELD(19, 1) == 8'h53);
+                    end
                     
-                    tick_valid <= 1'b1;
-                    symbol <= data_buffer[63:32];  // Extract symbol from upper 32 bits
-                    price <= data_buffer[31:0];    // Extract price from lower 32 bits
-                    volume <= 32'h1000;            // Default volume
-                    timestamp <= $time;
+                    MSG_EXECUTE_ORDER, MSG_EXECUTE_PRICE: begin
+                        emit_itch(ot_symbol[lookup_idx],
+                                  (s1_type == MSG_EXECUTE_PRICE) ? `ITCH_FIELD(32, 4) : ot_price[lookup_idx],
+                                  `ITCH_FIELD(19, 4), ot_side[lookup_idx], 3'b001);
+                    end
                     
-                    // Calculate bid/ask spread
-                    bid <= data_buffer[31:0];                    // Use price as bid
-                    ask <= data_buffer[31:0] + 32'h100;         // Add spread for ask
+                    MSG_CANCEL_ORDER: begin
+                        emit_itch(ot_symbol[lookup_idx], ot_price[lookup_idx], `ITCH_FIELD(19, 4),
+                                  ot_side[lookup_idx], 3'b010);
+                    end
                     
-                    // Generate order book update
-                    book_update_valid <= 1'b1;
-                    book_symbol <= data_buffer[63:32];
-                    book_price <= data_buffer[31:0];
-                    book_volume <= 32'h1000;
-                    book_side <= (current_msg_type == MSG_ADD_ORDER) ? 1'b0 : 1'b1;
-                    book_action <= (current_msg_type == MSG_ADD_ORDER) ? 3'b000 : 
-                                  (current_msg_type == MSG_EXECUTE_ORDER) ? 3'b001 : 3'b010;
-                end else begin
-                    // Invalid message type, increment error counter
-                    error_counter <= error_counter + 1;
-                    tick_valid <= 1'b0;
-                    book_update_valid <= 1'b0;
-                end
-                
-                parse_state <= IDLE;
+                    MSG_DELETE_ORDER: begin
+                        emit_itch(ot_symbol[lookup_idx], ot_price[lookup_idx], 32'b0,
+                                  ot_side[lookup_idx], 3'b010);
+                        tick_valid <= 1'b0;  // book update only
+                        ot_valid[lookup_idx] <= 1'b0;
+                    end
+                    
+                    default: begin  // MSG_REPLACE_ORDER
+                        emit_itch(ot_symbol[lookup_idx], `ITCH_FIELD(31, 4), `ITCH_FIELD(27, 4),
+                                  ot_side[lookup_idx], 3'b001);
+                        
+                        // The order moves to its new reference
+                        ot_valid[lookup_idx] <= 1'b0;
+                        ot_valid[replace_idx] <= 1'b1;
+                        ot_tag[replace_idx] <= itch_new_ref[31:0];
+                        ot_symbol[replace_idx] <= ot_symbol[lookup_idx];
+                        ot_price[replace_idx] <= `ITCH_FIELD(31, 4);
+                        ot_side[replace_idx] <= ot_side[lookup_idx];
+                    end
+                endcase
             end
             
-            default: begin
-                parse_state <= IDLE;
+        end else if (s1_valid) begin
+            packet_counter <= packet_counter + 1;
+            
+            // Generate tick output only for valid message types
+            if (compact_supported) begin
+                tick_valid <= 1'b1;
+                symbol <= compact_symbol;
+                price <= compact_price;
+                volume <= 32'h1000;            // Default volume
+                timestamp <= $time;
+                
+                // Calculate bid/ask spread
+                bid <= compact_price;                       // Use price as bid
+                ask <= compact_price + 32'h100;             // Add spread for ask
+                
+                // Generate order book update
+                book_update_valid <= 1'b1;
+                book_symbol <= compact_symbol;
+                book_price <= compact_price;
+                book_volume <= 32'h1000;
+                book_side <= (s1_type == MSG_ADD_ORDER) ? 1'b0 : 1'b1;
+                book_action <= (s1_type == MSG_ADD_ORDER) ? 3'b000 : 
+                              (s1_type == MSG_EXECUTE_ORDER) ? 3'b001 : 3'b010;
+            end else begin
+                // Invalid message type, increment error counter
+                error_counter <= error_counter + 1;
             end
-        endcase
+        end
     end
 end
 
-// Data extraction logic (combinational)
-assign extracted_price = pipeline_stage3[31:0];
-assign extracted_volume = pipeline_stage2[31:0];
-assign extracted_symbol = pipeline_stage1[31:0];
-assign extracted_order_ref = pipeline_stage3[63:32];
-
-// Parse completion detection
-assign parse_complete = (parse_state == VALIDATE) && !parse_error;
-
-// Error detection logic
-assign parse_error = 1'b0;  // Simplified for single-packet messages
-
-// Bid/Ask calculation (simplified)
-always @(*) begin
-    case (current_msg_type)
-        MSG_ADD_ORDER: begin
-            if (book_side == 1'b0) begin  // Buy order
-                bid = extracted_price;
-                ask = extracted_price + 32'd1;  // Simplified spread
-            end else begin  // Sell order
-                ask = extracted_price;
-                bid = extracted_price - 32'd1;
-            end
-        end
+// Tick and book outputs for a decoded ITCH message
+task emit_itch;
+    input [SYMBOL_WIDTH-1:0] t_symbol;
+    input [PRICE_WIDTH-1:0]  t_price;
+    input [VOLUME_WIDTH-1:0] t_volume;
+    input                    t_side;
+    input [2:0]              t_action;
+    begin
+        symbol <= t_symbol;
+        price <= t_price;
+        volume <= t_volume;
+        bid <= t_side ? t_price - 32'h100 : t_price;
+        ask <= t_side ? t_price : t_price + 32'h100;
         
-        default: begin
-            bid = 32'b0;
-            ask = 32'b0;
-        end
-    endcase
-end
+        book_symbol <= t_symbol;
+        book_price <= t_price;
+        book_volume <= t_volume;
+        book_side <= t_side;
+        book_action <= t_action;
+    end
+endtask
+
+`undef ITCH_FIELD
 
 endmodule
@@ -0,0 +1,418 @@
+/*
+ * Wide Market Data Ingest
+ * 256/512-bit variant of market_data_processor for 10/25/100G feeds
+ *
+ * Features:
+ * - AXI-Stream style input: byte 0 of a beat in tdata[7:0], tkeep marks
+ *   the valid bytes (contiguous from byte 0), tlast ends a packet
+ * - The stream carries MoldUDP64 message blocks, [length:2][ITCH 5.0
+ *   message] repeated, big-endian; a message may straddle beats
+ * - Up to LANES messages framed and decoded per cycle from one alignment
+ *   buffer, results presented side by side in stream order
+ * - ITCH 5.0 Add/Execute/Cancel/Delete/Replace decoding against a shared
+ *   order reference table, with forwarding between lanes of one cycle
+ */
+
+`timescale 1ns / 1ps
+
+module market_data_processor_wide #(
+    parameter DATA_WIDTH = 512,                     // 256 or 512
+    parameter LANES = 4,                            // messages decoded per cycle
+    parameter SYMBOL_WIDTH = 32,
+    parameter PRICE_WIDTH = 32,
+    parameter VOLUME_WIDTH = 32,
+    parameter MAX_ORDERS = 1024
+) (
+    input  wire                     clk,
+    input  wire                     rst_n,
+
+    // AXI-Stream market data input
+    input  wire                     s_axis_tvalid,
+    output wire                     s_axis_tready,
+    input  wire [DATA_WIDTH-1:0]    s_axis_tdata,
+    input  wire [DATA_WIDTH/8-1:0]  s_axis_tkeep,
+    input  wire                     s_axis_tlast,   // end of packet
+
+    // Parsed output, lane k at [k*WIDTH +: WIDTH]; lane 0 is oldest
+    output reg  [LANES-1:0]              lane_valid,     // book update
+    output reg  [LANES-1:0]              lane_tick,      // also a market tick
+    output reg  [LANES*SYMBOL_WIDTH-1:0] lane_symbol,
+    output reg  [LANES*PRICE_WIDTH-1:0]  lane_price,
+    output reg  [LANES*VOLUME_WIDTH-1:0] lane_volume,
+    output reg  [LANES-1:0]              lane_side,      // 0=buy, 1=sell
+    output reg  [LANES*3-1:0]            lane_action,    // 0=add, 1=modify, 2=delete
+    output reg  [LANES*48-1:0]           lane_timestamp, // ns since midnight
+
+    // Statistics
+    output wire [31:0]              packets_processed,  // messages, as in market_data_processor
+    output wire [31:0]              parse_errors,
+    output wire [63:0]              bytes_received,
+    output wire [15:0]              pipeline_depth
+);
+
+localparam BEAT_BYTES = DATA_WIDTH / 8;
+localparam BUF_BYTES = 3 * BEAT_BYTES;              // a beat plus the unparsed tail
+localparam FILL_BITS = $clog2(BUF_BYTES + 1);
+localparam KEEP_BITS = $clog2(BEAT_BYTES + 1);
+localparam WINDOW_BYTES = 40;                       // longest decoded message ('F')
+localparam MAX_ITCH_BYTES = 50;                     // longest ITCH 5.0 message ('I')
+localparam ORDER_IDX_BITS = $clog2(MAX_ORDERS);
+
+// Beat accepted -> framed and decoded -> registered lane outputs
+localparam PIPELINE_STAGES = 2;
+
+// ITCH message types
+localparam MSG_ADD_ORDER = 8'h41;           // 'A'
+localparam MSG_EXECUTE_ORDER = 8'h45;       // 'E'
+localparam MSG_CANCEL_ORDER = 8'h58;        // 'X'
+localparam MSG_DELETE_ORDER = 8'h44;        // 'D'
+localparam MSG_REPLACE_ORDER = 8'h55;       // 'U'
+localparam MSG_ADD_ORDER_MPID = 8'h46;      // 'F'
+localparam MSG_EXECUTE_PRICE = 8'h43;       // 'C'
+
+// ITCH 5.0 message lengths in bytes; 0 = not handled by this block
+function [5:0] itch_length;
+    input [7:0] msg_type;
+    begin
+        case (msg_type)
+            MSG_ADD_ORDER:      itch_length = 6'd36;
+            MSG_ADD_ORDER_MPID: itch_length = 6'd40;
+            MSG_EXECUTE_ORDER:  itch_length = 6'd31;
+            MSG_EXECUTE_PRICE:  itch_length = 6'd36;
+            MSG_CANCEL_ORDER:   itch_length = 6'd23;
+            MSG_DELETE_ORDER:   itch_length = 6'd19;
+            MSG_REPLACE_ORDER:  itch_length = 6'd35;
+            default:            itch_length = 6'd0;
+        endcase
+    end
+endfunction
+
+// Big-endian field of a message window (byte 0 in bits [7:0])
+function [31:0] be32;
+    input [WINDOW_BYTES*8-1:0] window;
+    input integer offset;
+    begin
+        be32 = {window[8*offset +: 8], window[8*(offset+1) +: 8],
+                window[8*(offset+2) +: 8], window[8*(offset+3) +: 8]};
+    end
+endfunction
+
+function [7:0] count_ones;
+    input [BEAT_BYTES-1:0] bits;
+    input integer width;
+    integer b;
+    begin
+        count_ones = 8'd0;
+        for (b = 0; b < width; b = b + 1) begin
+            count_ones = count_ones + bits[b];
+        end
+    end
+endfunction
+
+// Alignment buffer: unparsed stream bytes, oldest in bits [7:0]. Bytes at
+// and above fill are always zero, so a new beat is ORed in at fill.
+reg [BUF_BYTES*8-1:0] sbuf;
+reg [FILL_BITS-1:0] fill;
+
+// End of the most recent packet inside the buffer, where framing resumes
+// after an error; without one, the stream is dropped up to the next tlast
+reg [FILL_BITS-1:0] last_end;
+reg last_end_valid;
+reg discard;
+
+reg [31:0] packet_counter;
+reg [31:0] error_counter;
+reg [63:0] byte_counter;
+
+// Order reference table (direct-mapped on the low reference bits), as in
+// market_data_processor
+reg                     ot_valid [0:MAX_ORDERS-1];
+reg [31:0]              ot_tag [0:MAX_ORDERS-1];
+reg [SYMBOL_WIDTH-1:0]  ot_symbol [0:MAX_ORDERS-1];
+reg [PRICE_WIDTH-1:0]   ot_price [0:MAX_ORDERS-1];
+reg                     ot_side [0:MAX_ORDERS-1];
+integer i;
+
+assign s_axis_tready = (fill <= BUF_BYTES - BEAT_BYTES);
+assign pipeline_depth = PIPELINE_STAGES;
+assign packets_processed = packet_counter;
+assign parse_errors = error_counter;
+assign bytes_received = byte_counter;
+
+// Framing: walk the length prefixes from the front of the buffer. Lane k
+// takes the k-th complete message; the walk stops at the first message
+// that is not complete yet.
+integer fk, foff, flen;
+reg fchain;
+reg [LANES-1:0] frame_ok;
+reg [LANES*FILL_BITS-1:0] frame_start;             // first message byte
+reg [LANES*6-1:0] frame_len;
+reg [FILL_BITS-1:0] consumed;
+reg framing_error;
+
+always @(*) begin
+    foff = 0;
+    fchain = 1'b1;
+    frame_ok = {LANES{1'b0}};
+    frame_start = {(LANES*FILL_BITS){1'b0}};
+    frame_len = {(LANES*6){1'b0}};
+    framing_error = 1'b0;
+    for (fk = 0; fk < LANES; fk = fk + 1) begin
+        flen = 0;
+        if (fchain && foff + 2 <= fill) begin
+            flen = {sbuf[8*foff +: 8], sbuf[8*(foff+1) +: 8]};
+        end
+        if (!fchain || foff + 2 > fill) begin
+            fchain = 1'b0;
+        end else if (flen == 0 || flen > MAX_ITCH_BYTES) begin
+            // Lost framing; only acted on once it reaches lane 0
+            if (fk == 0) framing_error = 1'b1;
+            fchain = 1'b0;
+        end else if (foff + 2 + flen > fill) begin
+            fchain = 1'b0;
+        end else begin
+            frame_ok[fk] = 1'b1;
+            frame_start[fk*FILL_BITS +: FILL_BITS] = foff + 2;
+            frame_len[fk*6 +: 6] = flen;
+            foff = foff + 2 + flen;
+        end
+    end
+    consumed = foff;
+end
+
+// Per-lane message windows and raw fields
+wire [LANES*8-1:0] msg_type;
+wire [LANES-1:0] msg_supported;
+wire [LANES-1:0] msg_length_ok;
+wire [LANES*32-1:0] msg_ref;                       // order reference, low 32 bits
+wire [LANES*32-1:0] msg_new_ref;                   // Replace only
+wire [LANES*SYMBOL_WIDTH-1:0] msg_symbol;          // Add only
+wire [LANES*PRICE_WIDTH-1:0] msg_price;            // Add, Execute with price, Replace
+wire [LANES*VOLUME_WIDTH-1:0] msg_volume;
+wire [LANES-1:0] msg_side;                         // Add only
+wire [LANES*48-1:0] msg_timestamp;
+
+genvar g;
+generate
+    for (g = 0; g < LANES; g = g + 1) begin : lane_window
+        wire [BUF_BYTES*8-1:0] aligned = sbuf >> (8 * frame_start[g*FILL_BITS +: FILL_BITS]);
+        wire [WINDOW_BYTES*8-1:0] window = aligned[WINDOW_BYTES*8-1:0];
+        wire [7:0] mtype = window[7:0];
+        wire [5:0] expected = itch_length(mtype);
+
+        assign msg_type[g*8 +: 8] = mtype;
+        assign msg_supported[g] = (expected != 6'd0);
+        assign msg_length_ok[g] = (frame_len[g*6 +: 6] == expected);
+        assign msg_ref[g*32 +: 32] = be32(window, 15);
+        assign msg_new_ref[g*32 +: 32] = be32(window, 23);
+        assign msg_symbol[g*SYMBOL_WIDTH +: SYMBOL_WIDTH] = be32(window, 24);
+        assign msg_price[g*PRICE_WIDTH +: PRICE_WIDTH] =
+            (mtype == MSG_REPLACE_ORDER) ? be32(window, 31) : be32(window, 32);
+        assign msg_volume[g*VOLUME_WIDTH +: VOLUME_WIDTH] =
+            (mtype == MSG_ADD_ORDER || mtype == MSG_ADD_ORDER_MPID) ? be32(window, 20) :
+            (mtype == MSG_REPLACE_ORDER) ? be32(window, 27) :
+            (mtype == MSG_DELETE_ORDER) ? 32'b0 : be32(window, 19);
+        assign msg_side[g] = (window[8*19 +: 8] == 8'h53);   // 'S'
+        assign msg_timestamp[g*48 +: 48] = {be32(window, 5), window[8*9 +: 8], window[8*10 +: 8]};
+    end
+endgenerate
+
+// Order lookups, in lane order: each lane sees the table as updated by
+// the lanes before it in the same cycle
+integer rk, rj;
+reg [ORDER_IDX_BITS-1:0] r_idx;
+reg e_valid, e_side;
+reg [31:0] e_tag;
+reg [SYMBOL_WIDTH-1:0] e_symbol;
+reg [PRICE_WIDTH-1:0] e_price;
+reg [7:0] r_type;
+reg [LANES-1:0] r_ok;                               // decoded, updates the book
+reg [LANES-1:0] r_error;
+reg [LANES-1:0] r_skip;                             // well-formed but not handled
+reg [LANES-1:0] r_tick;
+reg [LANES-1:0] r_side;
+reg [LANES*SYMBOL_WIDTH-1:0] r_symbol;
+reg [LANES*PRICE_WIDTH-1:0] r_price;
+reg [LANES*3-1:0] r_action;
+
+always @(*) begin
+    r_ok = {LANES{1'b0}};
+    r_error = {LANES{1'b0}};
+    r_skip = {LANES{1'b0}};
+    r_tick = {LANES{1'b0}};
+    r_side = {LANES{1'b0}};
+    r_symbol = {(LANES*SYMBOL_WIDTH){1'b0}};
+    r_price = {(LANES*PRICE_WIDTH){1'b0}};
+    r_action = {(LANES*3){1'b0}};
+
+    for (rk = 0; rk < LANES; rk = rk + 1) begin
+        r_type = msg_type[rk*8 +: 8];
+        r_idx = msg_ref[rk*32 +: ORDER_IDX_BITS];
+        e_valid = ot_valid[r_idx];
+        e_tag = ot_tag[r_idx];
+        e_symbol = ot_symbol[r_idx];
+        e_price = ot_price[r_idx];
+        e_side = ot_side[r_idx];
+
+        // Replay the earlier lanes' writes to this entry
+        for (rj = 0; rj < rk; rj = rj + 1) begin
+            if (r_ok[rj]) begin
+                case (msg_type[rj*8 +: 8])
+                    MSG_ADD_ORDER, MSG_ADD_ORDER_MPID: begin
+                        if (msg_ref[rj*32 +: ORDER_IDX_BITS] == r_idx) begin
+                            e_valid = 1'b1;
+                            e_tag = msg_ref[rj*32 +: 32];
+                            e_symbol = r_symbol[rj*SYMBOL_WIDTH +: SYMBOL_WIDTH];
+                            e_price = r_price[rj*PRICE_WIDTH +: PRICE_WIDTH];
+                            e_side = r_side[rj];
+                        end
+                    end
+                    MSG_DELETE_ORDER: begin
+                        if (msg_ref[rj*32 +: ORDER_IDX_BITS] == r_idx) e_valid = 1'b0;
+                    end
+                    MSG_REPLACE_ORDER: begin
+                        if (msg_ref[rj*32 +: ORDER_IDX_BITS] == r_idx) e_valid = 1'b0;
+                        if (msg_new_ref[rj*32 +: ORDER_IDX_BITS] == r_idx) begin
+                            e_valid = 1'b1;
+                            e_tag = msg_new_ref[rj*32 +: 32];
+                            e_symbol = r_symbol[rj*SYMBOL_WIDTH +: SYMBOL_WIDTH];
+                            e_price = r_price[rj*PRICE_WIDTH +: PRICE_WIDTH];
+                            e_side = r_side[rj];
+                        end
+                    end
+                    default: begin
+                    end
+                endcase
+            end
+        end
+
+        if (frame_ok[rk]) begin
+            if (!msg_supported[rk]) begin
+                r_skip[rk] = 1'b1;
+            end else if (!msg_length_ok[rk]) begin
+                r_error[rk] = 1'b1;
+            end else if (r_type == MSG_ADD_ORDER || r_type == MSG_ADD_ORDER_MPID) begin
+                r_ok[rk] = 1'b1;
+                r_tick[rk] = 1'b1;
+                r_symbol[rk*SYMBOL_WIDTH +: SYMBOL_WIDTH] = msg_symbol[rk*SYMBOL_WIDTH +: SYMBOL_WIDTH];
+                r_price[rk*PRICE_WIDTH +: PRICE_WIDTH] = msg_price[rk*PRICE_WIDTH +: PRICE_WIDTH];
+                r_side[rk] = msg_side[rk];
+                r_action[rk*3 +: 3] = 3'b000;
+            end else if (!(e_valid && e_tag == msg_ref[rk*32 +: 32])) begin
+                r_error[rk] = 1'b1;                 // unknown order reference
+            end else begin
+                r_ok[rk] = 1'b1;
+                r_tick[rk] = (r_type != MSG_DELETE_ORDER);
+                r_symbol[rk*SYMBOL_WIDTH +: SYMBOL_WIDTH] = e_symbol;
+                r_price[rk*PRICE_WIDTH +: PRICE_WIDTH] =
+                    (r_type == MSG_EXECUTE_PRICE || r_type == MSG_REPLACE_ORDER) ?
+                    msg_price[rk*PRICE_WIDTH +: PRICE_WIDTH] : e_price;
+                r_side[rk] = e_side;
+                r_action[rk*3 +: 3] = (r_type == MSG_CANCEL_ORDER || r_type == MSG_DELETE_ORDER) ? 3'b010 :
+                                      3'b001;
+            end
+        end
+    end
+end
+
+// Incoming beat with the bytes outside tkeep cleared
+wire [DATA_WIDTH-1:0] beat_data;
+wire [KEEP_BITS-1:0] beat_bytes = count_ones(s_axis_tkeep, BEAT_BYTES);
+
+generate
+    for (g = 0; g < BEAT_BYTES; g = g + 1) begin : beat_mask
+        assign beat_data[8*g +: 8] = s_axis_tkeep[g] ? s_axis_tdata[8*g +: 8] : 8'b0;
+    end
+endgenerate
+
+// On a framing error the buffer is dropped up to the last packet end
+wire [FILL_BITS-1:0] drop = framing_error ? (last_end_valid ? last_end : fill) : consumed;
+wire [FILL_BITS-1:0] fill_after = fill - drop;
+wire [BUF_BYTES*8-1:0] sbuf_after = sbuf >> (8 * drop);
+wire accept = s_axis_tvalid && s_axis_tready;
+
+integer wk;
+
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        sbuf <= {(BUF_BYTES*8){1'b0}};
+        fill <= {FILL_BITS{1'b0}};
+        last_end_valid <= 1'b0;
+        discard <= 1'b0;
+        packet_counter <= 32'b0;
+        error_counter <= 32'b0;
+        byte_counter <= 64'b0;
+        lane_valid <= {LANES{1'b0}};
+        lane_tick <= {LANES{1'b0}};
+        for (i = 0; i < MAX_ORDERS; i = i + 1) begin
+            ot_valid[i] <= 1'b0;
+        end
+
+    end else begin
+        // Buffer: drop what was framed (or lost), append the new beat
+        sbuf <= sbuf_after;
+        fill <= fill_after;
+        last_end <= last_end - drop;
+        if (last_end_valid && last_end <= drop) last_end_valid <= 1'b0;
+        if (framing_error && !last_end_valid) discard <= 1'b1;
+
+        if (accept) begin
+            byte_counter <= byte_counter + beat_bytes;
+            if (discard || (framing_error && !last_end_valid)) begin
+                if (s_axis_tlast) discard <= 1'b0;
+            end else begin
+                sbuf <= sbuf_after | ({{(BUF_BYTES*8-DATA_WIDTH){1'b0}}, beat_data} << (8 * fill_after));
+                fill <= fill_after + beat_bytes;
+                if (s_axis_tlast) begin
+                    last_end <= fill_after + beat_bytes;
+                    last_end_valid <= 1'b1;
+                end
+            end
+        end
+
+        // Statistics, counted per message as in market_data_processor
+        packet_counter <= packet_counter + count_ones(r_ok | r_skip, LANES);
+        error_counter <= error_counter + count_ones(r_error, LANES) + framing_error;
+
+        // Lane outputs
+        lane_valid <= r_ok;
+        lane_tick <= r_tick;
+        lane_symbol <= r_symbol;
+        lane_price <= r_price;
+        lane_side <= r_side;
+        lane_action <= r_action;
+        lane_volume <= msg_volume;
+        lane_timestamp <= msg_timestamp;
+
+        // Order table writes in lane order, so the last write to an entry wins
+        for (wk = 0; wk < LANES; wk = wk + 1) begin
+            if (r_ok[wk]) begin
+                case (msg_type[wk*8 +: 8])
+                    MSG_ADD_ORDER, MSG_ADD_ORDER_MPID: begin
+                        ot_valid[msg_ref[wk*32 +: ORDER_IDX_BITS]] <= 1'b1;
+                        ot_tag[msg_ref[wk*32 +: ORDER_IDX_BITS]] <= msg_ref[wk*32 +: 32];
+                        ot_symbol[msg_ref[wk*32 +: ORDER_IDX_BITS]] <= r_symbol[wk*SYMBOL_WIDTH +: SYMBOL_WIDTH];
+                        ot_price[msg_ref[wk*32 +: ORDER_IDX_BITS]] <= r_price[wk*PRICE_WIDTH +: PRICE_WIDTH];
+                        ot_side[msg_ref[wk*32 +: ORDER_IDX_BITS]] <= r_side[wk];
+                    end
+                    MSG_DELETE_ORDER: begin
+                        ot_valid[msg_ref[wk*32 +: ORDER_IDX_BITS]] <= 1'b0;
+                    end
+                    MSG_REPLACE_ORDER: begin
+                        // The order moves to its new reference
+                        ot_valid[msg_ref[wk*32 +: ORDER_IDX_BITS]] <= 1'b0;
+                        ot_valid[msg_new_ref[wk*32 +: ORDER_IDX_BITS]] <= 1'b1;
+                        ot_tag[msg_new_ref[wk*32 +: ORDER_IDX_BITS]] <= msg_new_ref[wk*32 +: 32];
+                        ot_symbol[msg_new_ref[wk*32 +: ORDER_IDX_BITS]] <= r_symbol[wk*SYMBOL_WIDTH +: SYMBOL_WIDTH];
+                        ot_price[msg_new_ref[wk*32 +: ORDER_IDX_BITS]] <= r_price[wk*PRICE_WIDTH +: PRICE_WIDTH];
+                        ot_side[msg_new_ref[wk*32 +: ORDER_IDX_BITS]] <= r_side[wk];
+                    end
+                    default: begin
+                    end
+                endcase
+            end
+        end
+    end
+end
+
+endmodule
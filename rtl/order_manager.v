@@ -3,10 +3,29 @@
  * Hardware-accelerated order processing and risk management
  * 
  * Features:
- * - Order state machine with 16ns latency
- * - Pre-trade risk checks
+ * - Two-stage pipeline taking a new order every cycle: an input FIFO,
+ *   then check, match and commit; an order executes on the cycle after it
+ *   arrives when nothing is queued ahead of it
+ * - valid/ready order input: the FIFO absorbs bursts while downstream
+ *   holds exec_ready low, and order_ready drops only when it is full;
+ *   peak occupancy and full-FIFO offers are counted
+ * - Pre-trade risk checks in parallel with matching: per-symbol net
+ *   position after the fill, notional, max order size and an order-rate
+ *   token bucket; a reject squashes the order's book update and execution
  * - Order matching engine
- * - Position tracking
+ * - Hashed order-ID index and per-symbol price-level book:
+ *   add, cancel and execute are O(1) at any book depth
+ * - Position tracking; a symbol's slot is released once its position is
+ *   flat and it has no resting orders, so the table holds the symbols in
+ *   play rather than every symbol ever seen
+ * - Tick-to-trade latency: each order carries its tick's ingress time and
+ *   every execution reports the cycles since then on exec_latency
+ *
+ * The order index, symbol index and price-level table are set-associative
+ * hash tables. A lookup hashes the key to one set and compares its
+ * BOOK_WAYS entries in parallel, i.e. a small CAM per set over banked RAM,
+ * so the cost does not grow with the number of resting orders or symbols.
+ * Each table must have at least two sets.
  */
 
 module order_manager #(
@@ -14,8 +33,11 @@ module order_manager #(
     parameter SYMBOL_WIDTH = 32,
     parameter PRICE_WIDTH = 32,
     parameter VOLUME_WIDTH = 32,
-    parameter MAX_ORDERS = 1024,
-    parameter MAX_POSITIONS = 256
+    parameter MAX_ORDERS = 1024,            // resting orders, up to 65536
+    parameter MAX_POSITIONS = 256,          // symbols tracked, up to 4096
+    parameter MAX_LEVELS = MAX_ORDERS,      // price levels over all symbols and sides
+    parameter BOOK_WAYS = 4,                // associativity of each hash table
+    parameter ORDER_FIFO_DEPTH = 4          // input FIFO, power of two >= 2
 ) (
     input  wire                     clk,
     input  wire                     rst_n,
@@ -27,9 +49,13 @@ module order_manager #(
     input  wire [PRICE_WIDTH-1:0]   order_price,
     input  wire [VOLUME_WIDTH-1:0]  order_volume,
     input  wire                     order_side,        // 0=buy, 1=sell
-    input  wire [2:0]               order_type,        // 0=market, 1=limit, 2=cancel
+    input  wire [2:0]               order_type,        // 0=market, 1=limit, 2=cancel, 3=execute resting
     input  wire [31:0]              order_id,           // Order ID input
-    output wire                     order_ready,
+    input  wire [63:0]              order_tick_time,    // ingress time of the triggering tick
+    output wire                     order_ready,        // an order is taken on valid && ready
+    
+    // Free-running system cycle counter, the time base of order_tick_time
+    input  wire [63:0]              timebase,
     
     // Market data interface
     input  wire                     tick_valid,
@@ -38,14 +64,18 @@ module order_manager #(
     input  wire [PRICE_WIDTH-1:0]   tick_bid,
     input  wire [PRICE_WIDTH-1:0]   tick_ask,
     
-    // Order execution output
+    // Order execution output, held until exec_ready
     output reg                      exec_valid,
     output reg  [ORDER_WIDTH-1:0]   exec_order_id,
     output reg  [SYMBOL_WIDTH-1:0]  exec_symbol,
     output reg  [PRICE_WIDTH-1:0]   exec_price,
     output reg  [VOLUME_WIDTH-1:0]  exec_volume,
     output reg                      exec_side,
-    output reg  [63:0]              exec_timestamp,
+    output reg  [63:0]              exec_timestamp,     // timebase at execution
+    output reg  [63:0]              exec_tick_time,     // ingress time of the order's tick
+    output reg  [31:0]              exec_latency,       // exec_timestamp - exec_tick_time, saturating
+    output reg                      exec_latency_valid, // one-cycle pulse per execution
+    input  wire                     exec_ready,         // tie high if every execution is taken
     
     // Position updates
     output reg                      pos_update_valid,
@@ -54,8 +84,11 @@ module order_manager #(
     output reg                      pos_side,
     
     // Risk management interface
-    input  wire [PRICE_WIDTH-1:0]   risk_position_limit,
+    input  wire [PRICE_WIDTH-1:0]   risk_position_limit, // max |net position| per symbol after a fill
     input  wire [PRICE_WIDTH-1:0]   risk_max_order_size,
+    input  wire [PRICE_WIDTH+VOLUME_WIDTH-1:0] risk_max_notional, // max price * volume per order
+    input  wire [15:0]              risk_rate_burst,     // new orders allowed back to back
+    input  wire [31:0]              risk_rate_interval,  // cycles per refilled order, 0 = no throttle
     input  wire                     risk_enabled,
     output wire                     risk_violation,
     
@@ -64,10 +97,13 @@ module order_manager #(
     output wire [31:0]              orders_filled,
     output wire [31:0]              orders_rejected,
     output wire [15:0]              active_orders,
+    output wire [15:0]              order_fifo_peak,    // most orders queued at once
+    output wire [31:0]              order_fifo_stall_cycles, // cycles an order waited on a full FIFO; none is dropped
+    output wire [31:0]              symbol_table_rejects, // new orders rejected with no free symbol slot
     
     // Additional outputs
-    output wire [31:0]              risk_code,          // Risk code output
-    output wire [31:0]              execution_status,   // Execution status output
+    output wire [31:0]              risk_code,          // last risk reject: 1=position, 2=size, 3=notional, 4=rate
+    output wire [31:0]              execution_status,   // 1 after an execution, 2 after a reject
     output wire [31:0]              position_pnl       // Position PnL output
 );
 
@@ -75,271 +111,486 @@ module order_manager #(
 reg [31:0] order_counter;
 reg [31:0] fill_counter;
 reg [31:0] reject_counter;
-reg [15:0] active_order_count;
+
+// Book geometry
+localparam ORDER_IDX_BITS = $clog2(MAX_ORDERS);
+localparam ORDER_SET_BITS = $clog2(MAX_ORDERS / BOOK_WAYS);
+localparam SYMBOL_IDX_BITS = $clog2(MAX_POSITIONS);
+localparam SYMBOL_SET_BITS = $clog2(MAX_POSITIONS / BOOK_WAYS);
+localparam LEVEL_IDX_BITS = $clog2(MAX_LEVELS);
+localparam LEVEL_SET_BITS = $clog2(MAX_LEVELS / BOOK_WAYS);
+
+reg [ORDER_IDX_BITS:0] active_order_count;
 
 // Loop variable for initialization
 integer i;
 
-// Order state machine
-localparam ORDER_IDLE = 3'b000;
-localparam ORDER_VALIDATE = 3'b001;
-localparam ORDER_RISK_CHECK = 3'b010;
-localparam ORDER_MATCH = 3'b011;
-localparam ORDER_EXECUTE = 3'b100;
-localparam ORDER_REJECT = 3'b101;
-localparam ORDER_COMPLETE = 3'b110;
-
-reg [2:0] order_state;
-reg [2:0] next_order_state;
-
-// Order storage (simplified - in real implementation would use CAM/TCAM)
-reg [ORDER_WIDTH-1:0]   order_memory [0:MAX_ORDERS-1];
-reg [SYMBOL_WIDTH-1:0]  order_symbols [0:MAX_ORDERS-1];
-reg [PRICE_WIDTH-1:0]   order_prices [0:MAX_ORDERS-1];
-reg [VOLUME_WIDTH-1:0]  order_volumes [0:MAX_ORDERS-1];
-reg                     order_sides [0:MAX_ORDERS-1];
-reg [2:0]               order_types [0:MAX_ORDERS-1];
-reg                     order_valid_flags [0:MAX_ORDERS-1];
-reg [9:0]               order_write_ptr;
-reg [9:0]               order_read_ptr;
-
-// Position tracking
-reg [VOLUME_WIDTH-1:0]  positions [0:MAX_POSITIONS-1];
-reg [SYMBOL_WIDTH-1:0]  position_symbols [0:MAX_POSITIONS-1];
-reg [7:0]               position_count;
-
-// Current order being processed
+// Order types
+localparam TYPE_MARKET = 3'b000;
+localparam TYPE_LIMIT = 3'b001;
+localparam TYPE_CANCEL = 3'b010;
+localparam TYPE_EXECUTE = 3'b011;
+
+// Risk reject reasons reported on risk_code
+localparam RISK_POSITION = 32'd1;
+localparam RISK_SIZE = 32'd2;
+localparam RISK_NOTIONAL = 32'd3;
+localparam RISK_RATE = 32'd4;
+
+// Resting orders, indexed by hash of the order ID
+reg                         ord_valid [0:MAX_ORDERS-1];
+reg [31:0]                  ord_id [0:MAX_ORDERS-1];
+reg [SYMBOL_IDX_BITS-1:0]   ord_slot [0:MAX_ORDERS-1];
+reg [LEVEL_IDX_BITS-1:0]    ord_level [0:MAX_ORDERS-1];
+reg [PRICE_WIDTH-1:0]       ord_price [0:MAX_ORDERS-1];
+reg [VOLUME_WIDTH-1:0]      ord_volume [0:MAX_ORDERS-1];
+reg                         ord_side [0:MAX_ORDERS-1];
+
+// Symbol slots, indexed by hash of the symbol; a slot also indexes the
+// symbol's net position (two's complement, buys positive) and counts the
+// symbol's resting orders
+reg                         sym_valid [0:MAX_POSITIONS-1];
+reg [SYMBOL_WIDTH-1:0]      sym_key [0:MAX_POSITIONS-1];
+reg [VOLUME_WIDTH-1:0]      positions [0:MAX_POSITIONS-1];
+reg [ORDER_IDX_BITS:0]      sym_orders [0:MAX_POSITIONS-1];
+reg [SYMBOL_IDX_BITS:0]     position_count;
+reg [31:0]                  sym_reject_counter;
+
+// Price levels: resting volume and order count per (symbol, side, price)
+reg                         lvl_valid [0:MAX_LEVELS-1];
+reg [SYMBOL_IDX_BITS-1:0]   lvl_slot [0:MAX_LEVELS-1];
+reg                         lvl_side [0:MAX_LEVELS-1];
+reg [PRICE_WIDTH-1:0]       lvl_price [0:MAX_LEVELS-1];
+reg [VOLUME_WIDTH-1:0]      lvl_volume [0:MAX_LEVELS-1];
+reg [ORDER_IDX_BITS:0]      lvl_orders [0:MAX_LEVELS-1];
+
+// Stage 0: input FIFO. An order that arrives while the FIFO is empty and
+// stage 1 is advancing goes straight to stage 1.
+localparam FIFO_BITS = $clog2(ORDER_FIFO_DEPTH);
+
+reg [31:0]              fifo_id [0:ORDER_FIFO_DEPTH-1];
+reg [SYMBOL_WIDTH-1:0]  fifo_symbol [0:ORDER_FIFO_DEPTH-1];
+reg [PRICE_WIDTH-1:0]   fifo_price [0:ORDER_FIFO_DEPTH-1];
+reg [VOLUME_WIDTH-1:0]  fifo_volume [0:ORDER_FIFO_DEPTH-1];
+reg                     fifo_side [0:ORDER_FIFO_DEPTH-1];
+reg [2:0]               fifo_type [0:ORDER_FIFO_DEPTH-1];
+reg [63:0]              fifo_tick_time [0:ORDER_FIFO_DEPTH-1];
+reg [FIFO_BITS:0]       fifo_wr, fifo_rd;
+reg [FIFO_BITS:0]       fifo_peak;
+reg [31:0]              fifo_stall_counter;
+
+wire [FIFO_BITS:0] fifo_level = fifo_wr - fifo_rd;
+wire [FIFO_BITS-1:0] fifo_head = fifo_rd[FIFO_BITS-1:0];
+wire fifo_empty = (fifo_level == 0);
+
+// Stage 1: the order being checked and matched this cycle
+reg                     current_valid;
 reg [ORDER_WIDTH-1:0]   current_order;
 reg [SYMBOL_WIDTH-1:0]  current_symbol;
 reg [PRICE_WIDTH-1:0]   current_price;
 reg [VOLUME_WIDTH-1:0]  current_volume;
 reg                     current_side;
 reg [2:0]               current_type;
+reg [63:0]              current_tick_time;
+
+// Cycles from the edge that accepted the tick to the edge raising exec_valid
+wire [63:0] tick_age = timebase - current_tick_time;
 
 // Risk check results
 wire risk_position_ok;
 wire risk_size_ok;
+wire risk_notional_ok;
+wire risk_rate_ok;
 wire risk_all_ok;
 
 // Matching engine
 wire match_found;
-wire [PRICE_WIDTH-1:0] match_price;
-wire [VOLUME_WIDTH-1:0] match_volume;
 
-// Pipeline timing
-reg [3:0] pipeline_counter;
+// Order-rate throttle: a token bucket of risk_rate_burst orders, refilled
+// one order every risk_rate_interval cycles
+reg [15:0] rate_tokens;
+reg [31:0] rate_timer;
+
+// Sticky signals for testbench visibility
+reg risk_violation_sticky;
+reg [31:0] risk_code_reg;
+reg [31:0] status_reg;
 
 // Statistics outputs
 assign orders_processed = order_counter;
 assign orders_filled = fill_counter;
 assign orders_rejected = reject_counter;
-assign active_orders = active_order_count;
+assign active_orders = (active_order_count > 16'hFFFF) ? 16'hFFFF : active_order_count[15:0];
 
-// Order ready signal
-assign order_ready = (order_state == ORDER_IDLE) || (order_state == ORDER_COMPLETE);
+// Stage 1 finishes in one cycle, so the FIFO only fills while exec_ready
+// holds an execution on the output
+assign order_ready = (fifo_level != ORDER_FIFO_DEPTH);
+assign order_fifo_peak = {{(15 - FIFO_BITS){1'b0}}, fifo_peak};
+assign order_fifo_stall_cycles = fifo_stall_counter;
+assign symbol_table_rejects = sym_reject_counter;
 
 // Risk violation output
 assign risk_violation = risk_violation_sticky;
 
-// Risk code logic
-assign risk_code = !risk_position_ok ? 32'd1 :
-                   !risk_size_ok     ? 32'd2 : 32'd0;
+// Reason for the most recent risk reject
+assign risk_code = risk_code_reg;
 
-// Execution status logic
-assign execution_status = (order_state == ORDER_EXECUTE) ? 32'd1 :
-                         (order_state == ORDER_REJECT)  ? 32'd2 : 32'd0;
+// Execution status: 1 after an execution, 2 after a reject
+assign execution_status = status_reg;
 
 // Position PnL logic (placeholder)
 assign position_pnl = 32'd0;
 
-// Sticky signals for testbench visibility
-reg exec_valid_sticky;
-reg pos_update_valid_sticky;
-reg risk_violation_sticky;
+// Fibonacci hashing: the top bits of key * 2^32/phi spread sequential
+// order IDs and ASCII symbols evenly over the sets
+function [31:0] fib_hash;
+    input [31:0] key;
+    begin
+        fib_hash = key * 32'h9E3779B1;
+    end
+endfunction
+
+// Book lookups on the stage 1 order (combinational).
+// Each returns the matching way and the first free way of the set.
+integer w;
+
+wire [31:0] current_id = current_order[31:0];
+wire [ORDER_SET_BITS-1:0] ord_set = fib_hash(current_id) >> (32 - ORDER_SET_BITS);
+reg ord_hit, ord_free;
+reg [ORDER_IDX_BITS-1:0] ord_hit_idx, ord_free_idx;
+
+always @(*) begin
+    ord_hit = 1'b0;
+    ord_free = 1'b0;
+    ord_hit_idx = {ORDER_IDX_BITS{1'b0}};
+    ord_free_idx = {ORDER_IDX_BITS{1'b0}};
+    for (w = BOOK_WAYS - 1; w >= 0; w = w - 1) begin
+        if (ord_valid[ord_set * BOOK_WAYS + w] && ord_id[ord_set * BOOK_WAYS + w] == current_id) begin
+            ord_hit = 1'b1;
+            ord_hit_idx = ord_set * BOOK_WAYS + w;
+        end
+        if (!ord_valid[ord_set * BOOK_WAYS + w]) begin
+            ord_free = 1'b1;
+            ord_free_idx = ord_set * BOOK_WAYS + w;
+        end
+    end
+end
+
+wire [SYMBOL_SET_BITS-1:0] sym_set = fib_hash(current_symbol) >> (32 - SYMBOL_SET_BITS);
+reg sym_hit, sym_free;
+reg [SYMBOL_IDX_BITS-1:0] sym_hit_idx, sym_free_idx;
+
+always @(*) begin
+    sym_hit = 1'b0;
+    sym_free = 1'b0;
+    sym_hit_idx = {SYMBOL_IDX_BITS{1'b0}};
+    sym_free_idx = {SYMBOL_IDX_BITS{1'b0}};
+    for (w = BOOK_WAYS - 1; w >= 0; w = w - 1) begin
+        if (sym_valid[sym_set * BOOK_WAYS + w] && sym_key[sym_set * BOOK_WAYS + w] == current_symbol) begin
+            sym_hit = 1'b1;
+            sym_hit_idx = sym_set * BOOK_WAYS + w;
+        end
+        if (!sym_valid[sym_set * BOOK_WAYS + w]) begin
+            sym_free = 1'b1;
+            sym_free_idx = sym_set * BOOK_WAYS + w;
+        end
+    end
+end
+
+// Slot for a new order's symbol, allocated on first use
+wire sym_ok = sym_hit || sym_free;
+wire [SYMBOL_IDX_BITS-1:0] add_slot = sym_hit ? sym_hit_idx : sym_free_idx;
+
+wire [31:0] level_key = current_price ^ fib_hash({{(31 - SYMBOL_IDX_BITS){1'b0}}, add_slot, current_side});
+wire [LEVEL_SET_BITS-1:0] lvl_set = fib_hash(level_key) >> (32 - LEVEL_SET_BITS);
+reg lvl_hit, lvl_free;
+reg [LEVEL_IDX_BITS-1:0] lvl_hit_idx, lvl_free_idx;
+
+always @(*) begin
+    lvl_hit = 1'b0;
+    lvl_free = 1'b0;
+    lvl_hit_idx = {LEVEL_IDX_BITS{1'b0}};
+    lvl_free_idx = {LEVEL_IDX_BITS{1'b0}};
+    for (w = BOOK_WAYS - 1; w >= 0; w = w - 1) begin
+        if (lvl_valid[lvl_set * BOOK_WAYS + w] && lvl_slot[lvl_set * BOOK_WAYS + w] == add_slot &&
+            lvl_side[lvl_set * BOOK_WAYS + w] == current_side &&
+            lvl_price[lvl_set * BOOK_WAYS + w] == current_price) begin
+            lvl_hit = 1'b1;
+            lvl_hit_idx = lvl_set * BOOK_WAYS + w;
+        end
+        if (!lvl_valid[lvl_set * BOOK_WAYS + w]) begin
+            lvl_free = 1'b1;
+            lvl_free_idx = lvl_set * BOOK_WAYS + w;
+        end
+    end
+end
+
+// Resting order addressed by a cancel or execute, and its level
+wire [LEVEL_IDX_BITS-1:0] rest_level = ord_level[ord_hit_idx];
+wire [VOLUME_WIDTH-1:0] rest_volume = ord_volume[ord_hit_idx];
+wire [VOLUME_WIDTH-1:0] fill_volume = (current_volume < rest_volume) ? current_volume : rest_volume;
+wire rest_done = (current_type == TYPE_CANCEL) || (fill_volume == rest_volume);
+wire [VOLUME_WIDTH-1:0] rest_removed = (current_type == TYPE_CANCEL) ? rest_volume : fill_volume;
+
+// Pre-trade risk operands. An execute of a resting order fills at that
+// order's price and side; every other order is checked as if it filled in
+// full, so a resting limit order can never breach a limit when it trades.
+wire resting_exec = (current_type == TYPE_EXECUTE);
+wire [SYMBOL_IDX_BITS-1:0] exec_slot = resting_exec ? ord_slot[ord_hit_idx] : add_slot;
+wire [VOLUME_WIDTH-1:0] risk_position = (resting_exec || sym_hit) ? positions[exec_slot] : {VOLUME_WIDTH{1'b0}};
+wire risk_side = resting_exec ? ord_side[ord_hit_idx] : current_side;
+wire [VOLUME_WIDTH-1:0] risk_volume = resting_exec ? fill_volume : current_volume;
+wire [PRICE_WIDTH-1:0] fill_price = (current_type == TYPE_MARKET) ? (current_side ? tick_ask : tick_bid) :
+                                    resting_exec ? ord_price[ord_hit_idx] : current_price;
+
+// Net position after the fill, two bits wider so it cannot wrap
+wire [VOLUME_WIDTH+1:0] position_before = {{2{risk_position[VOLUME_WIDTH-1]}}, risk_position};
+wire [VOLUME_WIDTH+1:0] position_after = risk_side ? position_before - {2'b00, risk_volume} :
+                                                     position_before + {2'b00, risk_volume};
+wire [VOLUME_WIDTH+1:0] position_exposure = position_after[VOLUME_WIDTH+1] ? ~position_after + 1 :
+                                                                             position_after;
+wire [PRICE_WIDTH+VOLUME_WIDTH-1:0] notional = {{VOLUME_WIDTH{1'b0}}, fill_price} *
+                                               {{PRICE_WIDTH{1'b0}}, risk_volume};
+
+wire new_order = (current_type == TYPE_MARKET) || (current_type == TYPE_LIMIT);
+wire rate_throttled = risk_enabled && (risk_rate_interval != 32'd0);
+wire [15:0] rate_available = (rate_tokens > risk_rate_burst) ? risk_rate_burst : rate_tokens;
+wire rate_full = (rate_available == risk_rate_burst);
+wire rate_refill = !rate_full && (rate_timer >= risk_rate_interval - 32'd1);
+
+assign risk_position_ok = position_exposure <= {{(VOLUME_WIDTH+2-PRICE_WIDTH){1'b0}}, risk_position_limit};
+assign risk_size_ok = risk_volume <= risk_max_order_size;
+assign risk_notional_ok = notional <= risk_max_notional;
+assign risk_rate_ok = !rate_throttled || !new_order || (rate_available != 16'd0);
+assign risk_all_ok = risk_position_ok && risk_size_ok && risk_notional_ok && risk_rate_ok;
+
+// Simple matching engine (combinational logic)
+assign match_found = (current_type == TYPE_LIMIT) && tick_valid &&
+                    (current_symbol == tick_symbol) &&
+                    ((current_side == 1'b0 && current_price >= tick_ask) ||
+                     (current_side == 1'b1 && current_price <= tick_bid));
+
+// Validation, book checks and risk checks of the stage 1 order all settle in
+// the same cycle as its match; an order that fails any of them is rejected
+// before the book, positions or outputs see it. Cancels only ever reduce
+// risk and skip the risk checks.
+wire trades = new_order || resting_exec;
+wire order_fields_ok = !((current_type != TYPE_CANCEL && current_volume == 0) ||
+                         (current_type < TYPE_CANCEL && current_price == 0));
+wire adds = (current_type == TYPE_LIMIT) && !match_found;
+wire book_ok = new_order ?
+                   sym_ok && (!adds || (!ord_hit && ord_free && (lvl_hit || lvl_free))) :
+               (current_type == TYPE_CANCEL || resting_exec) ? ord_hit : 1'b1;
+wire risk_reject = risk_enabled && trades && !risk_all_ok;
+wire accept = order_fields_ok && book_ok && !risk_reject;
+wire executes = accept && trades && !adds;
+
+// Symbol slot the order commits to, and its state afterwards. A slot whose
+// position ends flat with no resting orders is released; a new symbol
+// that trades straight back to flat never takes one.
+wire book_order = (current_type == TYPE_CANCEL) || resting_exec;
+wire [SYMBOL_IDX_BITS-1:0] commit_slot = new_order ? add_slot : ord_slot[ord_hit_idx];
+wire slot_tracked = !new_order || sym_hit;
+wire [ORDER_IDX_BITS:0] slot_orders = slot_tracked ? sym_orders[commit_slot] : {(ORDER_IDX_BITS+1){1'b0}};
+wire [ORDER_IDX_BITS:0] slot_orders_after =
+    adds ? slot_orders + {{ORDER_IDX_BITS{1'b0}}, 1'b1} :
+    (book_order && rest_done) ? slot_orders - {{ORDER_IDX_BITS{1'b0}}, 1'b1} : slot_orders;
+wire [VOLUME_WIDTH-1:0] slot_position_after = executes ? position_after[VOLUME_WIDTH-1:0] :
+                                              slot_tracked ? positions[commit_slot] : {VOLUME_WIDTH{1'b0}};
+wire slot_release = (new_order || book_order) && (slot_position_after == {VOLUME_WIDTH{1'b0}}) &&
+                    (slot_orders_after == {(ORDER_IDX_BITS+1){1'b0}});
 
-// Main state machine
+// Stage 1 commits when the execution output is free, and takes the next
+// order when it commits or is empty
+wire stage_advance = !exec_valid || exec_ready;
+wire commit = current_valid && stage_advance;
+wire stage_load = stage_advance || !current_valid;
+wire order_take = order_valid && order_ready;
+wire fifo_pop = stage_load && !fifo_empty;
+wire fifo_push = order_take && !(stage_load && fifo_empty);
+
+// Main pipeline
 always @(posedge clk or negedge rst_n) begin
     if (!rst_n) begin
-        order_state <= ORDER_IDLE;
+        current_valid <= 1'b0;
+        fifo_wr <= {(FIFO_BITS+1){1'b0}};
+        fifo_rd <= {(FIFO_BITS+1){1'b0}};
+        fifo_peak <= {(FIFO_BITS+1){1'b0}};
+        fifo_stall_counter <= 32'b0;
+        sym_reject_counter <= 32'b0;
         order_counter <= 32'b0;
         fill_counter <= 32'b0;
         reject_counter <= 32'b0;
-        active_order_count <= 16'b0;
-        order_write_ptr <= 10'b0;
-        order_read_ptr <= 10'b0;
-        position_count <= 8'b0;
-        pipeline_counter <= 4'b0;
+        active_order_count <= {(ORDER_IDX_BITS+1){1'b0}};
+        position_count <= {(SYMBOL_IDX_BITS+1){1'b0}};
+        rate_tokens <= 16'hFFFF;
+        rate_timer <= 32'b0;
         
         exec_valid <= 1'b0;
+        exec_latency_valid <= 1'b0;
         pos_update_valid <= 1'b0;
-        exec_valid_sticky <= 1'b0;
-        pos_update_valid_sticky <= 1'b0;
         risk_violation_sticky <= 1'b0;
+        risk_code_reg <= 32'b0;
+        status_reg <= 32'b0;
         
-        // Initialize order memory
+        // Empty book
         for (i = 0; i < MAX_ORDERS; i = i + 1) begin
-            order_valid_flags[i] <= 1'b0;
+            ord_valid[i] <= 1'b0;
+        end
+        for (i = 0; i < MAX_POSITIONS; i = i + 1) begin
+            sym_valid[i] <= 1'b0;
+        end
+        for (i = 0; i < MAX_LEVELS; i = i + 1) begin
+            lvl_valid[i] <= 1'b0;
         end
         
     end else begin
-        case (order_state)
-            ORDER_IDLE: begin
-                exec_valid <= 1'b0;
-                pos_update_valid <= 1'b0;
-                pipeline_counter <= 4'b0;
-                
-                if (order_valid) begin
-                    // Capture new order
-                    current_order <= {32'b0, order_id};
-                    current_symbol <= order_symbol;
-                    current_price <= order_price;
-                    current_volume <= order_volume;
-                    current_side <= order_side;
-                    current_type <= order_type;
-                    
-                    order_state <= ORDER_VALIDATE;
-                    pipeline_counter <= 4'b1;
-                end
+        if (stage_advance) exec_valid <= 1'b0;
+        exec_latency_valid <= 1'b0;
+        pos_update_valid <= 1'b0;
+        status_reg <= 32'b0;
+        
+        // Stage 0: queue a new order, unless it can go straight to stage 1
+        if (fifo_push) begin
+            fifo_id[fifo_wr[FIFO_BITS-1:0]] <= order_id;
+            fifo_symbol[fifo_wr[FIFO_BITS-1:0]] <= order_symbol;
+            fifo_price[fifo_wr[FIFO_BITS-1:0]] <= order_price;
+            fifo_volume[fifo_wr[FIFO_BITS-1:0]] <= order_volume;
+            fifo_side[fifo_wr[FIFO_BITS-1:0]] <= order_side;
+            fifo_type[fifo_wr[FIFO_BITS-1:0]] <= order_type;
+            fifo_tick_time[fifo_wr[FIFO_BITS-1:0]] <= order_tick_time;
+            fifo_wr <= fifo_wr + 1;
+        end
+        if (fifo_pop) fifo_rd <= fifo_rd + 1;
+        if (fifo_level > fifo_peak) fifo_peak <= fifo_level;
+        if (order_valid && !order_ready) fifo_stall_counter <= fifo_stall_counter + 1;
+        
+        // Load stage 1 with the oldest order
+        if (stage_load) begin
+            current_valid <= !fifo_empty || order_take;
+            if (!fifo_empty) begin
+                current_order <= {32'b0, fifo_id[fifo_head]};
+                current_symbol <= fifo_symbol[fifo_head];
+                current_price <= fifo_price[fifo_head];
+                current_volume <= fifo_volume[fifo_head];
+                current_side <= fifo_side[fifo_head];
+                current_type <= fifo_type[fifo_head];
+                current_tick_time <= fifo_tick_time[fifo_head];
+            end else if (order_take) begin
+                current_order <= {32'b0, order_id};
+                current_symbol <= order_symbol;
+                current_price <= order_price;
+                current_volume <= order_volume;
+                current_side <= order_side;
+                current_type <= order_type;
+                current_tick_time <= order_tick_time;
             end
+        end
+        
+        // Stage 1: check, match and commit the order
+        if (commit) begin
+            order_counter <= order_counter + 1;
             
-            ORDER_VALIDATE: begin
-                pipeline_counter <= pipeline_counter + 1;
-                
-                // Basic validation (1 clock cycle)
-                if (current_volume == 0 || current_price == 0) begin
-                    order_state <= ORDER_REJECT;
-                end else begin
-                    order_state <= ORDER_RISK_CHECK;
+            if (!accept) begin
+                reject_counter <= reject_counter + 1;
+                status_reg <= 32'd2;
+                if (order_fields_ok && new_order && !sym_ok) sym_reject_counter <= sym_reject_counter + 1;
+                if (order_fields_ok && book_ok) begin
+                    risk_violation_sticky <= 1'b1;
+                    risk_code_reg <= !risk_position_ok ? RISK_POSITION :
+                                     !risk_size_ok     ? RISK_SIZE :
+                                     !risk_notional_ok ? RISK_NOTIONAL : RISK_RATE;
                 end
-            end
-            
-            ORDER_RISK_CHECK: begin
-                pipeline_counter <= pipeline_counter + 1;
                 
-                // Risk checks (1 clock cycle)
-                if (risk_enabled && !risk_all_ok) begin
-                    order_state <= ORDER_REJECT;
-                end else begin
-                    order_state <= ORDER_MATCH;
+            end else if (new_order) begin
+                if (!sym_hit && !slot_release) begin
+                    sym_valid[sym_free_idx] <= 1'b1;
+                    sym_key[sym_free_idx] <= current_symbol;
+                    positions[sym_free_idx] <= {VOLUME_WIDTH{1'b0}};
+                    position_count <= position_count + 1;
                 end
-            end
-            
-            ORDER_MATCH: begin
-                pipeline_counter <= pipeline_counter + 1;
                 
-                // Order matching logic (1 clock cycle)
-                if (current_type == 3'b000) begin  // Market order
-                    order_state <= ORDER_EXECUTE;
-                end else if (current_type == 3'b001) begin  // Limit order
-                    if (match_found) begin
-                        order_state <= ORDER_EXECUTE;
+                if (adds) begin
+                    // Rest the order on the book
+                    ord_valid[ord_free_idx] <= 1'b1;
+                    ord_id[ord_free_idx] <= current_id;
+                    ord_slot[ord_free_idx] <= add_slot;
+                    ord_level[ord_free_idx] <= lvl_hit ? lvl_hit_idx : lvl_free_idx;
+                    ord_price[ord_free_idx] <= current_price;
+                    ord_volume[ord_free_idx] <= current_volume;
+                    ord_side[ord_free_idx] <= current_side;
+                    
+                    if (lvl_hit) begin
+                        lvl_volume[lvl_hit_idx] <= lvl_volume[lvl_hit_idx] + current_volume;
+                        lvl_orders[lvl_hit_idx] <= lvl_orders[lvl_hit_idx] + 1;
                     end else begin
-                        // Store order for later matching
-                        order_memory[order_write_ptr] <= current_order;
-                        order_symbols[order_write_ptr] <= current_symbol;
-                        order_prices[order_write_ptr] <= current_price;
-                        order_volumes[order_write_ptr] <= current_volume;
-                        order_sides[order_write_ptr] <= current_side;
-                        order_types[order_write_ptr] <= current_type;
-                        order_valid_flags[order_write_ptr] <= 1'b1;
-                        
-                        order_write_ptr <= order_write_ptr + 1;
-                        active_order_count <= active_order_count + 1;
-                        
-                        order_state <= ORDER_COMPLETE;
+                        lvl_valid[lvl_free_idx] <= 1'b1;
+                        lvl_slot[lvl_free_idx] <= add_slot;
+                        lvl_side[lvl_free_idx] <= current_side;
+                        lvl_price[lvl_free_idx] <= current_price;
+                        lvl_volume[lvl_free_idx] <= current_volume;
+                        lvl_orders[lvl_free_idx] <= 1;
                     end
-                end else begin  // Cancel order
-                    // Cancel logic would go here
-                    order_state <= ORDER_COMPLETE;
+                    
+                    active_order_count <= active_order_count + 1;
+                end
+                
+            end else if (current_type == TYPE_CANCEL || resting_exec) begin
+                if (rest_done) begin
+                    ord_valid[ord_hit_idx] <= 1'b0;
+                    active_order_count <= active_order_count - 1;
+                end else begin
+                    ord_volume[ord_hit_idx] <= rest_volume - fill_volume;
+                end
+                
+                if (rest_done && lvl_orders[rest_level] == 1) begin
+                    lvl_valid[rest_level] <= 1'b0;
+                end else begin
+                    lvl_volume[rest_level] <= lvl_volume[rest_level] - rest_removed;
+                    if (rest_done) lvl_orders[rest_level] <= lvl_orders[rest_level] - 1;
                 end
             end
             
-            ORDER_EXECUTE: begin
-                pipeline_counter <= pipeline_counter + 1;
-                
-                // Execute order (1 clock cycle)
+            if (executes) begin
                 exec_valid <= 1'b1;
                 exec_order_id <= current_order;
-                exec_symbol <= current_symbol;
-                exec_price <= (current_type == 3'b000) ? 
-                             (current_side ? tick_ask : tick_bid) : current_price;
-                exec_volume <= current_volume;
-                exec_side <= current_side;
-                exec_timestamp <= $time;
+                exec_symbol <= resting_exec ? sym_key[exec_slot] : current_symbol;
+                exec_price <= fill_price;
+                exec_volume <= risk_volume;
+                exec_side <= risk_side;
+                exec_timestamp <= timebase;
+                exec_tick_time <= current_tick_time;
+                exec_latency <= (tick_age[63:32] != 32'b0) ? 32'hFFFFFFFF : tick_age[31:0];
+                exec_latency_valid <= 1'b1;
                 
-                // Update position
+                // Update position; the risk check already computed it
+                positions[exec_slot] <= position_after[VOLUME_WIDTH-1:0];
                 pos_update_valid <= 1'b1;
-                pos_symbol <= current_symbol;
-                pos_quantity <= current_volume;
-                pos_side <= current_side;
+                pos_symbol <= resting_exec ? sym_key[exec_slot] : current_symbol;
+                pos_quantity <= risk_volume;
+                pos_side <= risk_side;
                 
                 fill_counter <= fill_counter + 1;
-                order_state <= ORDER_COMPLETE;
-            end
-            
-            ORDER_REJECT: begin
-                reject_counter <= reject_counter + 1;
-                order_state <= ORDER_COMPLETE;
+                status_reg <= 32'd1;
             end
             
-            ORDER_COMPLETE: begin
-                order_counter <= order_counter + 1;
-                order_state <= ORDER_IDLE;
-            end
-            
-            default: begin
-                order_state <= ORDER_IDLE;
-            end
-        endcase
-    end
-end
-
-// Risk management logic
-assign risk_position_ok = !risk_enabled || (current_volume <= risk_position_limit);
-assign risk_size_ok = !risk_enabled || (current_volume <= risk_max_order_size);
-assign risk_all_ok = risk_position_ok && risk_size_ok;
-
-// Simple matching engine (combinational logic)
-assign match_found = (current_type == 3'b001) && tick_valid && 
-                    (current_symbol == tick_symbol) &&
-                    ((current_side == 1'b0 && current_price >= tick_ask) ||
-                     (current_side == 1'b1 && current_price <= tick_bid));
-
-assign match_price = current_side ? tick_bid : tick_ask;
-assign match_volume = current_volume;  // Simplified - assume full fill
-
-// Position management
-integer pos_idx;
-reg position_found;
-
-always @(posedge clk or negedge rst_n) begin
-    if (!rst_n) begin
-        // Initialize positions
-        integer j;
-        for (j = 0; j < MAX_POSITIONS; j = j + 1) begin
-            positions[j] <= {VOLUME_WIDTH{1'b0}};
-            position_symbols[j] <= {SYMBOL_WIDTH{1'b0}};
-        end
-    end else if (pos_update_valid) begin
-        // Update position
-        position_found = 1'b0;
-        
-        for (pos_idx = 0; pos_idx < position_count; pos_idx = pos_idx + 1) begin
-            if (position_symbols[pos_idx] == pos_symbol) begin
-                if (pos_side == 1'b0) begin  // Buy
-                    positions[pos_idx] <= positions[pos_idx] + pos_quantity;
-                end else begin  // Sell
-                    positions[pos_idx] <= positions[pos_idx] - pos_quantity;
+            if (accept && (new_order || book_order)) begin
+                sym_orders[commit_slot] <= slot_orders_after;
+                if (slot_release && slot_tracked) begin
+                    sym_valid[commit_slot] <= 1'b0;
+                    position_count <= position_count - 1;
                 end
-                position_found = 1'b1;
             end
         end
         
-        // Add new position if symbol not found
-        if (!position_found && position_count < MAX_POSITIONS) begin
-            position_symbols[position_count] <= pos_symbol;
-            positions[position_count] <= pos_side ? -pos_quantity : pos_quantity;
-            position_count <= position_count + 1;
+        // Order-rate throttle: every accepted new order takes a token; the
+        // refill timer only runs while the bucket is below its burst size
+        if (!rate_throttled) begin
+            rate_tokens <= risk_rate_burst;
+            rate_timer <= 32'b0;
+        end else begin
+            rate_tokens <= rate_available - {15'b0, commit && accept && new_order} + {15'b0, rate_refill};
+            rate_timer <= (rate_full || rate_refill) ? 32'b0 : rate_timer + 32'd1;
         end
     end
 end
@@ -0,0 +1,398 @@
+/*
+ * Sharded Trading System
+ * One market data processor feeding NUM_LANES parallel strategy/order
+ * manager lanes, with the lanes' executions merged back into one stream
+ *
+ * Features:
+ * - Symbol-hash router: every tick of a symbol goes to the same lane, so
+ *   each lane keeps its own positions, resting orders and strategy state
+ *   with no sharing between lanes
+ * - The route hash uses a different multiplier from the Fibonacci hash the
+ *   lanes index their own tables with, so a lane's symbols still spread
+ *   over all of its slots
+ * - Lanes in use (2^cfg_lane_bits, up to NUM_LANES) are configurable, so
+ *   one build can measure scaling; change it only while held in reset
+ * - Execution merge: a small FIFO per lane and a round-robin arbiter that
+ *   emits one execution per cycle, starting after the last lane granted
+ * - Per-lane tick, order, acceptance and execution counters to show which
+ *   lane saturates first
+ */
+
+module sharded_trading_system #(
+    parameter NUM_LANES = 8,                // power of two, up to 256
+    parameter MAX_SYMBOLS = 256,            // per lane
+    parameter MAX_ORDERS = 1024,            // resting orders per lane
+    parameter EXEC_FIFO_DEPTH = 4           // per lane, power of two >= 2
+) (
+    input  wire                     clk,
+    input  wire                     rst_n,
+
+    // Market data input (market_data_processor stream)
+    input  wire                     data_valid,
+    input  wire [63:0]              data_in,
+    input  wire [7:0]               data_type,
+    input  wire                     data_last,
+    output wire                     data_ready,
+
+    input  wire [63:0]              timebase,
+
+    // Routing
+    input  wire [3:0]               cfg_lane_bits,      // log2 of the lanes in use
+
+    // Strategy configuration, shared by every lane
+    input  wire [3:0]               strategy_enable,
+    input  wire [31:0]              arb_min_profit,
+    input  wire [31:0]              mm_spread,
+    input  wire [31:0]              twap_target_vol,
+    input  wire [31:0]              twap_duration,
+    input  wire [1:0]               arbiter_mode,
+    input  wire [63:0]              strategy_min_gap,
+    input  wire [31:0]              position_limit,
+
+    // Risk configuration, shared by every lane
+    input  wire                     risk_enabled,
+    input  wire [31:0]              risk_position_limit,
+    input  wire [31:0]              risk_max_order_size,
+    input  wire [63:0]              risk_max_notional,
+    input  wire [15:0]              risk_rate_burst,
+    input  wire [31:0]              risk_rate_interval,
+
+    // Merged executions, one-cycle pulse per execution
+    output reg                      exec_valid,
+    output reg  [7:0]               exec_lane,
+    output reg  [31:0]              exec_symbol,
+    output reg  [31:0]              exec_price,
+    output reg  [31:0]              exec_volume,
+    output reg                      exec_side,
+    output reg  [63:0]              exec_tick_time,
+    output reg  [31:0]              exec_latency,
+
+    // Statistics; per-lane counters for lane l at bits [l*32 +: 32]
+    output wire [31:0]              ticks_routed,
+    output wire [31:0]              exec_dropped,       // executions lost to a full merge FIFO
+    output wire [NUM_LANES*32-1:0]  lane_ticks,
+    output wire [NUM_LANES*32-1:0]  lane_orders,        // orders from the lane's strategy
+    output wire [NUM_LANES*32-1:0]  lane_accepted,      // orders the lane's order manager took
+    output wire [NUM_LANES*32-1:0]  lane_executions
+);
+
+localparam [3:0] LANE_BITS = (NUM_LANES > 1) ? $clog2(NUM_LANES) : 0;
+localparam FIFO_BITS = $clog2(EXEC_FIFO_DEPTH);
+
+// Market data processor
+wire                parsed_valid;
+wire [31:0]         parsed_symbol;
+wire [31:0]         parsed_price;
+wire [31:0]         parsed_volume;
+wire [31:0]         parsed_bid;
+wire [31:0]         parsed_ask;
+wire [63:0]         parsed_tick_time;
+
+market_data_processor #(
+    .MAX_SYMBOLS(MAX_SYMBOLS)
+) market_processor (
+    .clk(clk),
+    .rst_n(rst_n),
+    .data_valid(data_valid),
+    .data_in(data_in),
+    .data_type(data_type),
+    .data_last(data_last),
+    .data_ready(data_ready),
+    .timebase(timebase),
+    .tick_valid(parsed_valid),
+    .symbol(parsed_symbol),
+    .price(parsed_price),
+    .volume(parsed_volume),
+    .bid(parsed_bid),
+    .ask(parsed_ask),
+    .timestamp(),
+    .ingress_time(parsed_tick_time),
+    .book_update_valid(),
+    .book_symbol(),
+    .book_price(),
+    .book_volume(),
+    .book_side(),
+    .book_action(),
+    .packets_processed(),
+    .parse_errors(),
+    .pipeline_depth()
+);
+
+// Router: top bits of a multiplicative hash pick the lane
+function [31:0] route_hash;
+    input [31:0] key;
+    begin
+        route_hash = key * 32'h85EBCA6B;
+    end
+endfunction
+
+wire [3:0] lane_bits = (cfg_lane_bits > LANE_BITS) ? LANE_BITS : cfg_lane_bits;
+wire [31:0] parsed_lane = route_hash(parsed_symbol) >> (6'd32 - {2'b0, lane_bits});
+
+reg                 route_valid;
+reg [7:0]           route_lane;
+reg [31:0]          route_symbol;
+reg [31:0]          route_price;
+reg [31:0]          route_volume;
+reg [31:0]          route_bid;
+reg [31:0]          route_ask;
+reg [63:0]          route_tick_time;
+reg [31:0]          route_counter;
+
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        route_valid <= 1'b0;
+        route_lane <= 8'd0;
+        route_counter <= 32'b0;
+    end else begin
+        route_valid <= parsed_valid;
+        if (parsed_valid) begin
+            route_lane <= parsed_lane[7:0];
+            route_symbol <= parsed_symbol;
+            route_price <= parsed_price;
+            route_volume <= parsed_volume;
+            route_bid <= parsed_bid;
+            route_ask <= parsed_ask;
+            route_tick_time <= parsed_tick_time;
+            route_counter <= route_counter + 1;
+        end
+    end
+end
+
+assign ticks_routed = route_counter;
+
+// Lane executions, lane l at bit l / bits [l*W +: W]
+wire [NUM_LANES-1:0]    lane_exec_valid;
+wire [NUM_LANES*32-1:0] lane_exec_symbol;
+wire [NUM_LANES*32-1:0] lane_exec_price;
+wire [NUM_LANES*32-1:0] lane_exec_volume;
+wire [NUM_LANES-1:0]    lane_exec_side;
+wire [NUM_LANES*64-1:0] lane_exec_tick_time;
+wire [NUM_LANES*32-1:0] lane_exec_latency;
+
+genvar l;
+generate
+    for (l = 0; l < NUM_LANES; l = l + 1) begin : lane
+        localparam [7:0] LANE_ID = l;
+        wire                tick = route_valid && (route_lane == LANE_ID);
+
+        wire                order_valid;
+        wire                order_ready;
+        wire [31:0]         order_symbol;
+        wire [31:0]         order_price;
+        wire [31:0]         order_volume;
+        wire                order_side;
+        wire [2:0]          order_type;
+        wire [63:0]         order_tick_time;
+
+        wire                pos_update_valid;
+        wire [31:0]         pos_quantity;
+        wire                pos_side;
+
+        reg  [31:0]         tick_counter;
+        reg  [23:0]         order_seq;          // order IDs are {lane, sequence}
+        reg  [31:0]         exec_counter;
+        reg  [31:0]         net_position;       // lane-wide, fed back to the strategy
+
+        trading_strategy #(
+            .MAX_SYMBOLS(MAX_SYMBOLS)
+        ) strategy (
+            .clk(clk),
+            .rst_n(rst_n),
+            .tick_valid(tick),
+            .tick_symbol(route_symbol),
+            .tick_price(route_price),
+            .tick_bid(route_bid),
+            .tick_ask(route_ask),
+            .tick_volume(route_volume),
+            .tick_venue(2'd0),
+            .tick_time(route_tick_time),
+            .strategy_enable(strategy_enable),
+            .arb_min_profit(arb_min_profit),
+            .mm_spread(mm_spread),
+            .twap_target_vol(twap_target_vol),
+            .twap_duration(twap_duration),
+            .arbiter_mode(arbiter_mode),
+            .strategy_min_gap(strategy_min_gap),
+            .order_valid(order_valid),
+            .order_symbol(order_symbol),
+            .order_price(order_price),
+            .order_volume(order_volume),
+            .order_side(order_side),
+            .order_type(order_type),
+            .order_venue(),
+            .order_tick_time(order_tick_time),
+            .order_ready(order_ready),
+            .current_position(net_position),
+            .position_limit(position_limit),
+            .decisions_made(),
+            .orders_generated(lane_orders[l*32 +: 32]),
+            .active_strategies(),
+            .orders_dropped(),
+            .strategy_decisions(),
+            .strategy_orders()
+        );
+
+        order_manager #(
+            .MAX_ORDERS(MAX_ORDERS),
+            .MAX_POSITIONS(MAX_SYMBOLS)
+        ) orders (
+            .clk(clk),
+            .rst_n(rst_n),
+            .order_valid(order_valid),
+            .order_data(64'd0),
+            .order_symbol(order_symbol),
+            .order_price(order_price),
+            .order_volume(order_volume),
+            .order_side(order_side),
+            .order_type(order_type),
+            .order_id({LANE_ID, order_seq}),
+            .order_tick_time(order_tick_time),
+            .order_ready(order_ready),
+            .timebase(timebase),
+            .tick_valid(tick),
+            .tick_symbol(route_symbol),
+            .tick_price(route_price),
+            .tick_bid(route_bid),
+            .tick_ask(route_ask),
+            .exec_valid(),
+            .exec_order_id(),
+            .exec_symbol(lane_exec_symbol[l*32 +: 32]),
+            .exec_price(lane_exec_price[l*32 +: 32]),
+            .exec_volume(lane_exec_volume[l*32 +: 32]),
+            .exec_side(lane_exec_side[l]),
+            .exec_timestamp(),
+            .exec_tick_time(lane_exec_tick_time[l*64 +: 64]),
+            .exec_latency(lane_exec_latency[l*32 +: 32]),
+            .exec_latency_valid(lane_exec_valid[l]),
+            .exec_ready(1'b1),                  // the merge FIFO counts its own drops
+            .pos_update_valid(pos_update_valid),
+            .pos_symbol(),
+            .pos_quantity(pos_quantity),
+            .pos_side(pos_side),
+            .risk_position_limit(risk_position_limit),
+            .risk_max_order_size(risk_max_order_size),
+            .risk_max_notional(risk_max_notional),
+            .risk_rate_burst(risk_rate_burst),
+            .risk_rate_interval(risk_rate_interval),
+            .risk_enabled(risk_enabled),
+            .risk_violation(),
+            .orders_processed(lane_accepted[l*32 +: 32]),
+            .orders_filled(),
+            .orders_rejected(),
+            .active_orders(),
+            .order_fifo_peak(),
+            .order_fifo_stall_cycles(),
+            .symbol_table_rejects(),
+            .risk_code(),
+            .execution_status(),
+            .position_pnl()
+        );
+
+        always @(posedge clk or negedge rst_n) begin
+            if (!rst_n) begin
+                tick_counter <= 32'b0;
+                order_seq <= 24'b0;
+                exec_counter <= 32'b0;
+                net_position <= 32'b0;
+            end else begin
+                if (tick) tick_counter <= tick_counter + 1;
+                if (order_valid && order_ready) order_seq <= order_seq + 1;
+                if (lane_exec_valid[l]) exec_counter <= exec_counter + 1;
+                if (pos_update_valid) begin
+                    net_position <= pos_side ? net_position - pos_quantity : net_position + pos_quantity;
+                end
+            end
+        end
+
+        assign lane_ticks[l*32 +: 32] = tick_counter;
+        assign lane_executions[l*32 +: 32] = exec_counter;
+    end
+endgenerate
+
+// Execution merge: per-lane FIFOs drained round-robin, one per cycle
+reg [31:0]          ef_symbol [0:NUM_LANES*EXEC_FIFO_DEPTH-1];
+reg [31:0]          ef_price [0:NUM_LANES*EXEC_FIFO_DEPTH-1];
+reg [31:0]          ef_volume [0:NUM_LANES*EXEC_FIFO_DEPTH-1];
+reg                 ef_side [0:NUM_LANES*EXEC_FIFO_DEPTH-1];
+reg [63:0]          ef_tick_time [0:NUM_LANES*EXEC_FIFO_DEPTH-1];
+reg [31:0]          ef_latency [0:NUM_LANES*EXEC_FIFO_DEPTH-1];
+reg [FIFO_BITS:0]   ef_wr [0:NUM_LANES-1];
+reg [FIFO_BITS:0]   ef_rd [0:NUM_LANES-1];
+reg [7:0]           rr_next;
+reg [31:0]          drop_counter;
+
+assign exec_dropped = drop_counter;
+
+integer gi, gl;
+reg grant_found;
+reg [7:0] grant_lane;
+
+always @(*) begin
+    grant_found = 1'b0;
+    grant_lane = 8'd0;
+    for (gi = 0; gi < NUM_LANES; gi = gi + 1) begin
+        gl = (rr_next + gi) % NUM_LANES;
+        if (!grant_found && ef_wr[gl] != ef_rd[gl]) begin
+            grant_found = 1'b1;
+            grant_lane = gl[7:0];
+        end
+    end
+end
+
+wire [31:0] grant_slot = grant_lane * EXEC_FIFO_DEPTH + ef_rd[grant_lane][FIFO_BITS-1:0];
+
+integer k, slot, drops;
+reg pop;
+reg [FIFO_BITS:0] fill;
+
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        for (k = 0; k < NUM_LANES; k = k + 1) begin
+            ef_wr[k] <= {(FIFO_BITS+1){1'b0}};
+            ef_rd[k] <= {(FIFO_BITS+1){1'b0}};
+        end
+        rr_next <= 8'd0;
+        drop_counter <= 32'b0;
+        exec_valid <= 1'b0;
+        exec_lane <= 8'd0;
+    end else begin
+        // Push every lane's execution; a full FIFO is only written when it
+        // is being popped this cycle
+        drops = 0;
+        for (k = 0; k < NUM_LANES; k = k + 1) begin
+            pop = grant_found && (grant_lane == k);
+            fill = ef_wr[k] - ef_rd[k];
+            if (lane_exec_valid[k]) begin
+                if (fill != EXEC_FIFO_DEPTH || pop) begin
+                    slot = k * EXEC_FIFO_DEPTH + ef_wr[k][FIFO_BITS-1:0];
+                    ef_symbol[slot] <= lane_exec_symbol[k*32 +: 32];
+                    ef_price[slot] <= lane_exec_price[k*32 +: 32];
+                    ef_volume[slot] <= lane_exec_volume[k*32 +: 32];
+                    ef_side[slot] <= lane_exec_side[k];
+                    ef_tick_time[slot] <= lane_exec_tick_time[k*64 +: 64];
+                    ef_latency[slot] <= lane_exec_latency[k*32 +: 32];
+                    ef_wr[k] <= ef_wr[k] + 1;
+                end else begin
+                    drops = drops + 1;
+                end
+            end
+            if (pop) ef_rd[k] <= ef_rd[k] + 1;
+        end
+        drop_counter <= drop_counter + drops;
+
+        exec_valid <= grant_found;
+        if (grant_found) begin
+            exec_lane <= grant_lane;
+            exec_symbol <= ef_symbol[grant_slot];
+            exec_price <= ef_price[grant_slot];
+            exec_volume <= ef_volume[grant_slot];
+            exec_side <= ef_side[grant_slot];
+            exec_tick_time <= ef_tick_time[grant_slot];
+            exec_latency <= ef_latency[grant_slot];
+            rr_next <= (grant_lane + 1) % NUM_LANES;
+        end
+    end
+end
+
+endmodule
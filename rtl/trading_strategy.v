@@ -3,9 +3,16 @@
  * Hardware-accelerated trading strategy execution
  * 
  * Features:
- * - Arbitrage detection
+ * - Cross-venue arbitrage detection against a per-symbol, per-venue BBO table
  * - Market making
  * - TWAP execution
+ * - All strategies evaluated in parallel on every tick; each strategy
+ *   queues its orders in a small FIFO and an arbiter (fixed priority or
+ *   round-robin, with per-strategy rate limits) drains one order per cycle
+ * - valid/ready order output: an order is held until order_ready takes it,
+ *   and nothing is granted meanwhile, so orders wait in the strategy FIFOs
+ *   instead of being lost downstream
+ * - Every order carries the ingress time of the tick that triggered it
  * - Sub-microsecond decision making
  */
 
@@ -14,7 +21,10 @@ module trading_strategy #(
     parameter PRICE_WIDTH = 32,
     parameter VOLUME_WIDTH = 32,
     parameter MAX_SYMBOLS = 256,
-    parameter STRATEGY_COUNT = 4
+    parameter STRATEGY_COUNT = 4,
+    parameter NUM_VENUES = 4,
+    parameter VENUE_BITS = 2,                           // >= $clog2(NUM_VENUES)
+    parameter ORDER_FIFO_DEPTH = 4                      // per strategy, power of two >= 2
 ) (
     input  wire                     clk,
     input  wire                     rst_n,
@@ -26,6 +36,8 @@ module trading_strategy #(
     input  wire [PRICE_WIDTH-1:0]   tick_bid,
     input  wire [PRICE_WIDTH-1:0]   tick_ask,
     input  wire [VOLUME_WIDTH-1:0]  tick_volume,
+    input  wire [VENUE_BITS-1:0]    tick_venue,         // venue the quote came from
+    input  wire [63:0]              tick_time,          // ingress time of the tick
     
     // Strategy configuration
     input  wire [3:0]               strategy_enable,    // Enable bits for each strategy
@@ -34,6 +46,10 @@ module trading_strategy #(
     input  wire [VOLUME_WIDTH-1:0]  twap_target_vol,   // TWAP target volume
     input  wire [31:0]              twap_duration,     // TWAP duration in cycles
     
+    // Order arbiter configuration
+    input  wire [1:0]               arbiter_mode,      // 0=fixed priority, 1=round-robin
+    input  wire [STRATEGY_COUNT*16-1:0] strategy_min_gap,  // idle cycles after each order, per strategy
+    
     // Order generation output
     output reg                      order_valid,
     output reg  [SYMBOL_WIDTH-1:0]  order_symbol,
@@ -41,6 +57,9 @@ module trading_strategy #(
     output reg  [VOLUME_WIDTH-1:0]  order_volume,
     output reg                      order_side,        // 0=buy, 1=sell
     output reg  [2:0]               order_type,        // 0=market, 1=limit
+    output reg  [VENUE_BITS-1:0]    order_venue,       // venue to route the order to
+    output reg  [63:0]              order_tick_time,   // ingress time of the triggering tick
+    input  wire                     order_ready,       // the order is taken on valid && ready
     
     // Position interface
     input  wire [VOLUME_WIDTH-1:0]  current_position,
@@ -49,7 +68,12 @@ module trading_strategy #(
     // Performance metrics
     output wire [31:0]              decisions_made,
     output wire [31:0]              orders_generated,
-    output wire [15:0]              active_strategies
+    output wire [15:0]              active_strategies,
+    output wire [31:0]              orders_dropped,    // candidates lost to a full strategy FIFO
+    
+    // Per-strategy metrics, strategy s at bits [s*32 +: 32]
+    output wire [STRATEGY_COUNT*32-1:0] strategy_decisions,
+    output wire [STRATEGY_COUNT*32-1:0] strategy_orders
 );
 
 // Strategy types
@@ -58,21 +82,30 @@ localparam STRATEGY_MARKET_MAKING = 2'b01;
 localparam STRATEGY_TWAP = 2'b10;
 localparam STRATEGY_MOMENTUM = 2'b11;
 
+// Arbiter modes
+localparam ARBITER_PRIORITY = 2'd0;
+localparam ARBITER_ROUND_ROBIN = 2'd1;
+
 // Internal registers
 reg [31:0] decision_counter;
 reg [31:0] order_gen_counter;
 reg [15:0] active_strategy_mask;
+reg [31:0] drop_counter;
 
 // Price history for strategies
 reg [PRICE_WIDTH-1:0] price_history [0:15];  // 16-element circular buffer
 reg [3:0] price_history_ptr;
-reg [PRICE_WIDTH-1:0] last_price;
 
-// Arbitrage detection
-reg [PRICE_WIDTH-1:0] arb_price_1, arb_price_2;
-reg [SYMBOL_WIDTH-1:0] arb_symbol_1, arb_symbol_2;
+// Arbitrage detection: best cross-venue opportunity for the tick in stage d2
+reg [PRICE_WIDTH-1:0] arb_profit;
+reg [PRICE_WIDTH-1:0] arb_buy_price, arb_sell_price;
+reg [VENUE_BITS-1:0] arb_buy_venue, arb_sell_venue;
 wire arb_opportunity;
-wire [PRICE_WIDTH-1:0] arb_profit;
+
+// Second leg of a paired (arbitrage) order, sent the cycle after the first
+reg [PRICE_WIDTH-1:0] leg_price;
+reg [VENUE_BITS-1:0] leg_venue;
+reg leg_pending;
 
 // Market making state
 reg [PRICE_WIDTH-1:0] mm_bid_price, mm_ask_price;
@@ -89,21 +122,300 @@ reg [VOLUME_WIDTH-1:0] twap_slice_size;
 reg twap_active;
 wire twap_time_slice;
 
-// Strategy decision logic
-reg [1:0] selected_strategy;
-reg strategy_decision_valid;
-
 // Pipeline registers
 reg tick_valid_d1, tick_valid_d2;
 reg [SYMBOL_WIDTH-1:0] tick_symbol_d1, tick_symbol_d2;
 reg [PRICE_WIDTH-1:0] tick_price_d1, tick_price_d2;
 reg [PRICE_WIDTH-1:0] tick_bid_d1, tick_bid_d2;
 reg [PRICE_WIDTH-1:0] tick_ask_d1, tick_ask_d2;
+reg [VENUE_BITS-1:0] tick_venue_d1, tick_venue_d2;
+reg [63:0] tick_time_d1, tick_time_d2;
+
+// Per-symbol state table. Symbols hash to a slot; every entry keeps its
+// symbol as a tag, so a slot shared by colliding symbols never mixes their
+// state. A tick writes its own entries while reading all entries for the
+// same slot (read-first), so the table is updated in one cycle and the very
+// next tick already sees the update without forwarding.
+localparam SLOT_BITS = $clog2(MAX_SYMBOLS);
+
+function [31:0] fib_hash;
+    input [31:0] key;
+    begin
+        fib_hash = key * 32'h9E3779B1;
+    end
+endfunction
+
+wire [SLOT_BITS-1:0] tick_slot = fib_hash(tick_symbol) >> (32 - SLOT_BITS);
+
+// Quotes from the other venues for the tick in stage d1, bank v at bit v
+wire [NUM_VENUES-1:0] venue_quote_d1;
+wire [NUM_VENUES*PRICE_WIDTH-1:0] venue_bid_d1;
+wire [NUM_VENUES*PRICE_WIDTH-1:0] venue_ask_d1;
+
+// One BBO bank per venue, so all venues are read in parallel
+genvar v;
+generate
+    for (v = 0; v < NUM_VENUES; v = v + 1) begin : bbo_bank
+        reg                     entry_valid [0:MAX_SYMBOLS-1];
+        reg [SYMBOL_WIDTH-1:0]  entry_symbol [0:MAX_SYMBOLS-1];
+        reg [PRICE_WIDTH-1:0]   entry_bid [0:MAX_SYMBOLS-1];
+        reg [PRICE_WIDTH-1:0]   entry_ask [0:MAX_SYMBOLS-1];
+        
+        reg                     rd_valid;
+        reg [SYMBOL_WIDTH-1:0]  rd_symbol;
+        reg [PRICE_WIDTH-1:0]   rd_bid, rd_ask;
+        integer k;
+        
+        always @(posedge clk or negedge rst_n) begin
+            if (!rst_n) begin
+                for (k = 0; k < MAX_SYMBOLS; k = k + 1) begin
+                    entry_valid[k] <= 1'b0;
+                end
+                rd_valid <= 1'b0;
+            end else if (tick_valid) begin
+                rd_valid <= entry_valid[tick_slot];
+                rd_symbol <= entry_symbol[tick_slot];
+                rd_bid <= entry_bid[tick_slot];
+                rd_ask <= entry_ask[tick_slot];
+                
+                if (tick_venue == v) begin
+                    entry_valid[tick_slot] <= 1'b1;
+                    entry_symbol[tick_slot] <= tick_symbol;
+                    entry_bid[tick_slot] <= tick_bid;
+                    entry_ask[tick_slot] <= tick_ask;
+                end
+            end
+        end
+        
+        assign venue_quote_d1[v] = tick_valid_d1 && rd_valid && (rd_symbol == tick_symbol_d1) &&
+                                   (tick_venue_d1 != v);
+        assign venue_bid_d1[v*PRICE_WIDTH +: PRICE_WIDTH] = rd_bid;
+        assign venue_ask_d1[v*PRICE_WIDTH +: PRICE_WIDTH] = rd_ask;
+    end
+endgenerate
+
+// Last traded price per symbol (any venue), for momentum
+reg                     last_valid [0:MAX_SYMBOLS-1];
+reg [SYMBOL_WIDTH-1:0]  last_symbol [0:MAX_SYMBOLS-1];
+reg [PRICE_WIDTH-1:0]   last_price_mem [0:MAX_SYMBOLS-1];
+reg                     last_rd_valid;
+reg [SYMBOL_WIDTH-1:0]  last_rd_symbol;
+reg [PRICE_WIDTH-1:0]   last_rd_price;
+reg [PRICE_WIDTH-1:0]   last_price_d2;
+integer li;
+
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        for (li = 0; li < MAX_SYMBOLS; li = li + 1) begin
+            last_valid[li] <= 1'b0;
+        end
+        last_rd_valid <= 1'b0;
+    end else if (tick_valid) begin
+        last_rd_valid <= last_valid[tick_slot];
+        last_rd_symbol <= last_symbol[tick_slot];
+        last_rd_price <= last_price_mem[tick_slot];
+        last_valid[tick_slot] <= 1'b1;
+        last_symbol[tick_slot] <= tick_symbol;
+        last_price_mem[tick_slot] <= tick_price;
+    end
+end
+
+// Best other-venue quotes for the tick in stage d1 (parallel compare)
+integer vi;
+reg best_bid_found, best_ask_found;
+reg [PRICE_WIDTH-1:0] best_bid_d1, best_ask_d1;
+reg [VENUE_BITS-1:0] best_bid_venue_d1, best_ask_venue_d1;
+
+always @(*) begin
+    best_bid_found = 1'b0;
+    best_ask_found = 1'b0;
+    best_bid_d1 = {PRICE_WIDTH{1'b0}};
+    best_ask_d1 = {PRICE_WIDTH{1'b1}};
+    best_bid_venue_d1 = {VENUE_BITS{1'b0}};
+    best_ask_venue_d1 = {VENUE_BITS{1'b0}};
+    for (vi = 0; vi < NUM_VENUES; vi = vi + 1) begin
+        if (venue_quote_d1[vi]) begin
+            if (!best_bid_found || venue_bid_d1[vi*PRICE_WIDTH +: PRICE_WIDTH] > best_bid_d1) begin
+                best_bid_found = 1'b1;
+                best_bid_d1 = venue_bid_d1[vi*PRICE_WIDTH +: PRICE_WIDTH];
+                best_bid_venue_d1 = vi[VENUE_BITS-1:0];
+            end
+            if (!best_ask_found || venue_ask_d1[vi*PRICE_WIDTH +: PRICE_WIDTH] < best_ask_d1) begin
+                best_ask_found = 1'b1;
+                best_ask_d1 = venue_ask_d1[vi*PRICE_WIDTH +: PRICE_WIDTH];
+                best_ask_venue_d1 = vi[VENUE_BITS-1:0];
+            end
+        end
+    end
+end
+
+// Buy on this venue and sell where the bid is highest, or buy where the
+// ask is lowest and sell on this venue
+wire [PRICE_WIDTH-1:0] sell_away_profit = (best_bid_found && best_bid_d1 > tick_ask_d1) ?
+                                          (best_bid_d1 - tick_ask_d1) : {PRICE_WIDTH{1'b0}};
+wire [PRICE_WIDTH-1:0] buy_away_profit = (best_ask_found && tick_bid_d1 > best_ask_d1) ?
+                                         (tick_bid_d1 - best_ask_d1) : {PRICE_WIDTH{1'b0}};
 
 // Statistics
 assign decisions_made = decision_counter;
 assign orders_generated = order_gen_counter;
 assign active_strategies = active_strategy_mask;
+assign orders_dropped = drop_counter;
+
+// Arbitrage detection logic
+assign arb_opportunity = (arb_profit > arb_min_profit) && (current_position < position_limit);
+
+// Market making time slice
+assign twap_time_slice = (twap_timer > 0) && ((twap_timer % (twap_duration / 100)) == 0);
+
+// Momentum signal (simplified)
+wire [PRICE_WIDTH-1:0] price_change;
+wire momentum_signal;
+assign price_change = (tick_price_d2 > last_price_d2) ? (tick_price_d2 - last_price_d2) : 
+                     (last_price_d2 - tick_price_d2);
+assign momentum_signal = (price_change > (tick_price_d2 >> 7));  // 0.78% threshold
+
+// Queued order layout. A paired entry (arbitrage) carries a second leg on
+// the opposite side with its own price and venue; both legs share the
+// triggering tick's ingress time.
+localparam E_SYMBOL = 0;
+localparam E_PRICE = E_SYMBOL + SYMBOL_WIDTH;
+localparam E_VOLUME = E_PRICE + PRICE_WIDTH;
+localparam E_SIDE = E_VOLUME + VOLUME_WIDTH;
+localparam E_TYPE = E_SIDE + 1;
+localparam E_VENUE = E_TYPE + 3;
+localparam E_LEG_PRICE = E_VENUE + VENUE_BITS;
+localparam E_LEG_VENUE = E_LEG_PRICE + PRICE_WIDTH;
+localparam E_PAIRED = E_LEG_VENUE + VENUE_BITS;
+localparam E_TIME = E_PAIRED + 1;
+localparam ENTRY_WIDTH = E_TIME + 64;
+localparam FIFO_BITS = $clog2(ORDER_FIFO_DEPTH);
+
+// Every strategy decides on every tick in d2, independently of the others
+wire [STRATEGY_COUNT-1:0] cand_valid;
+wire [STRATEGY_COUNT*ENTRY_WIDTH-1:0] cand_entry;
+
+assign cand_valid[STRATEGY_ARBITRAGE] = tick_valid_d2 && strategy_enable[0] && arb_opportunity;
+assign cand_valid[STRATEGY_MARKET_MAKING] = tick_valid_d2 && strategy_enable[1] && mm_quote_valid;
+assign cand_valid[STRATEGY_TWAP] = tick_valid_d2 && strategy_enable[2] && twap_active && twap_time_slice &&
+                                   (twap_executed < twap_target_vol);
+assign cand_valid[STRATEGY_MOMENTUM] = tick_valid_d2 && strategy_enable[3] && momentum_signal;
+
+// Arbitrage: buy at the cheaper venue's ask, sell at the richer venue's bid
+assign cand_entry[STRATEGY_ARBITRAGE*ENTRY_WIDTH +: ENTRY_WIDTH] =
+    {tick_time_d2, 1'b1, arb_sell_venue, arb_sell_price, arb_buy_venue, 3'b001, 1'b0, 32'd1000, arb_buy_price,
+     tick_symbol_d2};
+// Market making: bid quote
+assign cand_entry[STRATEGY_MARKET_MAKING*ENTRY_WIDTH +: ENTRY_WIDTH] =
+    {tick_time_d2, 1'b0, {VENUE_BITS{1'b0}}, {PRICE_WIDTH{1'b0}}, tick_venue_d2, 3'b001, 1'b0, mm_bid_volume,
+     mm_bid_price, tick_symbol_d2};
+// TWAP: market buy of one slice
+assign cand_entry[STRATEGY_TWAP*ENTRY_WIDTH +: ENTRY_WIDTH] =
+    {tick_time_d2, 1'b0, {VENUE_BITS{1'b0}}, {PRICE_WIDTH{1'b0}}, tick_venue_d2, 3'b000, 1'b0, twap_slice_size,
+     tick_price_d2, tick_symbol_d2};
+// Momentum: market order, buy on an up move, sell on a down move
+assign cand_entry[STRATEGY_MOMENTUM*ENTRY_WIDTH +: ENTRY_WIDTH] =
+    {tick_time_d2, 1'b0, {VENUE_BITS{1'b0}}, {PRICE_WIDTH{1'b0}}, tick_venue_d2, 3'b000, (tick_price_d2 < last_price_d2),
+     32'd500, tick_price_d2, tick_symbol_d2};
+
+// Per-strategy order FIFOs. A strategy may only be granted when its FIFO is
+// non-empty and its rate limiter has run out; a candidate that finds its
+// FIFO full (and not being popped) is dropped and counted.
+wire [STRATEGY_COUNT-1:0] queue_eligible;
+wire [STRATEGY_COUNT-1:0] queue_drop;
+wire [STRATEGY_COUNT*ENTRY_WIDTH-1:0] queue_head;
+reg [STRATEGY_COUNT-1:0] grant;
+
+genvar s;
+generate
+    for (s = 0; s < STRATEGY_COUNT; s = s + 1) begin : strategy_queue
+        reg [ENTRY_WIDTH-1:0]   entry [0:ORDER_FIFO_DEPTH-1];
+        reg [FIFO_BITS-1:0]     rd_ptr, wr_ptr;
+        reg [FIFO_BITS:0]       count;
+        reg [15:0]              gap_timer;
+        reg [31:0]              decisions, orders;
+        
+        wire pop = grant[s];
+        wire push = cand_valid[s] && (count != ORDER_FIFO_DEPTH || pop);
+        
+        always @(posedge clk or negedge rst_n) begin
+            if (!rst_n) begin
+                rd_ptr <= {FIFO_BITS{1'b0}};
+                wr_ptr <= {FIFO_BITS{1'b0}};
+                count <= {(FIFO_BITS+1){1'b0}};
+                gap_timer <= 16'b0;
+                decisions <= 32'b0;
+                orders <= 32'b0;
+            end else begin
+                if (push) begin
+                    entry[wr_ptr] <= cand_entry[s*ENTRY_WIDTH +: ENTRY_WIDTH];
+                    wr_ptr <= wr_ptr + 1;
+                end
+                if (pop) begin
+                    rd_ptr <= rd_ptr + 1;
+                end
+                count <= count + push - pop;
+                
+                if (pop) begin
+                    gap_timer <= strategy_min_gap[s*16 +: 16];
+                end else if (gap_timer != 0) begin
+                    gap_timer <= gap_timer - 1;
+                end
+                
+                if (cand_valid[s]) begin
+                    decisions <= decisions + 1;
+                end
+                if (pop) begin
+                    orders <= orders + (entry[rd_ptr][E_PAIRED] ? 32'd2 : 32'd1);
+                end
+            end
+        end
+        
+        assign queue_eligible[s] = (count != 0) && (gap_timer == 0);
+        assign queue_drop[s] = cand_valid[s] && !push;
+        assign queue_head[s*ENTRY_WIDTH +: ENTRY_WIDTH] = entry[rd_ptr];
+        assign strategy_decisions[s*32 +: 32] = decisions;
+        assign strategy_orders[s*32 +: 32] = orders;
+    end
+endgenerate
+
+// Arbiter: one order per cycle. Fixed priority favours the lowest strategy
+// index (arbitrage first); round-robin starts after the last grant. No
+// grant while the second leg of a paired order owns the output, or while
+// the output holds an order order_ready has not taken.
+wire order_free = !order_valid || order_ready;
+
+integer gi, gs;
+reg grant_found;
+reg [7:0] grant_index, rr_next;
+reg [ENTRY_WIDTH-1:0] grant_entry;
+
+always @(*) begin
+    grant = {STRATEGY_COUNT{1'b0}};
+    grant_found = 1'b0;
+    grant_index = 8'd0;
+    grant_entry = {ENTRY_WIDTH{1'b0}};
+    for (gi = 0; gi < STRATEGY_COUNT; gi = gi + 1) begin
+        gs = (arbiter_mode == ARBITER_ROUND_ROBIN) ? (rr_next + gi) % STRATEGY_COUNT : gi;
+        if (!grant_found && !leg_pending && order_free && queue_eligible[gs]) begin
+            grant[gs] = 1'b1;
+            grant_found = 1'b1;
+            grant_index = gs[7:0];
+            grant_entry = queue_head[gs*ENTRY_WIDTH +: ENTRY_WIDTH];
+        end
+    end
+end
+
+function [3:0] count_ones;
+    input [STRATEGY_COUNT-1:0] bits;
+    integer b;
+    begin
+        count_ones = 4'd0;
+        for (b = 0; b < STRATEGY_COUNT; b = b + 1) begin
+            count_ones = count_ones + bits[b];
+        end
+    end
+endfunction
 
 // Main strategy execution
 always @(posedge clk or negedge rst_n) begin
@@ -111,12 +423,11 @@ always @(posedge clk or negedge rst_n) begin
         // Reset all registers
         decision_counter <= 32'b0;
         order_gen_counter <= 32'b0;
+        drop_counter <= 32'b0;
         active_strategy_mask <= 16'b0;
         price_history_ptr <= 4'b0;
-        last_price <= {PRICE_WIDTH{1'b0}};
         
         // Reset strategy states
-        mm_state <= 2'b00;
         mm_quote_valid <= 1'b0;
         twap_timer <= 32'b0;
         twap_executed <= {VOLUME_WIDTH{1'b0}};
@@ -127,7 +438,9 @@ always @(posedge clk or negedge rst_n) begin
         tick_valid_d2 <= 1'b0;
         
         order_valid <= 1'b0;
-        strategy_decision_valid <= 1'b0;
+        arb_profit <= {PRICE_WIDTH{1'b0}};
+        leg_pending <= 1'b0;
+        rr_next <= 8'd0;
         
         // Initialize price history
         for (i = 0; i < 16; i = i + 1) begin
@@ -146,153 +459,83 @@ always @(posedge clk or negedge rst_n) begin
         tick_bid_d2 <= tick_bid_d1;
         tick_ask_d1 <= tick_ask;
         tick_ask_d2 <= tick_ask_d1;
+        tick_venue_d1 <= tick_venue;
+        tick_venue_d2 <= tick_venue_d1;
+        tick_time_d1 <= tick_time;
+        tick_time_d2 <= tick_time_d1;
+        last_price_d2 <= (last_rd_valid && last_rd_symbol == tick_symbol_d1) ? last_rd_price : tick_price_d1;
         
         // Update price history
         if (tick_valid) begin
             price_history[price_history_ptr] <= tick_price;
             price_history_ptr <= price_history_ptr + 1;
-            last_price <= tick_price;
         end
         
-        // Strategy execution pipeline
-        order_valid <= 1'b0;
-        strategy_decision_valid <= 1'b0;
-        
         if (tick_valid_d2) begin
             decision_counter <= decision_counter + 1;
-            
-            // Strategy selection based on market conditions
-            if (strategy_enable[0] && arb_opportunity) begin
-                selected_strategy <= STRATEGY_ARBITRAGE;
-                strategy_decision_valid <= 1'b1;
-            end else if (strategy_enable[1] && mm_quote_valid) begin
-                selected_strategy <= STRATEGY_MARKET_MAKING;
-                strategy_decision_valid <= 1'b1;
-            end else if (strategy_enable[2] && twap_active && twap_time_slice) begin
-                selected_strategy <= STRATEGY_TWAP;
-                strategy_decision_valid <= 1'b1;
-            end else if (strategy_enable[3] && momentum_signal) begin
-                selected_strategy <= STRATEGY_MOMENTUM;
-                strategy_decision_valid <= 1'b1;
-            end
         end
+        drop_counter <= drop_counter + count_ones(queue_drop);
         
-        // Execute selected strategy
-        if (strategy_decision_valid) begin
-            case (selected_strategy)
-                STRATEGY_ARBITRAGE: begin
-                    execute_arbitrage();
-                end
-                
-                STRATEGY_MARKET_MAKING: begin
-                    execute_market_making();
-                end
-                
-                STRATEGY_TWAP: begin
-                    execute_twap();
-                end
-                
-                STRATEGY_MOMENTUM: begin
-                    execute_momentum();
-                end
-            endcase
+        // TWAP progress counts from the moment a slice is queued
+        if (cand_valid[STRATEGY_TWAP] && !queue_drop[STRATEGY_TWAP]) begin
+            twap_executed <= twap_executed + twap_slice_size;
         end
         
-        // Update strategy states
-        update_arbitrage_state();
-        update_market_making_state();
-        update_twap_state();
+        // Order output: the pending second leg, else the arbiter's grant
+        if (order_free) order_valid <= 1'b0;
         
-        // Update active strategies mask
-        active_strategy_mask <= {12'b0, strategy_enable};
-    end
-end
-
-// Arbitrage detection logic
-assign arb_profit = (tick_ask_d2 > tick_bid_d2) ? (tick_ask_d2 - tick_bid_d2) : 32'b0;
-assign arb_opportunity = (arb_profit > arb_min_profit) && (current_position < position_limit);
-
-// Market making time slice
-assign twap_time_slice = (twap_timer > 0) && ((twap_timer % (twap_duration / 100)) == 0);
-
-// Momentum signal (simplified)
-wire [PRICE_WIDTH-1:0] price_change;
-wire momentum_signal;
-assign price_change = (tick_price_d2 > last_price) ? (tick_price_d2 - last_price) : 
-                     (last_price - tick_price_d2);
-assign momentum_signal = (price_change > (tick_price_d2 >> 7));  // 0.78% threshold
-
-// Strategy execution tasks
-task execute_arbitrage;
-    begin
-        if (arb_profit > arb_min_profit) begin
-            order_valid <= 1'b1;
-            order_symbol <= tick_symbol_d2;
-            order_price <= tick_bid_d2;
-            order_volume <= 32'd1000;  // Fixed size for simplicity
-            order_side <= 1'b0;  // Buy
-            order_type <= 3'b001;  // Limit order
-            
-            order_gen_counter <= order_gen_counter + 1;
-        end
-    end
-endtask
-
-task execute_market_making;
-    begin
-        if (mm_quote_valid) begin
-            // Generate bid order
+        if (leg_pending && order_free) begin
             order_valid <= 1'b1;
-            order_symbol <= tick_symbol_d2;
-            order_price <= mm_bid_price;
-            order_volume <= mm_bid_volume;
-            order_side <= 1'b0;  // Buy
-            order_type <= 3'b001;  // Limit order
+            order_price <= leg_price;
+            order_side <= ~order_side;
+            order_venue <= leg_venue;
+            leg_pending <= 1'b0;
             
             order_gen_counter <= order_gen_counter + 1;
-        end
-    end
-endtask
-
-task execute_twap;
-    begin
-        if (twap_active && (twap_executed < twap_target_vol)) begin
+        end else if (grant_found) begin
             order_valid <= 1'b1;
-            order_symbol <= tick_symbol_d2;
-            order_price <= tick_price_d2;
-            order_volume <= twap_slice_size;
-            order_side <= 1'b0;  // Buy (could be parameterized)
-            order_type <= 3'b000;  // Market order
-            
-            twap_executed <= twap_executed + twap_slice_size;
-            order_gen_counter <= order_gen_counter + 1;
-        end
-    end
-endtask
-
-task execute_momentum;
-    begin
-        if (momentum_signal) begin
-            order_valid <= 1'b1;
-            order_symbol <= tick_symbol_d2;
-            order_price <= tick_price_d2;
-            order_volume <= 32'd500;  // Fixed size
-            order_side <= (price_change > 0) ? 1'b0 : 1'b1;  // Buy on up move, sell on down
-            order_type <= 3'b000;  // Market order
+            order_symbol <= grant_entry[E_SYMBOL +: SYMBOL_WIDTH];
+            order_price <= grant_entry[E_PRICE +: PRICE_WIDTH];
+            order_volume <= grant_entry[E_VOLUME +: VOLUME_WIDTH];
+            order_side <= grant_entry[E_SIDE];
+            order_type <= grant_entry[E_TYPE +: 3];
+            order_venue <= grant_entry[E_VENUE +: VENUE_BITS];
+            order_tick_time <= grant_entry[E_TIME +: 64];
+            leg_price <= grant_entry[E_LEG_PRICE +: PRICE_WIDTH];
+            leg_venue <= grant_entry[E_LEG_VENUE +: VENUE_BITS];
+            leg_pending <= grant_entry[E_PAIRED];
+            rr_next <= (grant_index + 1) % STRATEGY_COUNT;
             
             order_gen_counter <= order_gen_counter + 1;
         end
+        
+        // Update strategy states
+        update_arbitrage_state();
+        update_market_making_state();
+        update_twap_state();
+        
+        // Update active strategies mask
+        active_strategy_mask <= {12'b0, strategy_enable};
     end
-endtask
+end
 
 // Strategy state update tasks
 task update_arbitrage_state;
     begin
-        // Store prices for cross-symbol arbitrage
-        arb_price_1 <= tick_price_d1;
-        arb_symbol_1 <= tick_symbol_d1;
-        arb_price_2 <= tick_price_d2;
-        arb_symbol_2 <= tick_symbol_d2;
+        // Register the better of the two directions for the tick entering d2
+        if (sell_away_profit >= buy_away_profit) begin
+            arb_profit <= sell_away_profit;
+            arb_buy_price <= tick_ask_d1;
+            arb_buy_venue <= tick_venue_d1;
+            arb_sell_price <= best_bid_d1;
+            arb_sell_venue <= best_bid_venue_d1;
+        end else begin
+            arb_profit <= buy_away_profit;
+            arb_buy_price <= best_ask_d1;
+            arb_buy_venue <= best_ask_venue_d1;
+            arb_sell_price <= tick_bid_d1;
+            arb_sell_venue <= tick_venue_d1;
+        end
     end
 endtask
 
@@ -8,29 +8,253 @@ Features:
 - Performance analysis
 - Report generation
 - Waveform analysis
-- Regression testing
+- Regression testing, job-parallel with cached Verilator builds
+- Parameter and seed matrix sweeps
+- JSON benchmark results, gated against a stored baseline
 """
 
 import os
+import re
 import sys
 import subprocess
 import time
 import json
 import argparse
 import shutil
+import struct
+import hashlib
+import itertools
+import threading
+import concurrent.futures
 from pathlib import Path
 from typing import Dict, List, Optional, Tuple
 
+# Binary tick file layout, see cpp_testbench/tick_file.h
+TICK_FILE_MAGIC = b"VTTICKS\0"
+TICK_FILE_HEADER = struct.Struct("<8sIIQQI28x")
+TICK_FILE_SYMBOL = struct.Struct("<I12s")
+TICK_RECORD_FIELDS = [
+    ("timestamp", "<u8"), ("symbol_code", "<u4"), ("price", "<u4"), ("volume", "<u4"),
+    ("bid", "<u4"), ("ask", "<u4"), ("msg_type", "u1"), ("reserved", "u1", (3,)),
+]
+
+def read_tick_file(path: str):
+    """Map a binary tick file without parsing it.
+
+    Returns (symbols, ticks) where symbols maps code -> name and ticks is a
+    read-only numpy structured memmap over the records.
+    """
+    import numpy as np
+
+    with open(path, "rb") as f:
+        header = f.read(TICK_FILE_HEADER.size)
+        if len(header) < TICK_FILE_HEADER.size:
+            raise ValueError(f"{path}: not a tick file")
+        magic, version, record_size, count, data_offset, symbol_count = TICK_FILE_HEADER.unpack(header)
+        dtype = np.dtype(TICK_RECORD_FIELDS)
+        if magic != TICK_FILE_MAGIC or version != 1 or record_size != dtype.itemsize:
+            raise ValueError(f"{path}: unsupported tick file (version {version}, record size {record_size})")
+
+        symbols = {}
+        for _ in range(symbol_count):
+            code, name = TICK_FILE_SYMBOL.unpack(f.read(TICK_FILE_SYMBOL.size))
+            symbols[code] = name.rstrip(b"\0").decode("ascii", "replace")
+
+    ticks = np.memmap(path, dtype=dtype, mode="r", offset=data_offset, shape=(count,))
+    return symbols, ticks
+
+def print_tick_file_info(path: str):
+    """Summarise a tick file: record count, symbols and time span"""
+    symbols, ticks = read_tick_file(path)
+    print(f"Tick file: {path}")
+    print(f"  Records: {len(ticks)}")
+    print(f"  Symbols: {', '.join(f'{name} (0x{code:08x})' for code, name in symbols.items())}")
+    if len(ticks):
+        span_us = int(ticks["timestamp"][-1]) - int(ticks["timestamp"][0])
+        print(f"  Time span: {span_us} us")
+
+# Regression tests. "top" is the testbench module and "dut" the instance
+# matrix parameters are applied to; "dut_rtl" declares its parameters.
+TESTS = [
+    {
+        "name": "market_data_tb",
+        "rtl_files": ["rtl/market_data_processor.v"],
+        "tb_file": "testbench/market_data_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "market_data_wide_tb",
+        "rtl_files": ["rtl/market_data_processor_wide.v"],
+        "tb_file": "testbench/market_data_wide_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "order_manager_tb",
+        "rtl_files": ["rtl/order_manager.v"],
+        "tb_file": "testbench/order_manager_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "trading_strategy_tb",
+        "rtl_files": ["rtl/trading_strategy.v"],
+        "tb_file": "testbench/trading_strategy_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "latency_histogram_tb",
+        "rtl_files": ["rtl/latency_histogram.v"],
+        "tb_file": "testbench/latency_histogram_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "hjb_calculator_tb",
+        "rtl_files": ["rtl/hjb_calculator.v"],
+        "tb_file": "testbench/hjb_calculator_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "hjb_calculator_pipelined_tb",
+        "rtl_files": ["rtl/hjb_calculator_pipelined.v"],
+        "tb_file": "testbench/hjb_calculator_pipelined_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "hjb_calculator_fixed_tb",
+        "rtl_files": ["rtl/hjb_calculator_fixed.v"],
+        "tb_file": "testbench/hjb_calculator_fixed_tb.v",
+        "cpp_file": None,
+    },
+    {
+        "name": "sharded_trading_system_tb",
+        "rtl_files": [
+            "rtl/market_data_processor.v",
+            "rtl/trading_strategy.v",
+            "rtl/order_manager.v",
+            "rtl/sharded_trading_system.v"
+        ],
+        "tb_file": "testbench/sharded_trading_system_tb.v",
+        "cpp_file": None,
+        "dut_rtl": "rtl/sharded_trading_system.v",
+    },
+    {
+        "name": "fpga_trading_system_tb",
+        "rtl_files": [
+            "rtl/market_data_processor.v",
+            "rtl/market_data_processor_wide.v",
+            "rtl/order_manager.v",
+            "rtl/trading_strategy.v",
+            "rtl/latency_histogram.v",
+            "rtl/sharded_trading_system.v"
+        ],
+        # The C++ testbench drives the integration top, not the Verilog
+        # testbench around it
+        "tb_file": "testbench/fpga_trading_system_top.v",
+        "cpp_file": "cpp_testbench/fpga_trading_system_test.cpp",
+        "top": "fpga_trading_system_top",
+        "iverilog": False,              # integration runs under Verilator only
+    },
+]
+
+
+def declared_parameters(rtl_file: str) -> set:
+    """Names of the parameters a Verilog file declares"""
+    try:
+        text = Path(rtl_file).read_text()
+    except OSError:
+        return set()
+    return set(re.findall(r"\bparameter\s+(?:\[[^\]]*\]\s*)?(\w+)", text))
+
+
+def job_label(test_name: str, params: Dict[str, str], seed: Optional[int]) -> str:
+    """Result key for one test run, e.g. order_manager_tb[MAX_ORDERS=256]"""
+    tags = [f"{k}={v}" for k, v in sorted(params.items())]
+    if seed is not None:
+        tags.append(f"seed={seed}")
+    return f"{test_name}[{','.join(tags)}]" if tags else test_name
+
+
+def flatten_bench(bench: Dict) -> Dict[str, float]:
+    """section.metric -> value for a testbench --json report"""
+    flat = {}
+    for section, metrics in bench.items():
+        if isinstance(metrics, dict):
+            for key, value in metrics.items():
+                if isinstance(value, (int, float)):
+                    flat[f"{section}.{key}"] = value
+    return flat
+
+
+def gated_direction(metric: str) -> int:
+    """+1 for simulated throughputs (higher is better), -1 for tail latencies
+    in cycles (lower is better), 0 for metrics that are reported but not
+    gated. Wall-clock rates ("ticks_per_second", "cycles_per_second", ...)
+    measure the host, not the design, so they are never gated."""
+    key = metric.rsplit(".", 1)[-1]
+    if key.startswith("simulated_") and key.endswith("_per_second"):
+        return 1
+    if key.startswith("p99_") and key.endswith("_cycles"):
+        return -1
+    return 0
+
+
+def compare_benchmarks(current: Dict[str, Dict], baseline: Dict[str, Dict],
+                       max_throughput_drop: float, max_p99_rise: float,
+                       p99_slack_cycles: float = 0.0) -> List[Dict]:
+    """Gated metrics of every benchmark present in both runs. A row fails
+    when a throughput fell by more than its threshold (%), or a p99 rose by
+    more than its threshold (%) and by more than p99_slack_cycles, so a
+    one-cycle move on a small p99 is not a regression."""
+    rows = []
+    for label, bench in current.items():
+        if label not in baseline:
+            continue
+        base = flatten_bench(baseline[label])
+        for metric, value in flatten_bench(bench).items():
+            direction = gated_direction(metric)
+            if direction == 0 or metric not in base:
+                continue
+            old = base[metric]
+            if direction > 0:
+                if old == 0:
+                    continue            # no relative change to gate on
+                change = (value - old) / abs(old) * 100.0
+                failed = -change > max_throughput_drop
+            else:
+                rise = value - old
+                change = rise / abs(old) * 100.0 if old else 0.0
+                failed = rise > p99_slack_cycles and (old == 0 or change > max_p99_rise)
+            rows.append({"benchmark": label, "metric": metric, "baseline": old,
+                         "current": value, "change_pct": change, "failed": failed})
+    return rows
+
+
+def load_baseline(path: str) -> Dict[str, Dict]:
+    """Benchmarks from a baseline file: a saved baseline or report (label ->
+    bench under "benchmarks"), or a single testbench --json file"""
+    with open(path) as f:
+        data = json.load(f)
+    if "benchmarks" in data:
+        return data["benchmarks"]
+    return {"fpga_trading_system_tb": data}
+
+
 class SimulationRunner:
     """Main simulation runner class"""
     
-    def __init__(self, work_dir: str = "sim"):
+    def __init__(self, work_dir: str = "sim", build_cache: bool = True):
         self.work_dir = Path(work_dir)
         self.work_dir.mkdir(exist_ok=True)
+        self.cache_dir = self.work_dir / "verilator_cache"
+        self.build_cache = build_cache
         self.results = {}
         self.start_time = None
+        # One lock per build key, so parallel jobs sharing a model build it once
+        self.build_locks: Dict[str, threading.Lock] = {}
+        self.build_locks_guard = threading.Lock()
+        self.print_lock = threading.Lock()
+        self.comparison = None
         
-    def run_command(self, command: str, timeout: int = 300) -> Tuple[int, str, str]:
+    def run_command(self, command: str, timeout: int = 300, cwd: Optional[Path] = None) -> Tuple[int, str, str]:
         """Execute a command with timeout"""
         try:
             result = subprocess.run(
@@ -39,7 +263,7 @@ class SimulationRunner:
                 capture_output=True, 
                 text=True, 
                 timeout=timeout,
-                cwd=str(self.work_dir.parent)
+                cwd=str(cwd if cwd is not None else self.work_dir.parent)
             )
             return result.returncode, result.stdout, result.stderr
         except subprocess.TimeoutExpired:
@@ -47,16 +271,35 @@ class SimulationRunner:
         except Exception as e:
             return -1, "", str(e)
     
-    def run_iverilog_test(self, test_name: str, rtl_files: List[str], tb_file: str) -> Dict:
+    def job_dir(self, simulator: str, label: str) -> Path:
+        """Private run directory, so concurrent jobs never share VCDs or outputs"""
+        safe = re.sub(r"[^\w.=-]+", "_", label)
+        path = self.work_dir / "jobs" / simulator / safe
+        path.mkdir(parents=True, exist_ok=True)
+        return path.resolve()
+    
+    def run_iverilog_test(self, test_name: str, rtl_files: List[str], tb_file: str,
+                          params: Optional[Dict[str, str]] = None, label: Optional[str] = None) -> Dict:
         """Run Icarus Verilog test"""
-        print(f"Running Icarus Verilog test: {test_name}")
+        label = label or test_name
+        with self.print_lock:
+            print(f"Running Icarus Verilog test: {label}")
+        run_dir = self.job_dir("iverilog", label)
+        
+        # Matrix parameters go in as hierarchical defparams on the DUT
+        # instance; a defparam overrides the testbench's own #() values
+        sources = [str(Path(f).resolve()) for f in rtl_files + [tb_file]]
+        if params:
+            param_file = run_dir / "matrix_params.v"
+            lines = [f"    defparam {test_name}.dut.{k} = {v};" for k, v in sorted(params.items())]
+            param_file.write_text("module matrix_params;\n" + "\n".join(lines) + "\nendmodule\n")
+            sources.append(str(param_file))
         
         # Compile
-        rtl_list = " ".join(rtl_files)
-        compile_cmd = f"iverilog -g2012 -Wall -o {self.work_dir}/{test_name} {rtl_list} {tb_file}"
+        compile_cmd = f"iverilog -g2012 -Wall -o {test_name} {' '.join(sources)}"
         
         start_time = time.time()
-        ret_code, stdout, stderr = self.run_command(compile_cmd)
+        ret_code, stdout, stderr = self.run_command(compile_cmd, cwd=run_dir)
         compile_time = time.time() - start_time
         
         if ret_code != 0:
@@ -68,9 +311,8 @@ class SimulationRunner:
             }
         
         # Run simulation
-        run_cmd = f"cd {self.work_dir} && vvp {test_name}"
         start_time = time.time()
-        ret_code, stdout, stderr = self.run_command(run_cmd)
+        ret_code, stdout, stderr = self.run_command(f"vvp {test_name}", cwd=run_dir)
         run_time = time.time() - start_time
         
         # Parse results
@@ -82,131 +324,224 @@ class SimulationRunner:
             "phase": "simulation",
             "compile_time": compile_time,
             "run_time": run_time,
+            "params": params or {},
             "output": stdout,
             "error": stderr if stderr else None
         }
     
+    def build_key(self, command: str, files: List[str]) -> str:
+        """Hash of the Verilator command and every source it reads. C++
+        builds also hash the headers next to the testbench source."""
+        digest = hashlib.sha256(command.encode())
+        inputs = sorted(set(files))
+        for extra in list(inputs):
+            if extra.endswith(".cpp"):
+                inputs += sorted(str(h) for h in Path(extra).parent.glob("*.h"))
+        for path in inputs:
+            digest.update(path.encode())
+            try:
+                digest.update(Path(path).read_bytes())
+            except OSError:
+                pass
+        return digest.hexdigest()[:16]
+    
     def run_verilator_test(self, test_name: str, rtl_files: List[str], 
-                          tb_file: str, cpp_file: Optional[str] = None) -> Dict:
+                          tb_file: str, cpp_file: Optional[str] = None,
+                          seed: Optional[int] = None, label: Optional[str] = None,
+                          top: Optional[str] = None) -> Dict:
         """Run Verilator test"""
-        print(f"Running Verilator test: {test_name}")
+        label = label or test_name
+        top = top or test_name
+        with self.print_lock:
+            print(f"Running Verilator test: {label}")
         
-        # Build command
+        # Build command. Testbench-only tests use --binary (Verilog main,
+        # --timing for delays); seeded runs build with randomised X values
         rtl_list = " ".join(rtl_files)
-        verilator_cmd = f"verilator --cc --exe --build --trace -Wall -Wno-fatal"
-        
         if cpp_file:
-            verilator_cmd += f" {rtl_list} {tb_file} {cpp_file}"
+            flags = "--cc --exe --build --trace -Wall -Wno-fatal"
+            sources = f"{rtl_list} {tb_file} {cpp_file}"
         else:
-            verilator_cmd += f" {rtl_list} {tb_file}"
+            flags = "--binary --trace -Wall -Wno-fatal"
+            sources = f"{rtl_list} {tb_file}"
+        if seed is not None:
+            flags += " --x-assign unique --x-initial unique"
+        flags += f" --top-module {top}"
+        
+        key = self.build_key(f"{flags} {sources}", rtl_files + [tb_file] + ([cpp_file] if cpp_file else []))
+        mdir = self.cache_dir / key
+        binary = mdir / f"V{top}"
+        
+        with self.build_locks_guard:
+            lock = self.build_locks.setdefault(key, threading.Lock())
         
         start_time = time.time()
-        ret_code, stdout, stderr = self.run_command(verilator_cmd)
+        cached = False
+        with lock:
+            if self.build_cache and binary.exists():
+                cached = True
+            else:
+                if mdir.exists():
+                    shutil.rmtree(mdir)
+                ret_code, stdout, stderr = self.run_command(f"verilator {flags} --Mdir {mdir} {sources}")
+                if ret_code != 0:
+                    shutil.rmtree(mdir, ignore_errors=True)
+                    return {
+                        "status": "FAILED",
+                        "phase": "build",
+                        "build_time": time.time() - start_time,
+                        "error": stderr
+                    }
         build_time = time.time() - start_time
         
-        if ret_code != 0:
-            return {
-                "status": "FAILED",
-                "phase": "build",
-                "build_time": build_time,
-                "error": stderr
-            }
-        
-        # Run simulation
+        # Run simulation. C++ testbenches also write their benchmark JSON
+        run_dir = self.job_dir("verilator", label)
+        run_cmd = str(binary.resolve())
         if cpp_file:
-            run_cmd = f"./obj_dir/V{test_name}"
-        else:
-            run_cmd = f"./obj_dir/V{test_name.replace('_tb', '')}"
+            run_cmd += " --json=bench.json"
+        if seed is not None:
+            run_cmd += f" +verilator+seed+{seed} +verilator+rand+reset+2"
         
         start_time = time.time()
-        ret_code, stdout, stderr = self.run_command(run_cmd)
+        ret_code, stdout, stderr = self.run_command(run_cmd, cwd=run_dir)
         run_time = time.time() - start_time
         
+        bench = None
+        if cpp_file and (run_dir / "bench.json").exists():
+            with open(run_dir / "bench.json") as f:
+                bench = json.load(f)
+        
         # Parse results
         passed = "PASSED" in stdout or "✓" in stdout
         failed = "FAILED" in stdout or "✗" in stdout
         
         return {
+            "bench": bench,
             "status": "PASSED" if passed and not failed else "FAILED",
             "phase": "simulation",
             "build_time": build_time,
+            "build_cached": cached,
+            "build_key": key,
             "run_time": run_time,
+            "seed": seed,
             "output": stdout,
             "error": stderr if stderr else None
         }
     
-    def run_all_tests(self, simulator: str = "both") -> Dict:
-        """Run all tests"""
+    def plan_jobs(self, simulator: str, matrix: Dict[str, List[str]], seeds: List[int]) -> List[Dict]:
+        """Expand the test table into jobs. Matrix parameters fan out the
+        Icarus runs of tests whose DUT declares them; seeds fan out the
+        Verilator runs (X randomisation)."""
+        jobs = []
+        for test in TESTS:
+            if simulator in ["iverilog", "both"] and test.get("iverilog", True):
+                declared = declared_parameters(test.get("dut_rtl", test["rtl_files"][0]))
+                axes = {k: v for k, v in matrix.items() if k in declared}
+                names = sorted(axes)
+                for values in itertools.product(*(axes[n] for n in names)):
+                    params = dict(zip(names, values))
+                    jobs.append({"simulator": "iverilog", "test": test, "params": params,
+                                 "seed": None, "label": job_label(test["name"], params, None)})
+            if simulator in ["verilator", "both"]:
+                for seed in (seeds or [None]):
+                    jobs.append({"simulator": "verilator", "test": test, "params": {},
+                                 "seed": seed, "label": job_label(test["name"], {}, seed)})
+        return jobs
+    
+    def run_job(self, job: Dict) -> Dict:
+        test = job["test"]
+        if job["simulator"] == "iverilog":
+            return self.run_iverilog_test(test["name"], test["rtl_files"], test["tb_file"],
+                                          job["params"], job["label"])
+        return self.run_verilator_test(test["name"], test["rtl_files"], test["tb_file"],
+                                       test["cpp_file"], job["seed"], job["label"], test.get("top"))
+    
+    def run_all_tests(self, simulator: str = "both", jobs: int = 1,
+                      matrix: Optional[Dict[str, List[str]]] = None,
+                      seeds: Optional[List[int]] = None) -> Dict:
+        """Run all tests, on a pool of `jobs` workers"""
         print("=" * 50)
         print("FPGA Trading System Simulation Suite")
         print("=" * 50)
         
         self.start_time = time.time()
+        planned = self.plan_jobs(simulator, matrix or {}, seeds or [])
+        for sim in ["iverilog", "verilator"]:
+            if any(job["simulator"] == sim for job in planned):
+                self.results[sim] = {}
+        print(f"\n{len(planned)} jobs on {jobs} worker{'s' if jobs != 1 else ''}...")
+        
+        def finish(job, result):
+            self.results[job["simulator"]][job["label"]] = result
+            cached = " (cached build)" if result.get("build_cached") else ""
+            with self.print_lock:
+                print(f"  {job['simulator']} {job['label']}: {result['status']}{cached}")
+        
+        if jobs <= 1:
+            for job in planned:
+                finish(job, self.run_job(job))
+        else:
+            with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+                futures = {pool.submit(self.run_job, job): job for job in planned}
+                for future in concurrent.futures.as_completed(futures):
+                    finish(futures[future], future.result())
         
-        # Test configurations
-        tests = [
-            {
-                "name": "market_data_tb",
-                "rtl_files": ["rtl/market_data_processor.v"],
-                "tb_file": "testbench/market_data_tb.v",
-                "cpp_file": None
-            },
-            {
-                "name": "order_manager_tb",
-                "rtl_files": ["rtl/order_manager.v"],
-                "tb_file": "testbench/order_manager_tb.v",
-                "cpp_file": None
-            },
-            {
-                "name": "trading_strategy_tb",
-                "rtl_files": ["rtl/trading_strategy.v"],
-                "tb_file": "testbench/trading_strategy_tb.v",
-                "cpp_file": None
-            },
-            {
-                "name": "fpga_trading_system_tb",
-                "rtl_files": [
-                    "rtl/market_data_processor.v",
-                    "rtl/order_manager.v",
-                    "rtl/trading_strategy.v"
-                ],
-                "tb_file": "testbench/fpga_trading_system_tb.v",
-                "cpp_file": "cpp_testbench/fpga_trading_system_test.cpp"
-            }
-        ]
-        
-        # Run tests
-        if simulator in ["iverilog", "both"]:
-            print("\nRunning Icarus Verilog tests...")
-            self.results["iverilog"] = {}
-            for test in tests:
-                if test["name"] != "fpga_trading_system_tb":  # Skip integration for basic tests
-                    result = self.run_iverilog_test(
-                        test["name"], 
-                        test["rtl_files"], 
-                        test["tb_file"]
-                    )
-                    self.results["iverilog"][test["name"]] = result
-                    print(f"  {test['name']}: {result['status']}")
-        
-        if simulator in ["verilator", "both"]:
-            print("\nRunning Verilator tests...")
-            self.results["verilator"] = {}
-            for test in tests:
-                result = self.run_verilator_test(
-                    test["name"], 
-                    test["rtl_files"], 
-                    test["tb_file"],
-                    test["cpp_file"]
-                )
-                self.results["verilator"][test["name"]] = result
-                print(f"  {test['name']}: {result['status']}")
+        # Report in plan order whatever order the jobs finished in
+        for sim in ["iverilog", "verilator"]:
+            if sim in self.results:
+                order = [job["label"] for job in planned if job["simulator"] == sim]
+                self.results[sim] = {label: self.results[sim][label] for label in order}
         
         total_time = time.time() - self.start_time
         self.results["total_time"] = total_time
         
         return self.results
     
+    def benchmarks(self) -> Dict[str, Dict]:
+        """Benchmark JSON of every run that produced one, by label"""
+        return {
+            label: result["bench"]
+            for sim_results in self.results.values() if isinstance(sim_results, dict)
+            for label, result in sim_results.items() if result.get("bench")
+        }
+    
+    def compare_baseline(self, baseline_file: str, max_throughput_drop: float, max_p99_rise: float,
+                         p99_slack_cycles: float = 0.0) -> bool:
+        """Gate this run's benchmarks against a baseline. Returns True when
+        no throughput or p99 degraded past its threshold."""
+        print("\n" + "=" * 50)
+        print(f"BENCHMARK GATE (baseline: {baseline_file})")
+        print("=" * 50)
+        
+        rows = compare_benchmarks(self.benchmarks(), load_baseline(baseline_file),
+                                  max_throughput_drop, max_p99_rise, p99_slack_cycles)
+        self.comparison = {
+            "baseline": baseline_file,
+            "max_throughput_drop_pct": max_throughput_drop,
+            "max_p99_rise_pct": max_p99_rise,
+            "p99_slack_cycles": p99_slack_cycles,
+            "metrics": rows
+        }
+        if not rows:
+            print("No benchmark metrics in common with the baseline")
+            return False
+        
+        for row in rows:
+            mark = "❌" if row["failed"] else "✅"
+            print(f"  {mark} {row['benchmark']} {row['metric']}: {row['baseline']:g} -> "
+                  f"{row['current']:g} ({row['change_pct']:+.1f}%)")
+        failures = sum(1 for row in rows if row["failed"])
+        print(f"\n{failures} of {len(rows)} gated metrics regressed "
+              f"(throughput -{max_throughput_drop:g}%, p99 +{max_p99_rise:g}% "
+              f"or +{p99_slack_cycles:g} cycles allowed)")
+        return failures == 0
+    
+    def save_baseline(self, output_file: str):
+        """Store this run's benchmarks as the baseline for later runs"""
+        with open(output_file, 'w') as f:
+            json.dump({"timestamp": time.time(), "benchmarks": self.benchmarks()}, f, indent=2)
+        print(f"Baseline saved to {output_file}")
+    
     def generate_report(self, output_file: str = "simulation_report.json"):
         """Generate detailed test report"""
         print("\nGenerating test report...")
@@ -235,8 +570,11 @@ class SimulationRunner:
         # Write report
         report = {
             "summary": summary,
+            "benchmarks": self.benchmarks(),
             "detailed_results": self.results
         }
+        if self.comparison is not None:
+            report["baseline_comparison"] = self.comparison
         
         with open(output_file, 'w') as f:
             json.dump(report, f, indent=2)
@@ -295,6 +633,13 @@ class SimulationRunner:
                 print(f"\n{simulator.upper()} Performance:")
                 
                 for test_name, result in self.results[simulator].items():
+                    if result.get("bench"):
+                        # Structured results; no need to scrape the output
+                        flat = flatten_bench(result["bench"])
+                        for metric in sorted(flat):
+                            if gated_direction(metric) != 0:
+                                print(f"  {test_name}: {metric} = {flat[metric]:g}")
+                        continue
                     if result["status"] == "PASSED" and result.get("output"):
                         output = result["output"]
                         
@@ -321,15 +666,60 @@ def main():
     parser.add_argument("--report", default="simulation_report.json", 
                        help="Report output file")
     parser.add_argument("--verbose", action="store_true", help="Verbose output")
+    parser.add_argument("--tick-info", metavar="FILE",
+                       help="Summarise a binary tick file and exit")
+    parser.add_argument("-j", "--jobs", type=int, default=1,
+                       help="Tests run concurrently (0 = one per CPU)")
+    parser.add_argument("--matrix", action="append", default=[], metavar="PARAM=V1,V2",
+                       help="Sweep a DUT parameter over the Icarus runs (repeatable)")
+    parser.add_argument("--seeds", default="", metavar="S1,S2",
+                       help="Verilator runs per seed, with randomised X initialisation")
+    parser.add_argument("--no-build-cache", action="store_true",
+                       help="Rebuild Verilator models even if a build with the same sources exists")
+    parser.add_argument("--baseline", metavar="FILE",
+                       help="Fail if benchmark throughput or p99 latency regressed against FILE")
+    parser.add_argument("--save-baseline", metavar="FILE",
+                       help="Store this run's benchmark results as a baseline")
+    parser.add_argument("--max-throughput-drop", type=float, default=10.0, metavar="PCT",
+                       help="Allowed throughput drop against the baseline (default: 10)")
+    parser.add_argument("--max-p99-rise", type=float, default=10.0, metavar="PCT",
+                       help="Allowed p99 latency rise against the baseline (default: 10)")
+    parser.add_argument("--p99-slack-cycles", type=float, default=2.0, metavar="CYCLES",
+                       help="p99 rise in cycles always allowed, whatever the percentage (default: 2)")
     
     args = parser.parse_args()
     
+    if args.tick_info:
+        print_tick_file_info(args.tick_info)
+        return
+    
+    matrix = {}
+    for entry in args.matrix:
+        name, _, values = entry.partition("=")
+        if not name or not values:
+            parser.error(f"--matrix expects PARAM=V1,V2, got {entry!r}")
+        matrix[name] = values.split(",")
+    seeds = [int(s) for s in args.seeds.split(",") if s]
+    if args.baseline and not Path(args.baseline).is_file():
+        # No baseline is checked in; it has to come from a run on this machine
+        parser.error(f"baseline {args.baseline} not found; record one with make bench-baseline "
+                     f"or --save-baseline")
+    jobs = args.jobs if args.jobs > 0 else (os.cpu_count() or 1)
+    
     # Create runner
-    runner = SimulationRunner(args.work_dir)
+    runner = SimulationRunner(args.work_dir, build_cache=not args.no_build_cache)
     
     try:
         # Run tests
-        results = runner.run_all_tests(args.simulator)
+        results = runner.run_all_tests(args.simulator, jobs, matrix, seeds)
+        
+        # Gate against the baseline before the report, so it records the result
+        gate_passed = True
+        if args.baseline:
+            gate_passed = runner.compare_baseline(args.baseline, args.max_throughput_drop, args.max_p99_rise,
+                                                 args.p99_slack_cycles)
+        if args.save_baseline:
+            runner.save_baseline(args.save_baseline)
         
         # Generate report
         runner.generate_report(args.report)
@@ -348,7 +738,9 @@ def main():
             for result in sim_results.values()
         )
         
-        sys.exit(0 if all_passed else 1)
+        if not gate_passed:
+            print("\nPerformance regression against the baseline")
+        sys.exit(0 if all_passed and gate_passed else 1)
         
     except KeyboardInterrupt:
         print("\nSimulation interrupted by user")
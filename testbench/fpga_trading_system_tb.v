@@ -3,9 +3,11 @@
  * Complete system test with all modules integrated
  * 
  * Features:
- * - End-to-end trading pipeline
+ * - End-to-end trading pipeline (fpga_trading_system_top)
  * - Real-time market data simulation
  * - Performance measurement
+ * - On-chip tick-to-trade latency histogram, dumped at the end of the run
+ * - Sharded multi-lane system on the same feed, swept over lane counts
  * - System-level verification
  */
 
@@ -21,13 +23,16 @@ module fpga_trading_system_tb;
     reg                 market_data_valid;
     reg [63:0]          market_data_in;
     reg [7:0]           market_data_type;
+    reg                 market_data_last;   // final beat of a multi-beat ITCH message
+    reg  [1:0]          tick_venue;         // single feed
+    wire                data_ready;
     
     // System outputs
     wire                order_execution_valid;
     wire [31:0]         execution_symbol;
     wire [31:0]         execution_price;
     wire [31:0]         execution_volume;
-    wire [7:0]          execution_type;
+    wire                execution_side;
     
     // Performance monitoring
     wire [31:0]         total_trades;
@@ -35,23 +40,51 @@ module fpga_trading_system_tb;
     wire [31:0]         avg_latency;
     wire [31:0]         max_latency;
     
-    // Risk monitoring
-    wire                risk_violation;
-    wire [31:0]         portfolio_value;
-    wire [31:0]         position_exposure;
+    // Cross-module timestamps: a free-running cycle counter stamps each tick
+    // on ingress and the stamp travels with it to the execution
+    wire [63:0]         timebase;
+    wire [31:0]         execution_latency;
+    wire                execution_latency_valid;
+    
+    // Latency histogram register interface
+    reg                 hist_clear;
+    reg                 hist_rd_en;
+    reg  [7:0]          hist_addr;
+    wire                hist_rd_valid;
+    wire [31:0]         hist_rd_data;
     
-    // Internal signals
-    wire                parsed_order_valid;
-    wire [31:0]         parsed_symbol;
-    wire [31:0]         parsed_price;
-    wire [31:0]         parsed_volume;
-    wire [7:0]          parsed_type;
+    // Sharded system on the same market data feed, with its own reset so
+    // the lane count can change between phases
+    localparam SHARD_LANES = 16;
+    reg                 shard_rst_n;
+    reg  [3:0]          shard_lane_bits;
+    reg                 main_feed_enable;
+    wire                shard_exec_valid;
+    wire [7:0]          shard_exec_lane;
+    wire [31:0]         shard_exec_symbol;
+    wire [31:0]         shard_ticks_routed;
+    wire [31:0]         shard_exec_dropped;
+    wire [SHARD_LANES*32-1:0] shard_lane_ticks;
+    wire [SHARD_LANES*32-1:0] shard_lane_orders;
+    wire [SHARD_LANES*32-1:0] shard_lane_accepted;
+    wire [SHARD_LANES*32-1:0] shard_lane_executions;
     
-    wire                strategy_signal_valid;
-    wire [31:0]         strategy_symbol;
-    wire [31:0]         strategy_price;
-    wire [31:0]         strategy_volume;
-    wire [7:0]          strategy_type;
+    // Per-module statistics counters
+    wire [31:0]         md_packets_processed;
+    wire [31:0]         md_parse_errors;
+    wire [31:0]         strategy_orders_generated;
+    wire [31:0]         strategy_orders_dropped;
+    wire [31:0]         om_orders_processed;
+    wire [31:0]         om_orders_filled;
+    wire [31:0]         om_orders_rejected;
+    wire [15:0]         om_order_fifo_peak;
+    wire [31:0]         om_order_fifo_stall_cycles;
+    wire [31:0]         om_symbol_table_rejects;
+    
+    // Risk monitoring
+    wire                risk_violation;
+    wire [31:0]         risk_code;
+    wire [31:0]         position_pnl;
     
     // Test variables
     integer test_count;
@@ -72,71 +105,60 @@ module fpga_trading_system_tb;
         forever #2 clk = ~clk;
     end
     
-    // Market Data Processor
-    market_data_processor market_processor (
+    // The trading system, shared with the Verilator C++ testbench
+    fpga_trading_system_top #(
+        .SHARD_LANES(SHARD_LANES)
+    ) dut (
         .clk(clk),
         .rst_n(rst_n),
-        .data_valid(market_data_valid),
-        .data_in(market_data_in),
-        .data_type(market_data_type),
-        .data_ready(),
-        .order_valid(parsed_order_valid),
-        .order_symbol(parsed_symbol),
-        .order_price(parsed_price),
-        .order_volume(parsed_volume),
-        .order_type(parsed_type),
-        .book_update_valid(),
-        .book_symbol(),
-        .book_bid(),
-        .book_ask(),
-        .book_volume(),
-        .error_flag(),
-        .error_code()
-    );
-    
-    // Trading Strategy Engine
-    trading_strategy strategy_engine (
-        .clk(clk),
-        .rst_n(rst_n),
-        .market_data_valid(parsed_order_valid),
-        .market_symbol(parsed_symbol),
-        .market_price(parsed_price),
-        .market_volume(parsed_volume),
-        .market_bid(parsed_price - 32'h00100000),
-        .market_ask(parsed_price + 32'h00100000),
-        .signal_valid(strategy_signal_valid),
-        .signal_symbol(strategy_symbol),
-        .signal_price(strategy_price),
-        .signal_volume(strategy_volume),
-        .signal_type(strategy_type),
-        .signal_confidence(),
-        .risk_check_valid(),
-        .risk_exposure(position_exposure),
-        .risk_pnl()
-    );
-    
-    // Order Manager
-    order_manager order_mgr (
-        .clk(clk),
-        .rst_n(rst_n),
-        .order_valid(strategy_signal_valid),
-        .order_symbol(strategy_symbol),
-        .order_price(strategy_price),
-        .order_volume(strategy_volume),
-        .order_type(strategy_type),
-        .order_id(32'h12345678),
-        .order_ready(),
-        .execution_valid(order_execution_valid),
-        .execution_id(),
+        .market_data_valid(market_data_valid),
+        .market_data_in(market_data_in),
+        .market_data_type(market_data_type),
+        .market_data_last(market_data_last),
+        .tick_venue(tick_venue),
+        .data_ready(data_ready),
+        .timebase(timebase),
+        .order_execution_valid(order_execution_valid),
+        .execution_symbol(execution_symbol),
         .execution_price(execution_price),
         .execution_volume(execution_volume),
-        .execution_status(execution_type),
+        .execution_side(execution_side),
+        .execution_latency(execution_latency),
+        .execution_latency_valid(execution_latency_valid),
         .risk_violation(risk_violation),
-        .risk_code(),
-        .position_update(),
-        .position_symbol(execution_symbol),
-        .position_size(),
-        .position_pnl()
+        .risk_code(risk_code),
+        .position_pnl(position_pnl),
+        .hist_clear(hist_clear),
+        .hist_rd_en(hist_rd_en),
+        .hist_addr(hist_addr),
+        .hist_rd_valid(hist_rd_valid),
+        .hist_rd_data(hist_rd_data),
+        .shard_rst_n(shard_rst_n),
+        .shard_lane_bits(shard_lane_bits),
+        .main_feed_enable(main_feed_enable),
+        .shard_exec_valid(shard_exec_valid),
+        .shard_exec_lane(shard_exec_lane),
+        .shard_exec_symbol(shard_exec_symbol),
+        .shard_ticks_routed(shard_ticks_routed),
+        .shard_exec_dropped(shard_exec_dropped),
+        .shard_lane_ticks(shard_lane_ticks),
+        .shard_lane_orders(shard_lane_orders),
+        .shard_lane_accepted(shard_lane_accepted),
+        .shard_lane_executions(shard_lane_executions),
+        .md_packets_processed(md_packets_processed),
+        .md_parse_errors(md_parse_errors),
+        .strategy_orders_generated(strategy_orders_generated),
+        .strategy_orders_dropped(strategy_orders_dropped),
+        .om_orders_processed(om_orders_processed),
+        .om_orders_filled(om_orders_filled),
+        .om_orders_rejected(om_orders_rejected),
+        .om_order_fifo_peak(om_order_fifo_peak),
+        .om_order_fifo_stall_cycles(om_order_fifo_stall_cycles),
+        .om_symbol_table_rejects(om_symbol_table_rejects),
+        .probe_parse_state(),
+        .probe_order_stage(),
+        .probe_order_fifo_level(),
+        .probe_mm_quote_valid()
     );
     
     // Performance Monitor
@@ -158,6 +180,14 @@ module fpga_trading_system_tb;
         market_data_valid = 0;
         market_data_in = 0;
         market_data_type = 0;
+        market_data_last = 1;
+        tick_venue = 0;
+        shard_rst_n = 1;
+        shard_lane_bits = 0;
+        main_feed_enable = 1;
+        hist_clear = 0;
+        hist_rd_en = 0;
+        hist_addr = 0;
         test_count = 0;
         pass_count = 0;
         fail_count = 0;
@@ -199,6 +229,9 @@ module fpga_trading_system_tb;
         // Test 7: System reliability
         test_system_reliability();
         
+        // Test 8: Sharded lanes
+        test_sharded_scaling();
+        
         system_end_time = $time;
         
         // Final system summary
@@ -221,6 +254,8 @@ module fpga_trading_system_tb;
             $display("Maximum System Latency: %d ns", max_latency * 4);
         end
         
+        dump_latency_histogram();
+        
         if (fail_count == 0) begin
             $display("\n🎉 ALL SYSTEM TESTS PASSED!");
             $display("System is ready for deployment!");
@@ -238,10 +273,17 @@ module fpga_trading_system_tb;
             $display("\nTest 1: End-to-End Trading Flow");
             test_count = test_count + 1;
             
-            // Send ITCH Add Order message
+            // Reference price: a symbol's first tick never trades
             market_data_type = 8'h41;  // 'A' - Add Order
             market_data_in = {32'h41415054, 32'h96000000}; // AAPL $150.00
             market_data_valid = 1;
+            @(posedge clk);
+            market_data_valid = 0;
+            repeat(10) @(posedge clk);
+            
+            // 1% up move: a momentum buy
+            market_data_in = {32'h41415054, 32'h97800000};
+            market_data_valid = 1;
             tick_to_execution_start = $time;
             
             @(posedge clk);
@@ -262,7 +304,7 @@ module fpga_trading_system_tb;
                 fail_count = fail_count + 1;
             end
             
-            total_market_ticks = total_market_ticks + 1;
+            total_market_ticks = total_market_ticks + 2;
             @(posedge clk);
         end
     endtask
@@ -463,6 +505,148 @@ module fpga_trading_system_tb;
         end
     endtask
     
+    // Executions leaving the sharded system's merge
+    integer shard_executions;
+    initial shard_executions = 0;
+    always @(posedge clk) begin
+        if (shard_exec_valid) shard_executions = shard_executions + 1;
+    end
+    
+    // Same tick stream at 1, 2, 4, 8 and 16 lanes: 64 symbols, one tick per
+    // cycle, each tick 1% away from its symbol's previous price. The main
+    // pipeline's feed is off for the sweep, so its symbol table and counters
+    // are left as the other tests expect them.
+    task test_sharded_scaling();
+        integer lane_bits, lanes, i, l, start_cycle, cycles, executions_before;
+        integer busiest, orders, accepted, lane_sum, failures_before;
+        integer main_processed, main_rejected;
+        begin
+            $display("\nTest 8: Sharded Lanes");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+            main_processed = om_orders_processed;
+            main_rejected = om_orders_rejected;
+            main_feed_enable = 0;
+            
+            for (lane_bits = 0; lane_bits <= 4; lane_bits = lane_bits + 1) begin
+                lanes = 1 << lane_bits;
+                shard_lane_bits = lane_bits;
+                shard_rst_n = 0;
+                @(posedge clk);
+                shard_rst_n = 1;
+                @(posedge clk);
+                
+                executions_before = shard_executions;
+                start_cycle = timebase;
+                for (i = 0; i < 2000; i = i + 1) begin
+                    market_data_type = 8'h41;
+                    market_data_in = {32'h53000000 + (i % 64), ((i / 64) % 2) ? 32'h97800000 : 32'h96000000};
+                    market_data_valid = 1;
+                    @(posedge clk);
+                end
+                market_data_valid = 0;
+                cycles = timebase - start_cycle;
+                repeat(100) @(posedge clk);
+                
+                busiest = 0;
+                orders = 0;
+                accepted = 0;
+                lane_sum = 0;
+                for (l = 0; l < lanes; l = l + 1) begin
+                    lane_sum = lane_sum + shard_lane_ticks[l*32 +: 32];
+                    orders = orders + shard_lane_orders[l*32 +: 32];
+                    accepted = accepted + shard_lane_accepted[l*32 +: 32];
+                    if (shard_lane_executions[l*32 +: 32] > busiest) busiest = shard_lane_executions[l*32 +: 32];
+                end
+                
+                $display("  %2d lanes: %0d executions in %0d cycles (%0d.%02d per cycle), %0d of %0d orders accepted, busiest lane %0d, %0d dropped at merge",
+                         lanes, shard_executions - executions_before, cycles,
+                         (shard_executions - executions_before) / cycles,
+                         ((shard_executions - executions_before) * 100 / cycles) % 100,
+                         accepted, orders, busiest, shard_exec_dropped);
+                
+                if (lane_sum != shard_ticks_routed) begin
+                    $display("  ✗ %0d lanes: %0d of %0d routed ticks reached a lane", lanes, lane_sum, shard_ticks_routed);
+                    fail_count = fail_count + 1;
+                end
+            end
+            main_feed_enable = 1;
+            
+            if (om_orders_processed != main_processed || om_orders_rejected != main_rejected) begin
+                $display("  ✗ Main order manager saw the sweep: %0d orders accepted, %0d rejected",
+                         om_orders_processed - main_processed, om_orders_rejected - main_rejected);
+                fail_count = fail_count + 1;
+            end
+            
+            if (fail_count == failures_before) begin
+                $display("  ✓ Sharded system swept over lane counts");
+                pass_count = pass_count + 1;
+            end
+            total_market_ticks = total_market_ticks + 10000;
+        end
+    endtask
+    
+    // One latency histogram register, read back the cycle after the strobe
+    task read_hist_register;
+        input  [7:0]  addr;
+        output [31:0] value;
+        begin
+            hist_addr = addr;
+            hist_rd_en = 1;
+            @(posedge clk);
+            hist_rd_en = 0;
+            @(posedge clk);
+            value = hist_rd_data;
+        end
+    endtask
+    
+    // Lowest latency counted in a bucket (see latency_histogram.v)
+    function [31:0] bucket_low;
+        input integer index;
+        input integer sub_bits;
+        integer offset, half;
+        begin
+            half = 1 << (sub_bits - 1);
+            if (index < (1 << sub_bits)) begin
+                bucket_low = index;
+            end else begin
+                offset = index - (1 << sub_bits);
+                bucket_low = ((offset % half) + half) << (offset / half + 1);
+            end
+        end
+    endfunction
+    
+    task dump_latency_histogram;
+        reg [31:0] config_word, samples, min_cycles, max_cycles, sum_lo, sum_hi, clamped, count;
+        integer b, buckets, sub_bits;
+        begin
+            read_hist_register(8'hF0, config_word);
+            read_hist_register(8'hF1, samples);
+            read_hist_register(8'hF2, min_cycles);
+            read_hist_register(8'hF3, max_cycles);
+            read_hist_register(8'hF4, sum_lo);
+            read_hist_register(8'hF5, sum_hi);
+            read_hist_register(8'hF6, clamped);
+            buckets = config_word[15:0];
+            sub_bits = config_word[31:24];
+            
+            $display("\nOn-chip Tick-to-Trade Latency Histogram (%0d buckets)", buckets);
+            if (samples == 0) begin
+                $display("  No executions recorded");
+            end else begin
+                $display("  Samples: %0d, min %0d, mean %0d, max %0d cycles, %0d beyond range",
+                         samples, min_cycles, {sum_hi, sum_lo} / samples, max_cycles, clamped);
+                for (b = 0; b < buckets; b = b + 1) begin
+                    read_hist_register(b[7:0], count);
+                    if (count != 0) begin
+                        $display("  %6d - %6d cycles: %0d", bucket_low(b, sub_bits),
+                                 (b + 1 < buckets) ? bucket_low(b + 1, sub_bits) - 1 : 32'hFFFFFFFF, count);
+                    end
+                end
+            end
+        end
+    endtask
+    
     // System monitoring
     always @(posedge clk) begin
         if (order_execution_valid) begin
@@ -471,8 +655,8 @@ module fpga_trading_system_tb;
         end
         
         if (risk_violation) begin
-            $display("System Risk Alert: Portfolio=%h, Exposure=%h", 
-                     portfolio_value, position_exposure);
+            $display("System Risk Alert: Code=%0d, PnL=%h", 
+                     risk_code, position_pnl);
         end
     end
 
@@ -0,0 +1,336 @@
+/*
+ * FPGA Trading System Integration Top
+ * The full pipeline with a real port list, shared by the Verilog
+ * integration testbench and the Verilator C++ testbench
+ *
+ * Features:
+ * - market_data_processor -> trading_strategy -> order_manager, handshaked
+ *   with valid/ready, order IDs from a running sequence and the net
+ *   position fed back to the strategy
+ * - Free-running timebase: each tick is stamped on ingress and the stamp
+ *   travels with it to the execution's exec_latency
+ * - On-chip tick-to-trade latency histogram with its register interface
+ * - Sharded multi-lane system on the same feed, with its own reset so the
+ *   lane count can change between phases, and a feed enable that keeps its
+ *   sweeps out of the main pipeline
+ * - Per-module statistics counters and internal state taps (probe_*) for
+ *   the C++ benchmark report and signal sampler
+ *
+ * Strategy and risk configuration are fixed: momentum, so a tick that
+ * moves its symbol's price by more than 0.78% becomes a market order;
+ * cross-venue arbitrage, so a tick whose bid crosses another venue's ask
+ * (or the reverse) becomes a paired limit buy and sell; and risk checks on
+ * with a per-symbol position limit. Arbitrage needs quotes from two venues,
+ * so it stays quiet on a feed that holds tick_venue at 0.
+ */
+
+`timescale 1ns / 1ps
+
+module fpga_trading_system_top #(
+    parameter SHARD_LANES = 16
+) (
+    input  wire                     clk,
+    input  wire                     rst_n,
+
+    // Market data input
+    input  wire                     market_data_valid,
+    input  wire [63:0]              market_data_in,
+    input  wire [7:0]               market_data_type,
+    input  wire                     market_data_last,   // final beat of a multi-beat ITCH message
+    input  wire [1:0]               tick_venue,         // venue of the ticks leaving the parser; hold until the tick is out
+    output wire                     data_ready,
+
+    output reg  [63:0]              timebase,
+
+    // Executions, one-cycle pulse per fill
+    output wire                     order_execution_valid,
+    output wire [31:0]              execution_symbol,
+    output wire [31:0]              execution_price,
+    output wire [31:0]              execution_volume,
+    output wire                     execution_side,
+    output wire [31:0]              execution_latency,
+    output wire                     execution_latency_valid,
+
+    // Risk monitoring
+    output wire                     risk_violation,
+    output wire [31:0]              risk_code,
+    output wire [31:0]              position_pnl,
+
+    // Latency histogram register interface
+    input  wire                     hist_clear,
+    input  wire                     hist_rd_en,
+    input  wire [7:0]               hist_addr,
+    output wire                     hist_rd_valid,
+    output wire [31:0]              hist_rd_data,
+
+    // Sharded system
+    input  wire                     main_feed_enable,   // 0 feeds the sharded system alone
+    input  wire                     shard_rst_n,
+    input  wire [3:0]               shard_lane_bits,
+    output wire                     shard_exec_valid,
+    output wire [7:0]               shard_exec_lane,
+    output wire [31:0]              shard_exec_symbol,
+    output wire [31:0]              shard_ticks_routed,
+    output wire [31:0]              shard_exec_dropped,
+    output wire [SHARD_LANES*32-1:0] shard_lane_ticks,
+    output wire [SHARD_LANES*32-1:0] shard_lane_orders,
+    output wire [SHARD_LANES*32-1:0] shard_lane_accepted,
+    output wire [SHARD_LANES*32-1:0] shard_lane_executions,
+
+    // Per-module statistics counters
+    output wire [31:0]              md_packets_processed,
+    output wire [31:0]              md_parse_errors,
+    output wire [31:0]              strategy_orders_generated,
+    output wire [31:0]              strategy_orders_dropped,
+    output wire [31:0]              om_orders_processed,
+    output wire [31:0]              om_orders_filled,
+    output wire [31:0]              om_orders_rejected,
+    output wire [15:0]              om_order_fifo_peak,
+    output wire [31:0]              om_order_fifo_stall_cycles,
+    output wire [31:0]              om_symbol_table_rejects,
+
+    // Internal state taps: parse_state is {message decoding, beats being
+    // assembled}; order_stage is 0 with the match stage empty, 1 matching,
+    // 2 held for exec_ready
+    output wire [1:0]               probe_parse_state,
+    output wire [1:0]               probe_order_stage,
+    output wire [7:0]               probe_order_fifo_level,
+    output wire                     probe_mm_quote_valid
+);
+
+// Fixed configuration
+localparam [3:0]  STRATEGY_ENABLE = 4'b1001;        // momentum + arbitrage
+localparam [31:0] POSITION_LIMIT = 32'd100000;      // per symbol, shares
+localparam [31:0] MAX_ORDER_SIZE = 32'd10000;
+localparam        ORDER_FIFO_DEPTH = 4;
+localparam        FIFO_LEVEL_BITS = $clog2(ORDER_FIFO_DEPTH) + 1;  // order_mgr.fifo_level width
+
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) timebase <= 64'd0;
+    else timebase <= timebase + 64'd1;
+end
+
+// Parsed ticks
+wire                tick_valid;
+wire [31:0]         tick_symbol;
+wire [31:0]         tick_price;
+wire [31:0]         tick_volume;
+wire [31:0]         tick_bid;
+wire [31:0]         tick_ask;
+wire [63:0]         tick_time;
+
+// Strategy orders
+wire                order_valid;
+wire                order_ready;
+wire [31:0]         order_symbol;
+wire [31:0]         order_price;
+wire [31:0]         order_volume;
+wire                order_side;
+wire [2:0]          order_type;
+wire [63:0]         order_tick_time;
+
+wire                pos_update_valid;
+wire [31:0]         pos_quantity;
+wire                pos_side;
+
+reg  [31:0]         order_seq;
+reg  [31:0]         net_position;       // all symbols, fed back to the strategy
+
+market_data_processor market_processor (
+    .clk(clk),
+    .rst_n(rst_n),
+    .data_valid(market_data_valid && main_feed_enable),
+    .data_in(market_data_in),
+    .data_type(market_data_type),
+    .data_last(market_data_last),
+    .data_ready(data_ready),
+    .timebase(timebase),
+    .tick_valid(tick_valid),
+    .symbol(tick_symbol),
+    .price(tick_price),
+    .volume(tick_volume),
+    .bid(tick_bid),
+    .ask(tick_ask),
+    .timestamp(),
+    .ingress_time(tick_time),
+    .book_update_valid(),
+    .book_symbol(),
+    .book_price(),
+    .book_volume(),
+    .book_side(),
+    .book_action(),
+    .packets_processed(md_packets_processed),
+    .parse_errors(md_parse_errors),
+    .pipeline_depth()
+);
+
+trading_strategy strategy_engine (
+    .clk(clk),
+    .rst_n(rst_n),
+    .tick_valid(tick_valid),
+    .tick_symbol(tick_symbol),
+    .tick_price(tick_price),
+    .tick_bid(tick_bid),
+    .tick_ask(tick_ask),
+    .tick_volume(tick_volume),
+    .tick_venue(tick_venue),
+    .tick_time(tick_time),
+    .strategy_enable(STRATEGY_ENABLE),
+    .arb_min_profit(32'd0),
+    .mm_spread(32'd0),
+    .twap_target_vol(32'd0),
+    .twap_duration(32'd0),
+    .arbiter_mode(2'd0),                // fixed priority
+    .strategy_min_gap(64'd0),
+    .order_valid(order_valid),
+    .order_symbol(order_symbol),
+    .order_price(order_price),
+    .order_volume(order_volume),
+    .order_side(order_side),
+    .order_type(order_type),
+    .order_venue(),
+    .order_tick_time(order_tick_time),
+    .order_ready(order_ready),
+    .current_position(net_position),
+    .position_limit(POSITION_LIMIT),
+    .decisions_made(),
+    .orders_generated(strategy_orders_generated),
+    .active_strategies(),
+    .orders_dropped(strategy_orders_dropped),
+    .strategy_decisions(),
+    .strategy_orders()
+);
+
+order_manager #(
+    .ORDER_FIFO_DEPTH(ORDER_FIFO_DEPTH)
+) order_mgr (
+    .clk(clk),
+    .rst_n(rst_n),
+    .order_valid(order_valid),
+    .order_data(64'd0),
+    .order_symbol(order_symbol),
+    .order_price(order_price),
+    .order_volume(order_volume),
+    .order_side(order_side),
+    .order_type(order_type),
+    .order_id(order_seq),
+    .order_tick_time(order_tick_time),
+    .order_ready(order_ready),
+    .timebase(timebase),
+    .tick_valid(tick_valid),
+    .tick_symbol(tick_symbol),
+    .tick_price(tick_price),
+    .tick_bid(tick_bid),
+    .tick_ask(tick_ask),
+    .exec_valid(order_execution_valid),
+    .exec_order_id(),
+    .exec_symbol(execution_symbol),
+    .exec_price(execution_price),
+    .exec_volume(execution_volume),
+    .exec_side(execution_side),
+    .exec_timestamp(),
+    .exec_tick_time(),
+    .exec_latency(execution_latency),
+    .exec_latency_valid(execution_latency_valid),
+    .exec_ready(1'b1),
+    .pos_update_valid(pos_update_valid),
+    .pos_symbol(),
+    .pos_quantity(pos_quantity),
+    .pos_side(pos_side),
+    .risk_position_limit(POSITION_LIMIT),
+    .risk_max_order_size(MAX_ORDER_SIZE),
+    .risk_max_notional(64'hFFFFFFFFFFFFFFFF),
+    .risk_rate_burst(16'hFFFF),
+    .risk_rate_interval(32'd0),         // no throttle
+    .risk_enabled(1'b1),
+    .risk_violation(risk_violation),
+    .orders_processed(om_orders_processed),
+    .orders_filled(om_orders_filled),
+    .orders_rejected(om_orders_rejected),
+    .active_orders(),
+    .order_fifo_peak(om_order_fifo_peak),
+    .order_fifo_stall_cycles(om_order_fifo_stall_cycles),
+    .symbol_table_rejects(om_symbol_table_rejects),
+    .risk_code(risk_code),
+    .execution_status(),
+    .position_pnl(position_pnl)
+);
+
+always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+        order_seq <= 32'b0;
+        net_position <= 32'b0;
+    end else begin
+        if (order_valid && order_ready) order_seq <= order_seq + 1;
+        if (pos_update_valid) begin
+            net_position <= pos_side ? net_position - pos_quantity : net_position + pos_quantity;
+        end
+    end
+end
+
+assign probe_parse_state = {market_processor.s1_valid, market_processor.asm_beats != 4'd0};
+assign probe_order_stage = !order_mgr.current_valid ? 2'd0 :
+                           order_mgr.stage_advance  ? 2'd1 : 2'd2;
+assign probe_order_fifo_level = {{(8-FIFO_LEVEL_BITS){1'b0}}, order_mgr.fifo_level};
+assign probe_mm_quote_valid = strategy_engine.mm_quote_valid;
+
+latency_histogram #(
+    .LATENCY_WIDTH(16),
+    .SUB_BUCKET_BITS(4)
+) latency_hist (
+    .clk(clk),
+    .rst_n(rst_n),
+    .clear(hist_clear),
+    .sample_valid(execution_latency_valid),
+    .sample_latency(execution_latency),
+    .reg_rd_en(hist_rd_en),
+    .reg_addr(hist_addr),
+    .reg_rd_valid(hist_rd_valid),
+    .reg_rd_data(hist_rd_data)
+);
+
+// Same strategy as the main pipeline, without risk limits, so the sweep
+// measures how the lanes share the work
+sharded_trading_system #(
+    .NUM_LANES(SHARD_LANES)
+) sharded_system (
+    .clk(clk),
+    .rst_n(rst_n && shard_rst_n),
+    .data_valid(market_data_valid),
+    .data_in(market_data_in),
+    .data_type(market_data_type),
+    .data_last(market_data_last),
+    .data_ready(),
+    .timebase(timebase),
+    .cfg_lane_bits(shard_lane_bits),
+    .strategy_enable(STRATEGY_ENABLE),
+    .arb_min_profit(32'd0),
+    .mm_spread(32'd0),
+    .twap_target_vol(32'd0),
+    .twap_duration(32'd0),
+    .arbiter_mode(2'd0),
+    .strategy_min_gap(64'd0),
+    .position_limit(32'hFFFFFFFF),
+    .risk_enabled(1'b0),
+    .risk_position_limit(32'hFFFFFFFF),
+    .risk_max_order_size(32'hFFFFFFFF),
+    .risk_max_notional(64'hFFFFFFFFFFFFFFFF),
+    .risk_rate_burst(16'hFFFF),
+    .risk_rate_interval(32'd0),
+    .exec_valid(shard_exec_valid),
+    .exec_lane(shard_exec_lane),
+    .exec_symbol(shard_exec_symbol),
+    .exec_price(),
+    .exec_volume(),
+    .exec_side(),
+    .exec_tick_time(),
+    .exec_latency(),
+    .ticks_routed(shard_ticks_routed),
+    .exec_dropped(shard_exec_dropped),
+    .lane_ticks(shard_lane_ticks),
+    .lane_orders(shard_lane_orders),
+    .lane_accepted(shard_lane_accepted),
+    .lane_executions(shard_lane_executions)
+);
+
+endmodule
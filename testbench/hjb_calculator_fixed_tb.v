@@ -0,0 +1,212 @@
+// Testbench for the fixed-point HJB Calculator
+// Streams requests under three parameter sets that change from one request
+// to the next, and checks every quote against the Avellaneda-Stoikov
+// formulas evaluated in double precision
+`timescale 1ns/1ps
+
+module hjb_calculator_fixed_tb;
+    localparam NUM_REQUESTS = 256;
+    localparam STALL_CYCLES = 8;
+    localparam NUM_CONFIGS = 3;
+    localparam real TOLERANCE = 1.0e-4;     // price units
+
+    reg clk;
+    reg rst_n;
+    reg [63:0] cfg_gamma;
+    reg [63:0] cfg_two_over_gamma;
+    reg [63:0] cfg_inv_kappa;
+    reg in_valid;
+    wire in_ready;
+    reg [63:0] in_mid_price;
+    reg [31:0] in_inventory;
+    reg [63:0] in_volatility;
+    reg [31:0] in_tag;
+    wire out_valid;
+    reg out_ready;
+    wire [63:0] out_bid;
+    wire [63:0] out_ask;
+    wire [31:0] out_tag;
+    wire [31:0] latency_cycles;
+
+    // Clock generation
+    always #2 clk = ~clk; // 250MHz clock (4ns period)
+
+    // DUT instantiation
+    hjb_calculator_fixed dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .cfg_gamma(cfg_gamma),
+        .cfg_two_over_gamma(cfg_two_over_gamma),
+        .cfg_inv_kappa(cfg_inv_kappa),
+        .in_valid(in_valid),
+        .in_ready(in_ready),
+        .in_mid_price(in_mid_price),
+        .in_inventory(in_inventory),
+        .in_volatility(in_volatility),
+        .in_tag(in_tag),
+        .out_valid(out_valid),
+        .out_ready(out_ready),
+        .out_bid(out_bid),
+        .out_ask(out_ask),
+        .out_tag(out_tag),
+        .latency_cycles(latency_cycles)
+    );
+
+    // Non-negative real to Q32.32, 16 bits of fraction at a time since
+    // $rtoi returns a 32-bit signed integer
+    function [63:0] to_q;
+        input real value;
+        integer whole, frac_hi, frac_lo;
+        real frac;
+        begin
+            whole = $rtoi(value);
+            frac = (value - whole) * 65536.0;
+            frac_hi = $rtoi(frac);
+            frac_lo = $rtoi((frac - frac_hi) * 65536.0);
+            to_q = {whole[31:0], frac_hi[15:0], frac_lo[15:0]};
+        end
+    endfunction
+
+    function real from_q;
+        input [63:0] value;
+        begin
+            from_q = $signed(value) / 4294967296.0;
+        end
+    endfunction
+
+    // Parameter sets: ln argument 1.067 (the hjb_calculator constants),
+    // 1.625 and 9 (exponent 3)
+    real cfg_gamma_r [0:NUM_CONFIGS-1];
+    real cfg_kappa_r [0:NUM_CONFIGS-1];
+
+    // Request stimulus, kept so results can be checked against the tag
+    real req_mid [0:NUM_REQUESTS-1];
+    real req_vol [0:NUM_REQUESTS-1];
+    integer req_inv [0:NUM_REQUESTS-1];
+
+    integer sent, received, errors, cycles, i, c;
+    real gamma, kappa, gs2, reservation, spread, bid_error, ask_error, max_error;
+
+    initial begin
+        cfg_gamma_r[0] = 0.1;
+        cfg_kappa_r[0] = 1.5;
+        cfg_gamma_r[1] = 0.5;
+        cfg_kappa_r[1] = 0.8;
+        cfg_gamma_r[2] = 4.0;
+        cfg_kappa_r[2] = 0.5;
+
+        for (i = 0; i < NUM_REQUESTS; i = i + 1) begin
+            req_mid[i] = 100000.0 + i * 12.5;
+            req_vol[i] = 0.1 + (i % 41) * 0.01;
+            req_inv[i] = i - NUM_REQUESTS / 2;
+        end
+    end
+
+    // Drive one request per cycle whenever the pipeline is ready, with the
+    // parameter set chosen by the request index
+    always @(posedge clk) begin
+        if (rst_n) begin
+            if (in_valid && in_ready) sent = sent + 1;
+            if (sent < NUM_REQUESTS) begin
+                c = sent % NUM_CONFIGS;
+                in_valid <= 1'b1;
+                in_mid_price <= to_q(req_mid[sent]);
+                in_inventory <= req_inv[sent];
+                in_volatility <= to_q(req_vol[sent]);
+                in_tag <= sent;
+                cfg_gamma <= to_q(cfg_gamma_r[c]);
+                cfg_two_over_gamma <= to_q(2.0 / cfg_gamma_r[c]);
+                cfg_inv_kappa <= to_q(1.0 / cfg_kappa_r[c]);
+            end else begin
+                in_valid <= 1'b0;
+            end
+
+            // Back-pressure for a few cycles partway through the stream
+            out_ready <= !(cycles >= 64 && cycles < 64 + STALL_CYCLES);
+            cycles = cycles + 1;
+        end
+    end
+
+    // Check every result against the double-precision model, in order
+    always @(posedge clk) begin
+        if (rst_n && out_valid && out_ready) begin
+            gamma = cfg_gamma_r[out_tag % NUM_CONFIGS];
+            kappa = cfg_kappa_r[out_tag % NUM_CONFIGS];
+            gs2 = gamma * req_vol[out_tag] * req_vol[out_tag];
+            reservation = req_mid[out_tag] - req_inv[out_tag] * gs2;
+            spread = gs2 + (2.0 / gamma) * $ln(1.0 + gamma / kappa);
+            bid_error = from_q(out_bid) - (reservation - spread / 2.0);
+            ask_error = from_q(out_ask) - (reservation + spread / 2.0);
+            if (bid_error < 0) bid_error = -bid_error;
+            if (ask_error < 0) ask_error = -ask_error;
+            if (bid_error > max_error) max_error = bid_error;
+            if (ask_error > max_error) max_error = ask_error;
+
+            if (out_tag != received || bid_error > TOLERANCE || ask_error > TOLERANCE) begin
+                $display("  ✗ Mismatch for tag %0d (expected tag %0d): bid %f ask %f, expected %f %f",
+                         out_tag, received, from_q(out_bid), from_q(out_ask),
+                         reservation - spread / 2.0, reservation + spread / 2.0);
+                errors = errors + 1;
+            end
+            received = received + 1;
+        end
+    end
+
+    initial begin
+        // Initialize
+        clk = 0;
+        rst_n = 0;
+        cfg_gamma = 64'h0;
+        cfg_two_over_gamma = 64'h0;
+        cfg_inv_kappa = 64'h0;
+        in_valid = 0;
+        in_mid_price = 64'h0;
+        in_inventory = 32'h0;
+        in_volatility = 64'h0;
+        in_tag = 32'h0;
+        out_ready = 1;
+        sent = 0;
+        received = 0;
+        errors = 0;
+        cycles = 0;
+        max_error = 0.0;
+
+        // Reset
+        #10 rst_n = 1;
+
+        wait(received == NUM_REQUESTS);
+        @(posedge clk);
+
+        $display("Fixed-Point HJB Calculator Results:");
+        $display("Requests: %0d in %0d cycles (%0d stall cycles)", NUM_REQUESTS, cycles, STALL_CYCLES);
+        $display("Pipeline latency: %0d cycles (%0d ns)", latency_cycles, latency_cycles * 4);
+        $display("Max quote error vs double precision: %e", max_error);
+
+        // One quote per cycle apart from the stall window and pipeline fill
+        if (cycles > NUM_REQUESTS + STALL_CYCLES + latency_cycles + 2) begin
+            $display("  ✗ Throughput below one quote per cycle");
+            errors = errors + 1;
+        end
+
+        if (errors == 0) begin
+            $display("✓ Fixed-point HJB test PASSED");
+        end else begin
+            $display("✗ Fixed-point HJB test FAILED with %0d errors", errors);
+        end
+        $finish;
+    end
+
+    // VCD dump for waveform analysis
+    initial begin
+        $dumpfile("hjb_calculator_fixed.vcd");
+        $dumpvars(0, hjb_calculator_fixed_tb);
+    end
+
+    // Timeout
+    initial begin
+        #10000;
+        $display("ERROR: Simulation timeout");
+        $finish;
+    end
+
+endmodule
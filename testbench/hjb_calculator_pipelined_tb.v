@@ -0,0 +1,145 @@
+// Testbench for the pipelined HJB Calculator
+`timescale 1ns/1ps
+
+module hjb_calculator_pipelined_tb;
+    localparam NUM_REQUESTS = 256;
+    localparam STALL_CYCLES = 8;
+
+    reg clk;
+    reg rst_n;
+    reg in_valid;
+    wire in_ready;
+    reg [63:0] in_mid_price;
+    reg [31:0] in_inventory;
+    reg [63:0] in_volatility;
+    reg [31:0] in_tag;
+    wire out_valid;
+    reg out_ready;
+    wire [63:0] out_bid;
+    wire [63:0] out_ask;
+    wire [31:0] out_tag;
+    wire [31:0] latency_cycles;
+
+    // Clock generation
+    always #2 clk = ~clk; // 250MHz clock (4ns period)
+
+    // DUT instantiation
+    hjb_calculator_pipelined dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .in_valid(in_valid),
+        .in_ready(in_ready),
+        .in_mid_price(in_mid_price),
+        .in_inventory(in_inventory),
+        .in_volatility(in_volatility),
+        .in_tag(in_tag),
+        .out_valid(out_valid),
+        .out_ready(out_ready),
+        .out_bid(out_bid),
+        .out_ask(out_ask),
+        .out_tag(out_tag),
+        .latency_cycles(latency_cycles)
+    );
+
+    // Request stimulus, kept so results can be checked against the tag
+    reg [63:0] req_mid [0:NUM_REQUESTS-1];
+    reg [31:0] req_inv [0:NUM_REQUESTS-1];
+
+    integer sent, received, errors, cycles, i;
+    reg [63:0] expected_res, expected_half;
+
+    initial begin
+        for (i = 0; i < NUM_REQUESTS; i = i + 1) begin
+            req_mid[i] = $realtobits(100000.0 + i * 12.5);
+            req_inv[i] = i - NUM_REQUESTS / 2;
+        end
+    end
+
+    // Drive one request per cycle whenever the pipeline is ready
+    always @(posedge clk) begin
+        if (rst_n) begin
+            if (in_valid && in_ready) sent = sent + 1;
+            if (sent < NUM_REQUESTS) begin
+                in_valid <= 1'b1;
+                in_mid_price <= req_mid[sent];
+                in_inventory <= req_inv[sent];
+                in_volatility <= $realtobits(0.3);
+                in_tag <= sent;
+            end else begin
+                in_valid <= 1'b0;
+            end
+
+            // Back-pressure for a few cycles partway through the stream
+            out_ready <= !(cycles >= 64 && cycles < 64 + STALL_CYCLES);
+            cycles = cycles + 1;
+        end
+    end
+
+    // Check every result against the reference arithmetic, in order
+    always @(posedge clk) begin
+        if (rst_n && out_valid && out_ready) begin
+            expected_res = req_mid[out_tag] - ({32'h0, req_inv[out_tag]} << 10);
+            expected_half = (req_mid[out_tag] >> 7) >> 1;
+            if (out_tag != received ||
+                out_bid != expected_res - expected_half ||
+                out_ask != expected_res + expected_half) begin
+                $display("  ✗ Mismatch for tag %0d (expected tag %0d)", out_tag, received);
+                errors = errors + 1;
+            end
+            received = received + 1;
+        end
+    end
+
+    initial begin
+        // Initialize
+        clk = 0;
+        rst_n = 0;
+        in_valid = 0;
+        in_mid_price = 64'h0;
+        in_inventory = 32'h0;
+        in_volatility = 64'h0;
+        in_tag = 32'h0;
+        out_ready = 1;
+        sent = 0;
+        received = 0;
+        errors = 0;
+        cycles = 0;
+
+        // Reset
+        #10 rst_n = 1;
+
+        wait(received == NUM_REQUESTS);
+        @(posedge clk);
+
+        $display("Pipelined HJB Calculator Results:");
+        $display("Requests: %0d in %0d cycles (%0d stall cycles)", NUM_REQUESTS, cycles, STALL_CYCLES);
+        $display("Pipeline latency: %0d cycles (%0d ns)", latency_cycles, latency_cycles * 4);
+
+        // One quote per cycle apart from the stall window and pipeline fill
+        if (cycles > NUM_REQUESTS + STALL_CYCLES + latency_cycles + 2) begin
+            $display("  ✗ Throughput below one quote per cycle");
+            errors = errors + 1;
+        end
+
+        if (errors == 0) begin
+            $display("✓ Pipelined HJB test PASSED");
+        end else begin
+            $display("✗ Pipelined HJB test FAILED with %0d errors", errors);
+        end
+        $finish;
+    end
+
+    // VCD dump for waveform analysis
+    initial begin
+        $dumpfile("hjb_calculator_pipelined.vcd");
+        $dumpvars(0, hjb_calculator_pipelined_tb);
+    end
+
+    // Timeout
+    initial begin
+        #10000;
+        $display("ERROR: Simulation timeout");
+        $finish;
+    end
+
+endmodule
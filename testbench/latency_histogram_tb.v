@@ -0,0 +1,296 @@
+/*
+ * Latency Histogram Testbench
+ * Bucket layout, summary registers, saturation of out-of-range samples,
+ * back-to-back samples and clear, all read over the register interface
+ */
+
+`timescale 1ns / 1ps
+
+module latency_histogram_tb;
+
+    // Clock and reset
+    reg clk;
+    reg rst_n;
+
+    // DUT signals
+    reg                 clear;
+    reg                 sample_valid;
+    reg [31:0]          sample_latency;
+    reg                 reg_rd_en;
+    reg [7:0]           reg_addr;
+    wire                reg_rd_valid;
+    wire [31:0]         reg_rd_data;
+
+    // Test variables
+    integer test_count;
+    integer pass_count;
+    integer fail_count;
+
+    // Clock generation (250MHz)
+    initial begin
+        clk = 0;
+        forever #2 clk = ~clk;
+    end
+
+    // DUT instantiation: 16 exact buckets, then 8 per power of two up to 2^16
+    latency_histogram #(
+        .LATENCY_WIDTH(16),
+        .SUB_BUCKET_BITS(4)
+    ) dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .clear(clear),
+        .sample_valid(sample_valid),
+        .sample_latency(sample_latency),
+        .reg_rd_en(reg_rd_en),
+        .reg_addr(reg_addr),
+        .reg_rd_valid(reg_rd_valid),
+        .reg_rd_data(reg_rd_data)
+    );
+
+    // Register map
+    localparam REG_CONFIG = 8'hF0;
+    localparam REG_SAMPLES = 8'hF1;
+    localparam REG_MIN = 8'hF2;
+    localparam REG_MAX = 8'hF3;
+    localparam REG_SUM_LO = 8'hF4;
+    localparam REG_SUM_HI = 8'hF5;
+    localparam REG_CLAMPED = 8'hF6;
+
+    // Test stimulus
+    initial begin
+        // Initialize
+        rst_n = 0;
+        clear = 0;
+        sample_valid = 0;
+        sample_latency = 0;
+        reg_rd_en = 0;
+        reg_addr = 0;
+        test_count = 0;
+        pass_count = 0;
+        fail_count = 0;
+
+        // VCD dump
+        $dumpfile("latency_histogram_tb.vcd");
+        $dumpvars(0, latency_histogram_tb);
+
+        $display("======================================");
+        $display("Latency Histogram Testbench");
+        $display("======================================");
+
+        // Reset sequence
+        #10 rst_n = 1;
+        #10;
+
+        // Test 1: Configuration register
+        test_config();
+
+        // Test 2: Exact and logarithmic buckets
+        test_bucket_layout();
+
+        // Test 3: Summary registers and out-of-range samples
+        test_summary();
+
+        // Test 4: One sample per cycle into the same bucket
+        test_back_to_back();
+
+        // Test 5: Clear
+        test_clear();
+
+        // Test summary
+        $display("\n======================================");
+        $display("Test Summary");
+        $display("======================================");
+        $display("Total Tests: %d", test_count);
+        $display("Passed:      %d", pass_count);
+        $display("Failed:      %d", fail_count);
+
+        if (fail_count == 0) begin
+            $display("\nAll tests PASSED!");
+        end else begin
+            $display("\nSome tests FAILED!");
+        end
+
+        $finish;
+    end
+
+    // One sample on the next rising edge
+    task record;
+        input [31:0] latency;
+        begin
+            sample_latency = latency;
+            sample_valid = 1;
+            @(posedge clk);
+            sample_valid = 0;
+        end
+    endtask
+
+    // One register, read back the cycle after the strobe
+    task read_register;
+        input  [7:0]  addr;
+        output [31:0] value;
+        begin
+            reg_addr = addr;
+            reg_rd_en = 1;
+            @(posedge clk);
+            reg_rd_en = 0;
+            @(posedge clk);
+            value = reg_rd_data;
+        end
+    endtask
+
+    task expect_register;
+        input [8*24-1:0] name;
+        input [7:0]      addr;
+        input [31:0]     expected;
+        reg [31:0] value;
+        begin
+            read_register(addr, value);
+            if (value !== expected) begin
+                $display("  ✗ %0s: %0d (0x%h), expected %0d (0x%h)", name, value, value, expected, expected);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    task test_config();
+        begin
+            $display("\nTest 1: Configuration Register");
+            test_count = test_count + 1;
+
+            // 16 + (16 - 4) * 8 = 112 buckets
+            expect_register("config", REG_CONFIG, {8'd4, 8'd16, 16'd112});
+            expect_register("empty min", REG_MIN, 32'hFFFFFFFF);
+            expect_register("empty samples", REG_SAMPLES, 32'd0);
+            if (fail_count == 0) begin
+                $display("  ✓ 112 buckets, 4 sub-bucket bits, 16-bit range");
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    task test_bucket_layout();
+        integer failures_before;
+        begin
+            $display("\nTest 2: Bucket Layout");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+
+            // Exact below 16; then [16,17] [30,31] [32,35] [96,103] are
+            // buckets 16, 23, 24 and 36
+            record(0);
+            record(3);
+            record(15);
+            record(16);
+            record(17);
+            record(31);
+            record(32);
+            record(35);
+            record(100);
+            repeat(2) @(posedge clk);
+
+            expect_register("bucket 0", 8'd0, 32'd1);
+            expect_register("bucket 3", 8'd3, 32'd1);
+            expect_register("bucket 15", 8'd15, 32'd1);
+            expect_register("bucket 16", 8'd16, 32'd2);
+            expect_register("bucket 17", 8'd17, 32'd0);
+            expect_register("bucket 23", 8'd23, 32'd1);
+            expect_register("bucket 24", 8'd24, 32'd2);
+            expect_register("bucket 36", 8'd36, 32'd1);
+
+            if (fail_count == failures_before) begin
+                $display("  ✓ Exact buckets below 16 cycles, 8 per power of two above");
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    task test_summary();
+        integer failures_before;
+        begin
+            $display("\nTest 3: Summary Registers");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+
+            // 70000 is beyond 2^16: counted in the top bucket and as clamped
+            record(70000);
+            repeat(2) @(posedge clk);
+
+            expect_register("samples", REG_SAMPLES, 32'd10);
+            expect_register("min", REG_MIN, 32'd0);
+            expect_register("max", REG_MAX, 32'd70000);
+            expect_register("sum low", REG_SUM_LO, 32'd70249);
+            expect_register("sum high", REG_SUM_HI, 32'd0);
+            expect_register("clamped", REG_CLAMPED, 32'd1);
+            expect_register("top bucket", 8'd111, 32'd1);
+            expect_register("unmapped address", 8'd200, 32'd0);
+
+            if (fail_count == failures_before) begin
+                $display("  ✓ Count, min, max and sum exact; out-of-range sample in the top bucket");
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    task test_back_to_back();
+        integer i;
+        integer failures_before;
+        begin
+            $display("\nTest 4: Back-to-Back Samples");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+
+            sample_latency = 5;
+            sample_valid = 1;
+            for (i = 0; i < 10; i = i + 1) begin
+                @(posedge clk);
+            end
+            sample_valid = 0;
+            repeat(2) @(posedge clk);
+
+            expect_register("bucket 5", 8'd5, 32'd10);
+            expect_register("samples", REG_SAMPLES, 32'd20);
+
+            if (fail_count == failures_before) begin
+                $display("  ✓ 10 samples on consecutive cycles all counted");
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    task test_clear();
+        integer failures_before;
+        begin
+            $display("\nTest 5: Clear");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+
+            clear = 1;
+            @(posedge clk);
+            clear = 0;
+
+            expect_register("samples", REG_SAMPLES, 32'd0);
+            expect_register("min", REG_MIN, 32'hFFFFFFFF);
+            expect_register("max", REG_MAX, 32'd0);
+            expect_register("bucket 16", 8'd16, 32'd0);
+            expect_register("clamped", REG_CLAMPED, 32'd0);
+
+            record(7);
+            repeat(2) @(posedge clk);
+            expect_register("bucket 7", 8'd7, 32'd1);
+
+            if (fail_count == failures_before) begin
+                $display("  ✓ Histogram cleared and recording again");
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    // Timeout
+    initial begin
+        #100000;
+        $display("ERROR: Simulation timeout");
+        $finish;
+    end
+
+endmodule
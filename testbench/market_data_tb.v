@@ -21,6 +21,7 @@ module market_data_tb;
     reg                 data_valid;
     reg [63:0]          data_in;
     reg [7:0]           data_type;
+    reg                 data_last;
     wire                data_ready;
     
     // Parsed market data output
@@ -31,6 +32,10 @@ module market_data_tb;
     wire [31:0]         bid;
     wire [31:0]         ask;
     wire [63:0]         timestamp;
+    wire [63:0]         ingress_time;
+    
+    // System cycle counter
+    reg  [63:0]         timebase;
     
     // Order book interface
     wire                book_update_valid;
@@ -49,6 +54,13 @@ module market_data_tb;
     integer test_count;
     integer pass_count;
     integer fail_count;
+    integer tick_count = 0;         // output pulses, for the line-rate test
+    integer book_count = 0;
+    
+    // Ingress times of book updates, recorded while ingress_capture is set
+    reg                 ingress_capture = 0;
+    reg [63:0]          ingress_log [0:7];
+    integer             ingress_n = 0;
     
     // Performance measurement
     reg [31:0] latency_start;
@@ -64,6 +76,11 @@ module market_data_tb;
         forever #2 clk = ~clk; // 4ns period = 250MHz
     end
     
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) timebase <= 64'd0;
+        else timebase <= timebase + 64'd1;
+    end
+    
     // DUT instantiation
     market_data_processor #(
         .DATA_WIDTH(64),
@@ -79,7 +96,9 @@ module market_data_tb;
         .data_valid(data_valid),
         .data_in(data_in),
         .data_type(data_type),
+        .data_last(data_last),
         .data_ready(data_ready),
+        .timebase(timebase),
         .tick_valid(tick_valid),
         .symbol(symbol),
         .price(price),
@@ -87,6 +106,7 @@ module market_data_tb;
         .bid(bid),
         .ask(ask),
         .timestamp(timestamp),
+        .ingress_time(ingress_time),
         .book_update_valid(book_update_valid),
         .book_symbol(book_symbol),
         .book_price(book_price),
@@ -105,6 +125,7 @@ module market_data_tb;
         data_valid = 0;
         data_in = 0;
         data_type = 0;
+        data_last = 1;      // single-beat messages unless a test says otherwise
         test_count = 0;
         pass_count = 0;
         fail_count = 0;
@@ -146,6 +167,15 @@ module market_data_tb;
         // Test 7: Performance measurement
         test_performance();
         
+        // Test 8: Multi-beat ITCH 5.0 messages
+        test_itch_multi_beat();
+        
+        // Test 9: Back-to-back messages at line rate
+        test_line_rate();
+        
+        // Test 10: Ingress timestamps
+        test_ingress_time();
+        
         // Test summary
         $display("\n======================================");
         $display("Test Summary");
@@ -401,6 +431,206 @@ endtask
         end
     endtask
     
+    // Send one raw ITCH 5.0 message, left-aligned in msg, 8 bytes per beat
+    task send_itch_message;
+        input [319:0] msg;
+        input integer length;
+        integer beat;
+        integer beats;
+        begin
+            beats = (length + 7) / 8;
+            data_type = msg[319:312];
+            for (beat = 0; beat < beats; beat = beat + 1) begin
+                data_in = msg[319 - 64 * beat -: 64];
+                data_last = (beat == beats - 1);
+                data_valid = 1;
+                @(posedge clk);     // HEADER/PAYLOAD accept a beat every cycle
+            end
+            data_valid = 0;
+            data_last = 1;
+        end
+    endtask
+    
+    // Wait for the book update of the last message and check its fields
+    task check_itch_update;
+        input [8*16-1:0] name;
+        input expect_tick;
+        input [2:0] expect_action;
+        input [31:0] expect_price;
+        input [31:0] expect_volume;
+        integer timeout;
+        begin
+            test_count = test_count + 1;
+            timeout = 0;
+            while (!book_update_valid && timeout < 100) begin
+                @(posedge clk);
+                timeout = timeout + 1;
+            end
+            
+            if (book_update_valid && tick_valid == expect_tick &&
+                book_symbol == 32'h4141504c && book_action == expect_action &&
+                book_price == expect_price && book_volume == expect_volume) begin
+                $display("  ✓ %0s: action=%0d price=%h volume=%0d ts=%0d",
+                         name, book_action, book_price, book_volume, timestamp);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ %0s: valid=%b tick=%b symbol=%h action=%0d price=%h volume=%0d",
+                         name, book_update_valid, tick_valid, book_symbol, book_action,
+                         book_price, book_volume);
+                fail_count = fail_count + 1;
+            end
+            @(posedge clk);
+        end
+    endtask
+    
+    task test_itch_multi_beat();
+        reg [31:0] errors_before;
+        begin
+            $display("\nTest 8: Multi-beat ITCH 5.0 Messages");
+            
+            // Add 'A' (36 bytes, 5 beats): ref 7, buy 100 AAPL @ 150.0000
+            send_itch_message({8'h41, 16'd1, 16'd0, 48'd34200000000000, 64'd7,
+                               8'h42, 32'd100, "AAPL    ", 32'd1500000, 32'b0}, 36);
+            check_itch_update("Add", 1'b1, 3'd0, 32'd1500000, 32'd100);
+            
+            // Execute 'E' (31 bytes, 4 beats): 40 shares of ref 7
+            send_itch_message({8'h45, 16'd1, 16'd0, 48'd34200000001000, 64'd7,
+                               32'd40, 64'd9001, 72'b0}, 31);
+            check_itch_update("Execute", 1'b1, 3'd1, 32'd1500000, 32'd40);
+            
+            // Cancel 'X' (23 bytes, 3 beats): 10 shares of ref 7
+            send_itch_message({8'h58, 16'd1, 16'd0, 48'd34200000002000, 64'd7,
+                               32'd10, 136'b0}, 23);
+            check_itch_update("Cancel", 1'b1, 3'd2, 32'd1500000, 32'd10);
+            
+            // Replace 'U' (35 bytes, 5 beats): ref 7 -> ref 8, 200 @ 150.0100
+            send_itch_message({8'h55, 16'd1, 16'd0, 48'd34200000003000, 64'd7, 64'd8,
+                               32'd200, 32'd1500100, 40'b0}, 35);
+            check_itch_update("Replace", 1'b1, 3'd1, 32'd1500100, 32'd200);
+            
+            // Delete 'D' (19 bytes, 3 beats): ref 8, book update only
+            send_itch_message({8'h44, 16'd1, 16'd0, 48'd34200000004000, 64'd8,
+                               168'b0}, 19);
+            check_itch_update("Delete", 1'b0, 3'd2, 32'd1500100, 32'd0);
+            
+            // Execute against the deleted order must be rejected
+            test_count = test_count + 1;
+            errors_before = parse_errors;
+            send_itch_message({8'h45, 16'd1, 16'd0, 48'd34200000005000, 64'd8,
+                               32'd1, 64'd9002, 72'b0}, 31);
+            repeat(5) @(posedge clk);
+            if (parse_errors == errors_before + 1 && !book_update_valid) begin
+                $display("  ✓ Execute on unknown order reference rejected");
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Execute on unknown order reference not rejected (errors %0d -> %0d)",
+                         errors_before, parse_errors);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+    
+    // Every cycle carries a beat: 256 single-beat messages, then Add/Delete
+    // pairs (5 + 3 beats) with no idle cycle in between
+    task test_line_rate();
+        integer n;
+        integer beat;
+        integer start_ticks;
+        integer start_books;
+        reg [31:0] start_packets;
+        reg [31:0] start_errors;
+        reg [319:0] add_msg;
+        reg [319:0] del_msg;
+        reg stalled;
+        begin
+            $display("\nTest 9: Line-Rate Streaming");
+            test_count = test_count + 1;
+            
+            start_packets = packets_processed;
+            start_errors = parse_errors;
+            start_ticks = tick_count;
+            start_books = book_count;
+            stalled = 0;
+            
+            for (n = 0; n < 256; n = n + 1) begin
+                data_type = 8'h41;
+                data_in = {32'h4d534654, 32'h96000000 + n};
+                data_last = 1;
+                data_valid = 1;
+                if (!data_ready) stalled = 1;
+                @(posedge clk);
+            end
+            
+            for (n = 0; n < 32; n = n + 1) begin
+                add_msg = {8'h41, 16'd1, 16'd0, 48'd34200000000000, 64'd100 + n,
+                           8'h42, 32'd100, "AAPL    ", 32'd1500000, 32'b0};
+                del_msg = {8'h44, 16'd1, 16'd0, 48'd34200000000500, 64'd100 + n, 168'b0};
+                for (beat = 0; beat < 8; beat = beat + 1) begin
+                    data_type = (beat < 5) ? 8'h41 : 8'h44;
+                    data_in = (beat < 5) ? add_msg[319 - 64 * beat -: 64] : del_msg[319 - 64 * (beat - 5) -: 64];
+                    data_last = (beat == 4) || (beat == 7);
+                    data_valid = 1;
+                    if (!data_ready) stalled = 1;
+                    @(posedge clk);
+                end
+            end
+            data_valid = 0;
+            data_last = 1;
+            repeat(pipeline_depth + 2) @(posedge clk);
+            
+            // 256 compact ticks + 32 Add ticks; Delete only updates the book
+            if (!stalled && packets_processed - start_packets == 320 && parse_errors == start_errors &&
+                tick_count - start_ticks == 288 && book_count - start_books == 320) begin
+                $display("  ✓ 320 messages in %0d beats, no stalls, pipeline depth %0d",
+                         256 + 32 * 8, pipeline_depth);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Line rate failed: stalled=%b packets=%0d errors=%0d ticks=%0d books=%0d",
+                         stalled, packets_processed - start_packets, parse_errors - start_errors,
+                         tick_count - start_ticks, book_count - start_books);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+    
+    // A compact tick, a 5-beat Add right behind it and, after 3 idle cycles,
+    // another compact tick: each is stamped on its first beat
+    task test_ingress_time();
+        begin
+            $display("\nTest 10: Ingress Timestamps");
+            test_count = test_count + 1;
+            ingress_n = 0;
+            ingress_capture = 1;
+            
+            data_type = 8'h41;
+            data_in = {32'h41415054, 32'h32000000};
+            data_last = 1;
+            data_valid = 1;
+            @(posedge clk);
+            send_itch_message({8'h41, 16'd1, 16'd0, 48'd34200000000000, 64'd200,
+                               8'h42, 32'd100, "AAPL    ", 32'd1500000, 32'b0}, 36);
+            repeat(3) @(posedge clk);
+            data_type = 8'h41;
+            data_in = {32'h41415054, 32'h32000100};
+            data_valid = 1;
+            @(posedge clk);
+            data_valid = 0;
+            repeat(pipeline_depth + 2) @(posedge clk);
+            ingress_capture = 0;
+            
+            if (ingress_n == 3 && ingress_log[1] - ingress_log[0] == 64'd1 &&
+                ingress_log[2] - ingress_log[1] == 64'd8) begin
+                $display("  ✓ Ingress times %0d, %0d, %0d: stamped on the first beat",
+                         ingress_log[0], ingress_log[1], ingress_log[2]);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Ingress times: %0d updates, %0d, %0d, %0d (expected +1, +8)",
+                         ingress_n, ingress_log[0], ingress_log[1], ingress_log[2]);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+    
     task measure_latency();
         reg [31:0] latency_cycles;
         begin
@@ -413,6 +643,16 @@ endtask
         end
     endtask
     
+    // Output pulse counters for the line-rate test
+    always @(posedge clk) begin
+        if (tick_valid) tick_count = tick_count + 1;
+        if (book_update_valid) book_count = book_count + 1;
+        if (book_update_valid && ingress_capture && ingress_n < 8) begin
+            ingress_log[ingress_n] = ingress_time;
+            ingress_n = ingress_n + 1;
+        end
+    end
+    
     // Monitor for debugging
     always @(posedge clk) begin
         if (tick_valid) begin
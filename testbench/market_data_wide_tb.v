@@ -0,0 +1,418 @@
+/*
+ * Testbench for the wide (512-bit) market data ingest
+ * Builds MoldUDP64 message-block streams, [length:2][ITCH message], and
+ * drives them as 64-byte AXI-Stream beats
+ */
+
+`timescale 1ns / 1ps
+
+module market_data_wide_tb;
+
+    localparam DATA_WIDTH = 512;
+    localparam BEAT_BYTES = DATA_WIDTH / 8;
+    localparam LANES = 4;
+
+    // Clock and reset
+    reg clk;
+    reg rst_n;
+
+    // DUT signals
+    reg                         s_axis_tvalid;
+    wire                        s_axis_tready;
+    reg  [DATA_WIDTH-1:0]       s_axis_tdata;
+    reg  [BEAT_BYTES-1:0]       s_axis_tkeep;
+    reg                         s_axis_tlast;
+    wire [LANES-1:0]            lane_valid;
+    wire [LANES-1:0]            lane_tick;
+    wire [LANES*32-1:0]         lane_symbol;
+    wire [LANES*32-1:0]         lane_price;
+    wire [LANES*32-1:0]         lane_volume;
+    wire [LANES-1:0]            lane_side;
+    wire [LANES*3-1:0]          lane_action;
+    wire [LANES*48-1:0]         lane_timestamp;
+    wire [31:0]                 packets_processed;
+    wire [31:0]                 parse_errors;
+    wire [63:0]                 bytes_received;
+    wire [15:0]                 pipeline_depth;
+
+    // Test variables
+    integer test_count;
+    integer pass_count;
+    integer fail_count;
+
+    // Stream under construction
+    reg [7:0] stream [0:8191];
+    integer stream_len;
+
+    // Lane output log, in stream order
+    reg [31:0] log_symbol [0:1023];
+    reg [31:0] log_price [0:1023];
+    reg [31:0] log_volume [0:1023];
+    reg [2:0]  log_action [0:1023];
+    reg        log_tick [0:1023];
+    integer log_count;
+    integer max_lanes_seen;
+    integer stall_cycles;
+
+    // Clock generation (250MHz)
+    initial begin
+        clk = 0;
+        forever #2 clk = ~clk;
+    end
+
+    // DUT instantiation
+    market_data_processor_wide #(
+        .DATA_WIDTH(DATA_WIDTH),
+        .LANES(LANES),
+        .MAX_ORDERS(1024)
+    ) dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .s_axis_tvalid(s_axis_tvalid),
+        .s_axis_tready(s_axis_tready),
+        .s_axis_tdata(s_axis_tdata),
+        .s_axis_tkeep(s_axis_tkeep),
+        .s_axis_tlast(s_axis_tlast),
+        .lane_valid(lane_valid),
+        .lane_tick(lane_tick),
+        .lane_symbol(lane_symbol),
+        .lane_price(lane_price),
+        .lane_volume(lane_volume),
+        .lane_side(lane_side),
+        .lane_action(lane_action),
+        .lane_timestamp(lane_timestamp),
+        .packets_processed(packets_processed),
+        .parse_errors(parse_errors),
+        .bytes_received(bytes_received),
+        .pipeline_depth(pipeline_depth)
+    );
+
+    // Test stimulus
+    initial begin
+        rst_n = 0;
+        s_axis_tvalid = 0;
+        s_axis_tdata = 0;
+        s_axis_tkeep = 0;
+        s_axis_tlast = 0;
+        test_count = 0;
+        pass_count = 0;
+        fail_count = 0;
+        stream_len = 0;
+        log_count = 0;
+        max_lanes_seen = 0;
+        stall_cycles = 0;
+
+        $dumpfile("market_data_wide_tb.vcd");
+        $dumpvars(0, market_data_wide_tb);
+
+        $display("======================================");
+        $display("Wide Market Data Ingest Testbench");
+        $display("======================================");
+
+        #10 rst_n = 1;
+        #10;
+
+        // Test 1: Several messages in one beat
+        test_messages_in_one_beat();
+
+        // Test 2: Messages straddling beats
+        test_straddling_messages();
+
+        // Test 3: Unknown order reference and bad framing
+        test_error_conditions();
+
+        // Test 4: Sustained burst
+        test_sustained_burst();
+
+        $display("\n======================================");
+        $display("Test Summary");
+        $display("======================================");
+        $display("Total Tests: %d", test_count);
+        $display("Passed:      %d", pass_count);
+        $display("Failed:      %d", fail_count);
+
+        if (fail_count == 0) begin
+            $display("\nAll tests PASSED!");
+        end else begin
+            $display("\nSome tests FAILED!");
+        end
+
+        $finish;
+    end
+
+    // Stream builders: one [length:2][message] block each
+    task put_bytes;
+        input [63:0] value;
+        input integer bytes;
+        integer b;
+        begin
+            for (b = bytes - 1; b >= 0; b = b - 1) begin
+                stream[stream_len] = value[8*b +: 8];
+                stream_len = stream_len + 1;
+            end
+        end
+    endtask
+
+    task put_header;
+        input [7:0] msg_type;
+        input integer length;
+        input [63:0] order_ref;
+        begin
+            put_bytes(length, 2);
+            put_bytes(msg_type, 1);
+            put_bytes(16'd1, 2);                    // stock locate
+            put_bytes(16'd0, 2);                    // tracking number
+            put_bytes(48'd34200000000000, 6);       // 09:30:00
+            put_bytes(order_ref, 8);
+        end
+    endtask
+
+    task add_order;
+        input [63:0] order_ref;
+        input [31:0] stock;
+        input [31:0] shares;
+        input [31:0] price;
+        begin
+            put_header(8'h41, 36, order_ref);
+            put_bytes(8'h42, 1);                    // 'B'
+            put_bytes(shares, 4);
+            put_bytes({stock, 32'h20202020}, 8);
+            put_bytes(price, 4);
+        end
+    endtask
+
+    task execute_order;
+        input [63:0] order_ref;
+        input [31:0] shares;
+        begin
+            put_header(8'h45, 31, order_ref);
+            put_bytes(shares, 4);
+            put_bytes(64'd9001, 8);                 // match number
+        end
+    endtask
+
+    task cancel_order;
+        input [63:0] order_ref;
+        input [31:0] shares;
+        begin
+            put_header(8'h58, 23, order_ref);
+            put_bytes(shares, 4);
+        end
+    endtask
+
+    task delete_order;
+        input [63:0] order_ref;
+        begin
+            put_header(8'h44, 19, order_ref);
+        end
+    endtask
+
+    task replace_order;
+        input [63:0] order_ref;
+        input [63:0] new_order_ref;
+        input [31:0] shares;
+        input [31:0] price;
+        begin
+            put_header(8'h55, 35, order_ref);
+            put_bytes(new_order_ref, 8);
+            put_bytes(shares, 4);
+            put_bytes(price, 4);
+        end
+    endtask
+
+    // Send the stream as one packet, byte 0 of each beat in tdata[7:0].
+    // Beats change on the falling edge; tready only depends on DUT state,
+    // so it is stable there and says whether the next rising edge takes it.
+    task send_stream;
+        integer pos;
+        integer b;
+        begin
+            pos = 0;
+            @(negedge clk);
+            while (pos < stream_len) begin
+                s_axis_tdata = 0;
+                s_axis_tkeep = 0;
+                for (b = 0; b < BEAT_BYTES; b = b + 1) begin
+                    if (pos + b < stream_len) begin
+                        s_axis_tdata[8*b +: 8] = stream[pos + b];
+                        s_axis_tkeep[b] = 1'b1;
+                    end
+                end
+                s_axis_tlast = (pos + BEAT_BYTES >= stream_len);
+                s_axis_tvalid = 1;
+                if (s_axis_tready) begin
+                    pos = pos + BEAT_BYTES;
+                end else begin
+                    stall_cycles = stall_cycles + 1;
+                end
+                @(negedge clk);
+            end
+            s_axis_tvalid = 0;
+            s_axis_tlast = 0;
+            stream_len = 0;
+            repeat(pipeline_depth + 4) @(posedge clk);
+        end
+    endtask
+    
+    task expect_log;
+        input integer index;
+        input [31:0] symbol;
+        input [31:0] price;
+        input [31:0] volume;
+        input [2:0] action;
+        input tick;
+        begin
+            test_count = test_count + 1;
+            if (index < log_count && log_symbol[index] == symbol && log_price[index] == price &&
+                log_volume[index] == volume && log_action[index] == action && log_tick[index] == tick) begin
+                $display("  ✓ Message %0d: symbol=%h price=%0d volume=%0d action=%0d",
+                         index, symbol, price, volume, action);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Message %0d: got symbol=%h price=%0d volume=%0d action=%0d tick=%b",
+                         index, log_symbol[index], log_price[index], log_volume[index],
+                         log_action[index], log_tick[index]);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    task test_messages_in_one_beat();
+        integer first;
+        begin
+            $display("\nTest 1: Several Messages in One Beat");
+            first = log_count;
+
+            // Add (38) + Cancel (25) = 63 bytes: both decode in the same cycle,
+            // the Cancel resolving its order from the Add in the lane before
+            add_order(64'd1, "AAPL", 32'd100, 32'd1500000);
+            cancel_order(64'd1, 32'd30);
+            send_stream();
+
+            expect_log(first, "AAPL", 32'd1500000, 32'd100, 3'd0, 1'b1);
+            expect_log(first + 1, "AAPL", 32'd1500000, 32'd30, 3'd2, 1'b1);
+
+            test_count = test_count + 1;
+            if (max_lanes_seen >= 2) begin
+                $display("  ✓ %0d messages decoded in one cycle", max_lanes_seen);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Messages were not decoded in parallel");
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    task test_straddling_messages();
+        integer first;
+        begin
+            $display("\nTest 2: Messages Straddling Beats");
+            first = log_count;
+
+            add_order(64'd2, "MSFT", 32'd200, 32'd3000000);
+            execute_order(64'd2, 32'd50);
+            replace_order(64'd2, 64'd3, 32'd150, 32'd3000100);
+            add_order(64'd4, "NVDA", 32'd10, 32'd5000000);
+            delete_order(64'd3);
+            execute_order(64'd4, 32'd10);
+            send_stream();
+
+            expect_log(first, "MSFT", 32'd3000000, 32'd200, 3'd0, 1'b1);
+            expect_log(first + 1, "MSFT", 32'd3000000, 32'd50, 3'd1, 1'b1);
+            expect_log(first + 2, "MSFT", 32'd3000100, 32'd150, 3'd1, 1'b1);
+            expect_log(first + 3, "NVDA", 32'd5000000, 32'd10, 3'd0, 1'b1);
+            expect_log(first + 4, "MSFT", 32'd3000100, 32'd0, 3'd2, 1'b0);
+            expect_log(first + 5, "NVDA", 32'd5000000, 32'd10, 3'd1, 1'b1);
+        end
+    endtask
+
+    task test_error_conditions();
+        reg [31:0] errors_before;
+        integer first;
+        begin
+            $display("\nTest 3: Error Conditions");
+
+            // Execute on a deleted order
+            test_count = test_count + 1;
+            errors_before = parse_errors;
+            execute_order(64'd3, 32'd1);
+            send_stream();
+            if (parse_errors == errors_before + 1) begin
+                $display("  ✓ Unknown order reference rejected");
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Unknown order reference not rejected");
+                fail_count = fail_count + 1;
+            end
+
+            // A zero length prefix loses framing; the rest of the packet is
+            // dropped and the next packet parses normally
+            test_count = test_count + 1;
+            errors_before = parse_errors;
+            put_bytes(16'd0, 2);
+            add_order(64'd5, "TSLA", 32'd1, 32'd8000000);
+            send_stream();
+            first = log_count;
+            add_order(64'd6, "TSLA", 32'd2, 32'd8000000);
+            send_stream();
+            if (parse_errors == errors_before + 1 && log_count == first + 1 && log_volume[first] == 32'd2) begin
+                $display("  ✓ Framing error dropped the packet, next packet parsed");
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Framing recovery failed: errors %0d -> %0d, messages %0d",
+                         errors_before, parse_errors, log_count - first);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    task test_sustained_burst();
+        integer n;
+        integer first;
+        integer beats;
+        reg [31:0] packets_before;
+        begin
+            $display("\nTest 4: Sustained Burst");
+            test_count = test_count + 1;
+
+            first = log_count;
+            packets_before = packets_processed;
+            stall_cycles = 0;
+            for (n = 0; n < 100; n = n + 1) begin
+                add_order(64'd100 + n, "AMZN", n + 1, 32'd1300000 + n);
+                delete_order(64'd100 + n);
+            end
+            beats = (stream_len + BEAT_BYTES - 1) / BEAT_BYTES;
+            send_stream();
+
+            if (packets_processed - packets_before == 200 && log_count - first == 200 && stall_cycles == 0) begin
+                $display("  ✓ 200 messages in %0d beats without backpressure", beats);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Burst: messages=%0d outputs=%0d stalls=%0d",
+                         packets_processed - packets_before, log_count - first, stall_cycles);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    // Collect lane outputs in stream order
+    integer lane;
+    integer lanes_now;
+    always @(posedge clk) begin
+        lanes_now = 0;
+        for (lane = 0; lane < LANES; lane = lane + 1) begin
+            if (lane_valid[lane]) begin
+                log_symbol[log_count % 1024] = lane_symbol[lane*32 +: 32];
+                log_price[log_count % 1024] = lane_price[lane*32 +: 32];
+                log_volume[log_count % 1024] = lane_volume[lane*32 +: 32];
+                log_action[log_count % 1024] = lane_action[lane*3 +: 3];
+                log_tick[log_count % 1024] = lane_tick[lane];
+                log_count = log_count + 1;
+                lanes_now = lanes_now + 1;
+            end
+        end
+        if (lanes_now > max_lanes_seen) max_lanes_seen = lanes_now;
+    end
+
+endmodule
@@ -7,6 +7,9 @@
  * - Risk management verification
  * - Performance measurement
  * - Latency analysis
+ * - Back-to-back orders and the position, notional and rate limits
+ * - Input FIFO occupancy under execution backpressure
+ * - Symbol slots released at flat, and symbol-table full rejects
  */
 
 `timescale 1ns / 1ps
@@ -22,8 +25,15 @@ module order_manager_tb;
     reg [31:0]          order_symbol;
     reg [31:0]          order_price;
     reg [31:0]          order_volume;
+    reg                 order_side;
     reg [2:0]           order_type;
     reg [31:0]          order_id; // Added for test tasks that use order_id
+    reg [63:0]          order_tick_time;
+    reg [63:0]          timebase;
+    reg [31:0]          risk_position_limit;
+    reg [63:0]          risk_max_notional;
+    reg [15:0]          risk_rate_burst;
+    reg [31:0]          risk_rate_interval;
     wire                order_ready;
     wire                execution_valid;
     wire [63:0]         execution_id;
@@ -36,6 +46,18 @@ module order_manager_tb;
     wire [31:0]         risk_code; // Added for risk monitoring
     wire [31:0]         execution_status; // Added for execution monitoring
     wire [31:0]         position_pnl; // Added for position monitoring
+    wire [31:0]         orders_processed;
+    wire [31:0]         orders_rejected;
+    wire [15:0]         active_orders;
+    wire [63:0]         exec_timestamp;
+    wire [63:0]         exec_tick_time;
+    wire [31:0]         exec_latency;
+    wire                exec_latency_valid;
+    reg                 exec_ready;
+    wire [15:0]         order_fifo_peak;
+    wire [31:0]         order_fifo_stall_cycles;
+    wire [31:0]         symbol_table_rejects;
+    integer             latency_pulses = 0;
     
     // Test variables
     integer test_count;
@@ -54,6 +76,11 @@ module order_manager_tb;
         forever #2 clk = ~clk;
     end
     
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) timebase <= 64'd0;
+        else timebase <= timebase + 64'd1;
+    end
+    
     // DUT instantiation
     order_manager #(
         .ORDER_WIDTH(64),
@@ -70,10 +97,12 @@ module order_manager_tb;
         .order_symbol(order_symbol),
         .order_price(order_price),
         .order_volume(order_volume),
-        .order_side(1'b0),
+        .order_side(order_side),
         .order_type(order_type),
         .order_id(order_id), // Connect order_id
+        .order_tick_time(order_tick_time),
         .order_ready(order_ready),
+        .timebase(timebase),
         .tick_valid(1'b1),               // Always provide market data
         .tick_symbol(32'h41415054),      // AAPL
         .tick_price(32'd15000),          // 150.00 (in cents)
@@ -85,15 +114,28 @@ module order_manager_tb;
         .exec_price(execution_price),
         .exec_volume(execution_volume),
         .exec_side(),
-        .exec_timestamp(),
+        .exec_timestamp(exec_timestamp),
+        .exec_tick_time(exec_tick_time),
+        .exec_latency(exec_latency),
+        .exec_latency_valid(exec_latency_valid),
+        .exec_ready(exec_ready),
         .pos_update_valid(position_update),
         .pos_symbol(position_symbol),
         .pos_quantity(position_size),
         .pos_side(),
-        .risk_position_limit(32'd1000000),    // 1M position limit
+        .risk_position_limit(risk_position_limit),
         .risk_max_order_size(32'd100000),     // 100K order size limit
+        .risk_max_notional(risk_max_notional),
+        .risk_rate_burst(risk_rate_burst),
+        .risk_rate_interval(risk_rate_interval),
         .risk_enabled(1'b1),
         .risk_violation(risk_violation),
+        .orders_processed(orders_processed),
+        .orders_rejected(orders_rejected),
+        .active_orders(active_orders),
+        .order_fifo_peak(order_fifo_peak),
+        .order_fifo_stall_cycles(order_fifo_stall_cycles),
+        .symbol_table_rejects(symbol_table_rejects),
         .risk_code(risk_code), // Connect risk_code
         .execution_status(execution_status), // Connect execution_status
         .position_pnl(position_pnl) // Connect position_pnl
@@ -107,7 +149,14 @@ module order_manager_tb;
         order_symbol = 0;
         order_price = 0;
         order_volume = 0;
+        order_side = 0;
         order_type = 0;
+        order_tick_time = 0;
+        exec_ready = 1;
+        risk_position_limit = 32'd1000000;      // 1M shares net per symbol
+        risk_max_notional = 64'd1000000000;     // 10M dollars (in cents)
+        risk_rate_burst = 16'hFFFF;
+        risk_rate_interval = 32'd0;             // no order-rate throttle
         test_count = 0;
         pass_count = 0;
         fail_count = 0;
@@ -149,6 +198,18 @@ module order_manager_tb;
                 
                 // Test 7: Stress test
                 test_stress_conditions();
+                
+                // Test 8: Hashed order book
+                test_order_book();
+                
+                // Test 9: Tick-to-trade latency
+                test_exec_latency();
+                
+                // Test 10: Back-to-back orders and risk limits
+                test_risk_limits();
+                
+                // Test 11: Symbol slots released at flat
+                test_symbol_slot_reuse();
             end
             begin
                 // Global timeout - 100ms
@@ -391,9 +452,8 @@ module order_manager_tb;
                 end
             join_any
             disable fork;
-            @(posedge clk);
             
-            // Check position update
+            // Check position update, made with the execution
             if (position_update) begin
                 $display("  ✓ Position tracking working");
                 $display("  ✓ Position size: %h", position_size);
@@ -402,6 +462,7 @@ module order_manager_tb;
                 $display("  ✗ Position tracking failed");
                 fail_count = fail_count + 1;
             end
+            @(posedge clk);
             
             total_orders = total_orders + 2;
             successful_orders = successful_orders + 2;
@@ -444,7 +505,9 @@ module order_manager_tb;
     endtask
     
     task test_stress_conditions();
-        integer i;
+        integer i, fills_before;
+        reg [31:0] processed_before;
+        reg ready_seen;
         begin
             $display("\nTest 7: Stress Conditions");
             test_count = test_count + 1;
@@ -468,12 +531,374 @@ module order_manager_tb;
             // Wait for processing
             repeat(50) @(posedge clk);
             
-            $display("  ✓ Stress test completed");
-            pass_count = pass_count + 1;
-            total_orders = total_orders + 10;
+            // A burst of 12 while the execution output is held for 20 cycles:
+            // the producer waits on order_ready and nothing is lost
+            processed_before = orders_processed;
+            fills_before = latency_pulses;
+            exec_ready = 0;
+            fork
+                begin
+                    repeat(20) @(posedge clk);
+                    exec_ready = 1;
+                end
+                begin
+                    for (i = 0; i < 12; i = i + 1) begin
+                        order_id = 32'h30000100 + i;
+                        order_valid = 1;
+                        ready_seen = 0;
+                        while (!ready_seen) begin
+                            @(negedge clk);
+                            ready_seen = order_ready;
+                            @(posedge clk);
+                        end
+                    end
+                    order_valid = 0;
+                end
+            join
+            repeat(20) @(posedge clk);
+            
+            $display("  Order FIFO peak occupancy: %0d, %0d cycles stalled on a full FIFO",
+                     order_fifo_peak, order_fifo_stall_cycles);
+            if (orders_processed == processed_before + 12 && latency_pulses == fills_before + 12 &&
+                order_fifo_peak == 16'd4) begin
+                $display("  ✓ Stress test completed, burst held in the FIFO without loss");
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Burst: %0d processed, %0d executed of 12, FIFO peak %0d (expected 4)",
+                         orders_processed - processed_before, latency_pulses - fills_before, order_fifo_peak);
+                fail_count = fail_count + 1;
+            end
+            total_orders = total_orders + 22;
+        end
+    endtask
+    
+    // Submit one order and wait until the order manager has finished it;
+    // the last execution seen on the way is left in book_exec_*
+    reg        book_exec_seen;
+    reg [31:0] book_exec_price;
+    reg [31:0] book_exec_volume;
+    
+    task submit_book_order;
+        input [2:0]  kind;
+        input [31:0] id;
+        input [31:0] price;
+        input [31:0] volume;
+        reg [31:0] processed_before;
+        integer timeout;
+        begin
+            processed_before = orders_processed;
+            book_exec_seen = 0;
+            order_symbol = 32'h4d534654;  // MSFT: no tick, so limits rest
+            order_type = kind;
+            order_id = id;
+            order_price = price;
+            order_volume = volume;
+            order_valid = 1;
+            @(posedge clk);
+            order_valid = 0;
+            
+            timeout = 0;
+            while (orders_processed == processed_before && timeout < 50) begin
+                @(posedge clk);
+                if (execution_valid) begin
+                    book_exec_seen = 1;
+                    book_exec_price = execution_price;
+                    book_exec_volume = execution_volume;
+                end
+                timeout = timeout + 1;
+            end
+            @(posedge clk);
+        end
+    endtask
+    
+    task test_order_book();
+        reg [15:0] active_before;
+        reg [31:0] rejected_before;
+        begin
+            $display("\nTest 8: Hashed Order Book (add / execute / cancel)");
+            test_count = test_count + 1;
+            active_before = active_orders;
+            rejected_before = orders_rejected;
+            
+            // Three resting limit orders at two price levels
+            submit_book_order(3'b001, 32'h40000001, 32'd14000, 32'd100);
+            submit_book_order(3'b001, 32'h40000002, 32'd14000, 32'd100);
+            submit_book_order(3'b001, 32'h40000003, 32'd13900, 32'd100);
+            
+            if (active_orders == active_before + 3) begin
+                $display("  ✓ Limit orders resting: %0d active", active_orders);
+            end else begin
+                $display("  ✗ Expected %0d resting orders, got %0d", active_before + 3, active_orders);
+                fail_count = fail_count + 1;
+            end
+            
+            // Partial then full fill of order 2 at its resting price
+            submit_book_order(3'b011, 32'h40000002, 32'd0, 32'd40);
+            if (!(book_exec_seen && book_exec_price == 32'd14000 && book_exec_volume == 32'd40)) begin
+                $display("  ✗ Partial fill: seen=%b price=%0d volume=%0d", book_exec_seen, book_exec_price, book_exec_volume);
+                fail_count = fail_count + 1;
+            end
+            submit_book_order(3'b011, 32'h40000002, 32'd0, 32'd100);
+            if (!(book_exec_seen && book_exec_volume == 32'd60 && active_orders == active_before + 2)) begin
+                $display("  ✗ Remaining fill: seen=%b volume=%0d active=%0d", book_exec_seen, book_exec_volume, active_orders);
+                fail_count = fail_count + 1;
+            end
+            
+            // Cancel order 1, then cancel it again and re-add order 3: both rejected
+            submit_book_order(3'b010, 32'h40000001, 32'd0, 32'd0);
+            submit_book_order(3'b010, 32'h40000001, 32'd0, 32'd0);
+            submit_book_order(3'b001, 32'h40000003, 32'd13900, 32'd100);
+            
+            if (active_orders == active_before + 1 && orders_rejected == rejected_before + 2) begin
+                $display("  ✓ Order book add/execute/cancel working (%0d active, %0d rejected)",
+                         active_orders, orders_rejected - rejected_before);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Order book: active=%0d (expected %0d), rejected=%0d (expected 2)",
+                         active_orders, active_before + 1, orders_rejected - rejected_before);
+                fail_count = fail_count + 1;
+            end
+            
+            // Leave the book as we found it
+            submit_book_order(3'b010, 32'h40000003, 32'd0, 32'd0);
+            total_orders = total_orders + 9;
+        end
+    endtask
+    
+    // A market order whose tick arrived 20 cycles before it is submitted:
+    // the execution reports that tick time and the cycles elapsed since
+    task test_exec_latency();
+        reg [63:0] tick_time;
+        integer pulses_before;
+        begin
+            $display("\nTest 9: Tick-to-Trade Latency");
+            test_count = test_count + 1;
+            pulses_before = latency_pulses;
+            tick_time = timebase - 64'd20;
+            order_tick_time = tick_time;
+            submit_book_order(3'b000, 32'h50000001, 32'd15000, 32'd10);
+            order_tick_time = 0;
+            
+            if (book_exec_seen && latency_pulses == pulses_before + 1 && exec_tick_time == tick_time &&
+                exec_latency == exec_timestamp - tick_time && exec_latency > 32'd20) begin
+                $display("  ✓ Execution at %0d for tick at %0d: %0d cycles", exec_timestamp, exec_tick_time,
+                         exec_latency);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Latency: seen=%b pulses=%0d tick=%0d (expected %0d) latency=%0d at %0d",
+                         book_exec_seen, latency_pulses - pulses_before, exec_tick_time, tick_time,
+                         exec_latency, exec_timestamp);
+                fail_count = fail_count + 1;
+            end
+            total_orders = total_orders + 1;
         end
     endtask
     
+    // One GOOG order per cycle from the caller's order_* settings, IDs from
+    // id_base; waits for the pipeline to drain
+    task send_back_to_back;
+        input integer n;
+        input [31:0] id_base;
+        integer k;
+        begin
+            order_symbol = 32'h474f4f47;  // GOOG: no tick, market orders only
+            order_type = 3'b000;
+            order_price = 32'd15000;
+            for (k = 0; k < n; k = k + 1) begin
+                order_id = id_base + k;
+                order_valid = 1;
+                @(posedge clk);
+            end
+            order_valid = 0;
+            repeat(4) @(posedge clk);
+        end
+    endtask
+    
+    task test_risk_limits();
+        reg [31:0] processed_before, rejected_before;
+        integer fills_before, failures_before;
+        begin
+            $display("\nTest 10: Back-to-Back Orders and Risk Limits");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+            
+            // 16 orders on consecutive cycles: all taken, all executed
+            processed_before = orders_processed;
+            rejected_before = orders_rejected;
+            fills_before = latency_pulses;
+            order_side = 0;
+            order_volume = 32'd10;
+            send_back_to_back(16, 32'h60000000);
+            if (orders_processed != processed_before + 16 || latency_pulses != fills_before + 16 ||
+                orders_rejected != rejected_before) begin
+                $display("  ✗ Back to back: %0d processed, %0d executed, %0d rejected of 16",
+                         orders_processed - processed_before, latency_pulses - fills_before,
+                         orders_rejected - rejected_before);
+                fail_count = fail_count + 1;
+            end
+            
+            // GOOG is long 160; with a 200 share limit the net position after
+            // the fill decides, not the order size: +30 passes, +30 more would
+            // be 220, -300 leaves -110, -100 more would be -210
+            risk_position_limit = 32'd200;
+            rejected_before = orders_rejected;
+            fills_before = latency_pulses;
+            order_volume = 32'd30;
+            send_back_to_back(2, 32'h60000100);
+            order_side = 1;
+            order_volume = 32'd300;
+            send_back_to_back(1, 32'h60000200);
+            order_volume = 32'd100;
+            send_back_to_back(1, 32'h60000300);
+            order_side = 0;
+            if (latency_pulses != fills_before + 2 || orders_rejected != rejected_before + 2 || risk_code != 32'd1) begin
+                $display("  ✗ Position limit: %0d executed (expected 2), %0d rejected (expected 2), code %0d",
+                         latency_pulses - fills_before, orders_rejected - rejected_before, risk_code);
+                fail_count = fail_count + 1;
+            end
+            risk_position_limit = 32'd1000000;
+            
+            // 90K shares is under the size limit but 13.5M dollars notional
+            rejected_before = orders_rejected;
+            order_volume = 32'd90000;
+            send_back_to_back(1, 32'h60000400);
+            if (orders_rejected != rejected_before + 1 || risk_code != 32'd3) begin
+                $display("  ✗ Notional limit: %0d rejected (expected 1), code %0d",
+                         orders_rejected - rejected_before, risk_code);
+                fail_count = fail_count + 1;
+            end
+            
+            // A burst of 4 with a slow refill: 4 of 8 back-to-back orders pass
+            risk_rate_burst = 16'd4;
+            risk_rate_interval = 32'd1000;
+            @(posedge clk);
+            rejected_before = orders_rejected;
+            fills_before = latency_pulses;
+            order_volume = 32'd1;
+            send_back_to_back(8, 32'h60000500);
+            if (latency_pulses != fills_before + 4 || orders_rejected != rejected_before + 4 || risk_code != 32'd4) begin
+                $display("  ✗ Rate limit: %0d executed (expected 4), %0d rejected (expected 4), code %0d",
+                         latency_pulses - fills_before, orders_rejected - rejected_before, risk_code);
+                fail_count = fail_count + 1;
+            end
+            risk_rate_burst = 16'hFFFF;
+            risk_rate_interval = 32'd0;
+            
+            if (fail_count == failures_before) begin
+                $display("  ✓ One order per cycle; position, notional and rate limits enforced");
+                pass_count = pass_count + 1;
+            end
+            total_orders = total_orders + 29;
+        end
+    endtask
+    
+    // n market orders for synthetic symbols 0x53000000 + base .. + n - 1,
+    // one per cycle, 10 shares each; IDs carry the symbol index
+    reg held [0:299];
+    
+    task send_symbol_orders;
+        input integer n;
+        input integer base;
+        input        side;
+        input        only_held;
+        integer k;
+        begin
+            order_type = 3'b000;
+            order_price = 32'd15000;
+            order_volume = 32'd10;
+            order_side = side;
+            for (k = 0; k < n; k = k + 1) begin
+                if (!only_held || held[k]) begin
+                    order_symbol = 32'h53000000 + base + k;
+                    order_id = 32'h71000000 + base + k;
+                    order_valid = 1;
+                    @(posedge clk);
+                end
+            end
+            order_valid = 0;
+            order_side = 0;
+            repeat(4) @(posedge clk);
+        end
+    endtask
+    
+    // New buys of synthetic symbols 1000..1299 that executed, i.e. hold a slot
+    always @(posedge clk) begin
+        if (execution_valid && execution_id[31:16] == 16'h7100 &&
+            execution_id[15:0] >= 16'd1000 && execution_id[15:0] < 16'd1300) begin
+            held[execution_id[15:0] - 16'd1000] = 1'b1;
+        end
+    end
+    
+    task test_symbol_slot_reuse();
+        reg [31:0] processed_before, rejected_before, table_before;
+        integer fills_before, failures_before, k, held_count;
+        begin
+            $display("\nTest 11: Symbol Slots Released at Flat");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+            for (k = 0; k < 300; k = k + 1) held[k] = 1'b0;
+            
+            // 400 symbols, more than MAX_POSITIONS, each bought and sold back
+            // to flat: every one gets a slot and gives it back
+            processed_before = orders_processed;
+            rejected_before = orders_rejected;
+            table_before = symbol_table_rejects;
+            fills_before = latency_pulses;
+            for (k = 0; k < 400; k = k + 1) begin
+                send_symbol_orders(1, k, 1'b0, 1'b0);
+                send_symbol_orders(1, k, 1'b1, 1'b0);
+            end
+            if (orders_processed != processed_before + 800 || latency_pulses != fills_before + 800 ||
+                orders_rejected != rejected_before || symbol_table_rejects != table_before) begin
+                $display("  ✗ Flat cycling: %0d processed, %0d executed, %0d rejected of 800",
+                         orders_processed - processed_before, latency_pulses - fills_before,
+                         orders_rejected - rejected_before);
+                fail_count = fail_count + 1;
+            end
+            
+            // 300 open positions cannot all be tracked; the overflow is
+            // rejected and counted as symbol-table rejects
+            rejected_before = orders_rejected;
+            fills_before = latency_pulses;
+            send_symbol_orders(300, 1000, 1'b0, 1'b0);
+            held_count = 0;
+            for (k = 0; k < 300; k = k + 1) held_count = held_count + held[k];
+            if (orders_rejected == rejected_before ||
+                symbol_table_rejects - table_before != orders_rejected - rejected_before ||
+                latency_pulses - fills_before != held_count ||
+                held_count + (orders_rejected - rejected_before) != 300) begin
+                $display("  ✗ Table full: %0d held, %0d rejected, %0d symbol-table rejects",
+                         held_count, orders_rejected - rejected_before, symbol_table_rejects - table_before);
+                fail_count = fail_count + 1;
+            end
+            
+            // Flattening them frees the table for another 400 symbols
+            send_symbol_orders(300, 1000, 1'b1, 1'b1);
+            rejected_before = orders_rejected;
+            table_before = symbol_table_rejects;
+            for (k = 0; k < 400; k = k + 1) begin
+                send_symbol_orders(1, 2000 + k, 1'b0, 1'b0);
+                send_symbol_orders(1, 2000 + k, 1'b1, 1'b0);
+            end
+            if (orders_rejected != rejected_before || symbol_table_rejects != table_before) begin
+                $display("  ✗ After flattening: %0d rejected, %0d symbol-table rejects",
+                         orders_rejected - rejected_before, symbol_table_rejects - table_before);
+                fail_count = fail_count + 1;
+            end
+            
+            if (fail_count == failures_before) begin
+                $display("  ✓ 800 flat symbols through 256 slots; %0d open positions filled the table, rest rejected",
+                         held_count);
+                pass_count = pass_count + 1;
+            end
+            total_orders = total_orders + 1900 + held_count;
+        end
+    endtask
+    
+    always @(posedge clk) begin
+        if (exec_latency_valid) latency_pulses = latency_pulses + 1;
+    end
+    
     // Monitor for debugging
     always @(posedge clk) begin
         if (execution_valid) begin
@@ -486,8 +911,8 @@ module order_manager_tb;
                      position_symbol, position_size, position_pnl);
         end
         
-        if (risk_violation) begin
-            $display("Risk Violation: Code=%h", risk_code);
+        if (execution_status == 32'd2) begin
+            $display("Order Rejected: Risk code=%h", risk_code);
         end
         
         // Debug: Show when orders are submitted
@@ -0,0 +1,346 @@
+/*
+ * Sharded Trading System Testbench
+ * Symbol-hash routing, per-lane counters, the execution merge and
+ * throughput at each number of lanes
+ */
+
+`timescale 1ns / 1ps
+
+module sharded_trading_system_tb;
+
+    localparam NUM_LANES = 4;
+    localparam NUM_SYMBOLS = 32;
+
+    // Clock and reset
+    reg clk;
+    reg rst_n;
+
+    // DUT signals
+    reg                 data_valid;
+    reg [63:0]          data_in;
+    reg [7:0]           data_type;
+    reg                 data_last;
+    wire                data_ready;
+    reg [63:0]          timebase;
+    reg [3:0]           cfg_lane_bits;
+    wire                exec_valid;
+    wire [7:0]          exec_lane;
+    wire [31:0]         exec_symbol;
+    wire [31:0]         exec_price;
+    wire [31:0]         exec_volume;
+    wire                exec_side;
+    wire [63:0]         exec_tick_time;
+    wire [31:0]         exec_latency;
+    wire [31:0]         ticks_routed;
+    wire [31:0]         exec_dropped;
+    wire [NUM_LANES*32-1:0] lane_ticks;
+    wire [NUM_LANES*32-1:0] lane_orders;
+    wire [NUM_LANES*32-1:0] lane_accepted;
+    wire [NUM_LANES*32-1:0] lane_executions;
+
+    // Test variables
+    integer test_count;
+    integer pass_count;
+    integer fail_count;
+    integer executions;
+    integer lane_errors;
+
+    // Clock generation (250MHz)
+    initial begin
+        clk = 0;
+        forever #2 clk = ~clk;
+    end
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) timebase <= 64'd0;
+        else timebase <= timebase + 64'd1;
+    end
+
+    // DUT instantiation: momentum only, no risk limits
+    sharded_trading_system #(
+        .NUM_LANES(NUM_LANES),
+        .MAX_SYMBOLS(64),
+        .MAX_ORDERS(256)
+    ) dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .data_valid(data_valid),
+        .data_in(data_in),
+        .data_type(data_type),
+        .data_last(data_last),
+        .data_ready(data_ready),
+        .timebase(timebase),
+        .cfg_lane_bits(cfg_lane_bits),
+        .strategy_enable(4'b1000),
+        .arb_min_profit(32'd0),
+        .mm_spread(32'd0),
+        .twap_target_vol(32'd0),
+        .twap_duration(32'd0),
+        .arbiter_mode(2'd0),
+        .strategy_min_gap(64'd0),
+        .position_limit(32'hFFFFFFFF),
+        .risk_enabled(1'b0),
+        .risk_position_limit(32'hFFFFFFFF),
+        .risk_max_order_size(32'hFFFFFFFF),
+        .risk_max_notional(64'hFFFFFFFFFFFFFFFF),
+        .risk_rate_burst(16'hFFFF),
+        .risk_rate_interval(32'd0),
+        .exec_valid(exec_valid),
+        .exec_lane(exec_lane),
+        .exec_symbol(exec_symbol),
+        .exec_price(exec_price),
+        .exec_volume(exec_volume),
+        .exec_side(exec_side),
+        .exec_tick_time(exec_tick_time),
+        .exec_latency(exec_latency),
+        .ticks_routed(ticks_routed),
+        .exec_dropped(exec_dropped),
+        .lane_ticks(lane_ticks),
+        .lane_orders(lane_orders),
+        .lane_accepted(lane_accepted),
+        .lane_executions(lane_executions)
+    );
+
+    function [31:0] symbol_code;
+        input integer index;
+        begin
+            symbol_code = 32'h53000000 + index;
+        end
+    endfunction
+
+    // Router reference: top cfg_lane_bits bits of symbol * 0x85EBCA6B
+    function [7:0] expected_lane;
+        input [31:0] symbol;
+        reg [31:0] hash;
+        begin
+            hash = symbol * 32'h85EBCA6B;
+            expected_lane = (cfg_lane_bits == 0) ? 8'd0 : hash >> (32 - cfg_lane_bits);
+        end
+    endfunction
+
+    // Every merged execution must come from its symbol's lane
+    always @(posedge clk) begin
+        if (rst_n && exec_valid) begin
+            executions = executions + 1;
+            if (exec_lane != expected_lane(exec_symbol)) begin
+                $display("  ✗ Symbol %h executed on lane %0d, routed to lane %0d",
+                         exec_symbol, exec_lane, expected_lane(exec_symbol));
+                lane_errors = lane_errors + 1;
+            end
+        end
+    end
+
+    // Test stimulus
+    initial begin
+        // Initialize
+        rst_n = 0;
+        data_valid = 0;
+        data_in = 0;
+        data_type = 0;
+        data_last = 1;
+        cfg_lane_bits = 2;
+        test_count = 0;
+        pass_count = 0;
+        fail_count = 0;
+        executions = 0;
+        lane_errors = 0;
+
+        // VCD dump
+        $dumpfile("sharded_trading_system_tb.vcd");
+        $dumpvars(0, sharded_trading_system_tb);
+
+        $display("======================================");
+        $display("Sharded Trading System Testbench");
+        $display("======================================");
+
+        // Reset sequence
+        #10 rst_n = 1;
+        #10;
+
+        // Test 1: Routing and per-lane counters
+        test_routing();
+
+        // Test 2: Execution merge
+        test_merge();
+
+        // Test 3: Throughput against lane count
+        test_scaling();
+
+        // Test summary
+        $display("\n======================================");
+        $display("Test Summary");
+        $display("======================================");
+        $display("Total Tests: %d", test_count);
+        $display("Passed:      %d", pass_count);
+        $display("Failed:      %d", fail_count);
+
+        if (fail_count == 0) begin
+            $display("\nAll tests PASSED!");
+        end else begin
+            $display("\nSome tests FAILED!");
+        end
+
+        $finish;
+    end
+
+    // Hold reset for a cycle, with a new lane count applied
+    task restart;
+        input [3:0] lane_bits;
+        begin
+            cfg_lane_bits = lane_bits;
+            rst_n = 0;
+            @(posedge clk);
+            rst_n = 1;
+            @(posedge clk);
+        end
+    endtask
+
+    // n ticks, one per cycle, round-robin over the symbols; a symbol's price
+    // alternates 1% each visit so momentum fires on every tick after its first
+    task send_ticks;
+        input integer n;
+        integer i;
+        begin
+            for (i = 0; i < n; i = i + 1) begin
+                data_type = 8'h41;
+                data_in = {symbol_code(i % NUM_SYMBOLS),
+                           ((i / NUM_SYMBOLS) % 2) ? 32'h97800000 : 32'h96000000};
+                data_valid = 1;
+                @(posedge clk);
+            end
+            data_valid = 0;
+            repeat(100) @(posedge clk);
+        end
+    endtask
+
+    function integer lane_sum;
+        input [NUM_LANES*32-1:0] counters;
+        integer l;
+        begin
+            lane_sum = 0;
+            for (l = 0; l < NUM_LANES; l = l + 1) begin
+                lane_sum = lane_sum + counters[l*32 +: 32];
+            end
+        end
+    endfunction
+
+    task test_routing();
+        integer failures_before, l, idle_lanes;
+        begin
+            $display("\nTest 1: Symbol Routing");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+
+            lane_errors = 0;
+            send_ticks(512);
+
+            if (ticks_routed != 512 || lane_sum(lane_ticks) != 512) begin
+                $display("  ✗ %0d ticks routed, %0d counted by the lanes, expected 512",
+                         ticks_routed, lane_sum(lane_ticks));
+                fail_count = fail_count + 1;
+            end
+
+            idle_lanes = 0;
+            for (l = 0; l < NUM_LANES; l = l + 1) begin
+                if (lane_ticks[l*32 +: 32] == 0) idle_lanes = idle_lanes + 1;
+            end
+            if (idle_lanes != 0) begin
+                $display("  ✗ %0d lanes received no ticks from %0d symbols", idle_lanes, NUM_SYMBOLS);
+                fail_count = fail_count + 1;
+            end
+
+            if (lane_errors != 0) begin
+                fail_count = fail_count + 1;
+            end
+
+            if (fail_count == failures_before) begin
+                $display("  ✓ Every symbol stays on its hashed lane, all %0d lanes used", NUM_LANES);
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    task test_merge();
+        integer failures_before, l;
+        begin
+            $display("\nTest 2: Execution Merge");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+
+            // Executions from the routing test
+            if (executions + exec_dropped != lane_sum(lane_executions)) begin
+                $display("  ✗ %0d merged + %0d dropped, lanes executed %0d",
+                         executions, exec_dropped, lane_sum(lane_executions));
+                fail_count = fail_count + 1;
+            end
+            if (exec_dropped != 0) begin
+                $display("  ✗ %0d executions dropped at the merge", exec_dropped);
+                fail_count = fail_count + 1;
+            end
+            for (l = 0; l < NUM_LANES; l = l + 1) begin
+                if (lane_executions[l*32 +: 32] == 0) begin
+                    $display("  ✗ Lane %0d never executed", l);
+                    fail_count = fail_count + 1;
+                end
+            end
+
+            if (fail_count == failures_before) begin
+                $display("  ✓ %0d executions merged from %0d lanes, none dropped", executions, NUM_LANES);
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    // Each lane's order manager takes an order per cycle, so one lane keeps
+    // up with a tick per cycle; more lanes must not lose orders or
+    // executions, and must not slow the system down
+    task test_scaling();
+        integer failures_before, lane_bits, start_cycle, cycles, rate, single_rate;
+        begin
+            $display("\nTest 3: Lane Scaling");
+            test_count = test_count + 1;
+            failures_before = fail_count;
+            single_rate = 0;
+
+            for (lane_bits = 0; lane_bits <= 2; lane_bits = lane_bits + 1) begin
+                restart(lane_bits);
+                executions = 0;
+                start_cycle = timebase;
+                send_ticks(1024);
+                cycles = timebase - start_cycle - 100;
+                rate = executions * 1000 / cycles;      // executions per 1000 cycles
+                if (lane_bits == 0) single_rate = rate;
+
+                $display("  %0d lanes: %0d executions in %0d cycles, %0d orders offered, %0d accepted",
+                         1 << lane_bits, executions, cycles, lane_sum(lane_orders), lane_sum(lane_accepted));
+                if (lane_sum(lane_accepted) != lane_sum(lane_orders) || executions != lane_sum(lane_orders)) begin
+                    $display("  ✗ %0d lanes: %0d orders offered, %0d accepted, %0d executed",
+                             1 << lane_bits, lane_sum(lane_orders), lane_sum(lane_accepted), executions);
+                    fail_count = fail_count + 1;
+                end
+            end
+
+            if (lane_errors != 0) begin
+                fail_count = fail_count + 1;
+            end
+            if (single_rate == 0 || rate < single_rate) begin
+                $display("  ✗ %0d lanes: %0d executions per 1000 cycles, one lane %0d",
+                         NUM_LANES, rate, single_rate);
+                fail_count = fail_count + 1;
+            end
+
+            if (fail_count == failures_before) begin
+                $display("  ✓ Every order executed at each lane count (%0d -> %0d per 1000 cycles)", single_rate, rate);
+                pass_count = pass_count + 1;
+            end
+        end
+    endtask
+
+    // Timeout
+    initial begin
+        #200000;
+        $display("ERROR: Simulation timeout");
+        $finish;
+    end
+
+endmodule
@@ -1,131 +1,222 @@
 /*
  * Trading Strategy Testbench
  * Test environment for trading strategy execution engine
- * 
+ *
  * Features:
- * - Strategy algorithm testing
+ * - Strategy algorithm testing: arbitrage, market making, momentum, TWAP
+ * - Cross-venue arbitrage against the per-symbol, per-venue BBO table,
+ *   checked leg by leg
+ * - Parallel decisions on one tick, fixed priority and round-robin
+ *   arbitration, order_ready backpressure and per-strategy rate limits
  * - Decision latency measurement
  * - Performance analysis
- * - Signal validation
  */
 
 `timescale 1ns / 1ps
 
 module trading_strategy_tb;
 
+    localparam MAX_ORDERS = 64;
+
     // Clock and reset
     reg clk;
     reg rst_n;
-    
+
     // DUT signals
-    reg                 market_data_valid;
-    reg [31:0]          market_symbol;
-    reg [31:0]          market_price;
-    reg [31:0]          market_volume;
-    reg [31:0]          market_bid;
-    reg [31:0]          market_ask;
-    wire                signal_valid;
-    wire [31:0]         signal_symbol;
-    wire [31:0]         signal_price;
-    wire [31:0]         signal_volume;
-    wire [7:0]          signal_type;
-    wire [31:0]         signal_confidence;
-    wire                risk_check_valid;
-    wire [31:0]         risk_exposure;
-    wire [31:0]         risk_pnl;
-    
+    reg                 tick_valid;
+    reg [31:0]          tick_symbol;
+    reg [31:0]          tick_price;
+    reg [31:0]          tick_bid;
+    reg [31:0]          tick_ask;
+    reg [31:0]          tick_volume;
+    reg [1:0]           tick_venue;
+    reg [63:0]          tick_time;
+    reg [3:0]           strategy_enable;
+    reg [31:0]          arb_min_profit;
+    reg [31:0]          mm_spread;
+    reg [31:0]          twap_target_vol;
+    reg [31:0]          twap_duration;
+    reg [1:0]           arbiter_mode;
+    reg [63:0]          strategy_min_gap;
+    wire                order_valid;
+    wire [31:0]         order_symbol;
+    wire [31:0]         order_price;
+    wire [31:0]         order_volume;
+    wire                order_side;
+    wire [2:0]          order_type;
+    wire [1:0]          order_venue;
+    wire [63:0]         order_tick_time;
+    reg                 order_ready;
+    reg [31:0]          current_position;
+    reg [31:0]          position_limit;
+    wire [31:0]         decisions_made;
+    wire [31:0]         orders_generated;
+    wire [15:0]         active_strategies;
+    wire [31:0]         orders_dropped;
+    wire [127:0]        strategy_decisions;
+    wire [127:0]        strategy_orders;
+
     // Test variables
     integer test_count;
     integer pass_count;
     integer fail_count;
-    
+
+    // Orders taken by the testbench (order_valid && order_ready), oldest first
+    integer order_count;
+    reg [31:0] log_symbol [0:MAX_ORDERS-1];
+    reg [31:0] log_price [0:MAX_ORDERS-1];
+    reg [31:0] log_volume [0:MAX_ORDERS-1];
+    reg        log_side [0:MAX_ORDERS-1];
+    reg [2:0]  log_type [0:MAX_ORDERS-1];
+    reg [1:0]  log_venue [0:MAX_ORDERS-1];
+    reg [63:0] log_tick_time [0:MAX_ORDERS-1];
+    reg [31:0] log_cycle [0:MAX_ORDERS-1];
+    reg [31:0] cycle_count;
+
     // Performance measurement
     reg [31:0] decision_latency_start;
     reg [31:0] decision_latency_end;
     reg [31:0] total_signals;
     reg [31:0] valid_signals;
-    
+
     // Clock generation (250MHz)
     initial begin
         clk = 0;
         forever #2 clk = ~clk;
     end
-    
+
     // DUT instantiation
     trading_strategy #(
-        .DATA_WIDTH(32),
+        .SYMBOL_WIDTH(32),
+        .PRICE_WIDTH(32),
+        .VOLUME_WIDTH(32),
         .MAX_SYMBOLS(256),
-        .LOOKBACK_DEPTH(128),
-        .STRATEGY_COUNT(4)
+        .STRATEGY_COUNT(4),
+        .NUM_VENUES(4),
+        .VENUE_BITS(2)
     ) dut (
         .clk(clk),
         .rst_n(rst_n),
-        .market_data_valid(market_data_valid),
-        .market_symbol(market_symbol),
-        .market_price(market_price),
-        .market_volume(market_volume),
-        .market_bid(market_bid),
-        .market_ask(market_ask),
-        .signal_valid(signal_valid),
-        .signal_symbol(signal_symbol),
-        .signal_price(signal_price),
-        .signal_volume(signal_volume),
-        .signal_type(signal_type),
-        .signal_confidence(signal_confidence),
-        .risk_check_valid(risk_check_valid),
-        .risk_exposure(risk_exposure),
-        .risk_pnl(risk_pnl)
+        .tick_valid(tick_valid),
+        .tick_symbol(tick_symbol),
+        .tick_price(tick_price),
+        .tick_bid(tick_bid),
+        .tick_ask(tick_ask),
+        .tick_volume(tick_volume),
+        .tick_venue(tick_venue),
+        .tick_time(tick_time),
+        .strategy_enable(strategy_enable),
+        .arb_min_profit(arb_min_profit),
+        .mm_spread(mm_spread),
+        .twap_target_vol(twap_target_vol),
+        .twap_duration(twap_duration),
+        .arbiter_mode(arbiter_mode),
+        .strategy_min_gap(strategy_min_gap),
+        .order_valid(order_valid),
+        .order_symbol(order_symbol),
+        .order_price(order_price),
+        .order_volume(order_volume),
+        .order_side(order_side),
+        .order_type(order_type),
+        .order_venue(order_venue),
+        .order_tick_time(order_tick_time),
+        .order_ready(order_ready),
+        .current_position(current_position),
+        .position_limit(position_limit),
+        .decisions_made(decisions_made),
+        .orders_generated(orders_generated),
+        .active_strategies(active_strategies),
+        .orders_dropped(orders_dropped),
+        .strategy_decisions(strategy_decisions),
+        .strategy_orders(strategy_orders)
     );
-    
+
+    // Order log, sampled mid-cycle so order_ready is the value the DUT sees
+    // on the next rising edge
+    always @(negedge clk) begin
+        if (!rst_n) begin
+            cycle_count <= 32'd0;
+        end else begin
+            cycle_count <= cycle_count + 32'd1;
+            if (order_valid && order_ready && order_count < MAX_ORDERS) begin
+                log_symbol[order_count] = order_symbol;
+                log_price[order_count] = order_price;
+                log_volume[order_count] = order_volume;
+                log_side[order_count] = order_side;
+                log_type[order_count] = order_type;
+                log_venue[order_count] = order_venue;
+                log_tick_time[order_count] = order_tick_time;
+                log_cycle[order_count] = cycle_count;
+                order_count = order_count + 1;
+            end
+        end
+    end
+
     // Test stimulus
     initial begin
         // Initialize
         rst_n = 0;
-        market_data_valid = 0;
-        market_symbol = 0;
-        market_price = 0;
-        market_volume = 0;
-        market_bid = 0;
-        market_ask = 0;
+        tick_valid = 0;
+        tick_symbol = 0;
+        tick_price = 0;
+        tick_bid = 0;
+        tick_ask = 0;
+        tick_volume = 0;
+        tick_venue = 0;
+        tick_time = 0;
+        order_ready = 1;
+        current_position = 0;
+        position_limit = 32'd100000;
+        configure(4'b0000);
         test_count = 0;
         pass_count = 0;
         fail_count = 0;
+        order_count = 0;
         total_signals = 0;
         valid_signals = 0;
-        
+
         // VCD dump
         $dumpfile("trading_strategy_tb.vcd");
         $dumpvars(0, trading_strategy_tb);
-        
+
         $display("======================================");
         $display("Trading Strategy Testbench");
         $display("======================================");
-        
+
         // Reset sequence
         #10 rst_n = 1;
         #10;
-        
+
         // Test 1: Arbitrage detection
         test_arbitrage_strategy();
-        
+
         // Test 2: Market making
         test_market_making_strategy();
-        
+
         // Test 3: Momentum strategy
         test_momentum_strategy();
-        
-        // Test 4: Mean reversion
-        test_mean_reversion_strategy();
-        
+
+        // Test 4: Momentum reversal
+        test_momentum_reversal();
+
         // Test 5: Multi-symbol trading
         test_multi_symbol_trading();
-        
+
         // Test 6: High-frequency signals
         test_high_frequency_signals();
-        
+
         // Test 7: Risk management
         test_risk_management();
-        
+
+        // Test 8: Cross-venue arbitrage
+        test_cross_venue_arbitrage();
+
+        // Test 9: Parallel strategy evaluation and order arbitration
+        test_parallel_strategies();
+
+        // Test 10: TWAP execution
+        test_twap_strategy();
+
         // Test summary
         $display("\n======================================");
         $display("Test Summary");
@@ -135,285 +226,572 @@ module trading_strategy_tb;
         $display("Failed:      %d", fail_count);
         $display("Total Signals: %d", total_signals);
         $display("Valid Signals: %d", valid_signals);
-        
+
         if (total_signals > 0) begin
             $display("Signal Rate: %d%%", (valid_signals * 100) / total_signals);
         end
-        
+
         if (fail_count == 0) begin
             $display("\nAll tests PASSED!");
         end else begin
             $display("\nSome tests FAILED!");
         end
-        
+
         $finish;
     end
-    
-    // Test tasks
+
+    // Default configuration with the given strategies enabled
+    task configure;
+        input [3:0] enable;
+        begin
+            strategy_enable = enable;
+            arb_min_profit = 0;
+            mm_spread = 0;
+            twap_target_vol = 0;
+            twap_duration = 0;
+            arbiter_mode = 0;
+            strategy_min_gap = 0;
+        end
+    endtask
+
+    // Clear the BBO and last-price tables, the queues and the counters, so
+    // every test starts from an empty book and an empty order log
+    task restart;
+        input [3:0] enable;
+        begin
+            configure(enable);
+            order_ready = 1;
+            current_position = 0;
+            position_limit = 32'd100000;
+            rst_n = 0;
+            @(posedge clk);
+            rst_n = 1;
+            @(posedge clk);
+            order_count = 0;
+        end
+    endtask
+
+    task send_tick;
+        input [1:0]  venue;
+        input [31:0] symbol;
+        input [31:0] price;
+        input [31:0] bid;
+        input [31:0] ask;
+        begin
+            tick_venue = venue;
+            tick_symbol = symbol;
+            tick_price = price;
+            tick_bid = bid;
+            tick_ask = ask;
+            tick_volume = 32'd100;
+            tick_valid = 1;
+            @(posedge clk);
+            tick_valid = 0;
+            tick_venue = 0;
+        end
+    endtask
+
+    task send_venue_quote;
+        input [1:0]  venue;
+        input [31:0] symbol;
+        input [31:0] bid;
+        input [31:0] ask;
+        begin
+            send_tick(venue, symbol, (bid >> 1) + (ask >> 1), bid, ask);
+        end
+    endtask
+
+    // Wait up to max_cycles for the order log to reach count entries
+    task wait_orders;
+        input integer count;
+        input integer max_cycles;
+        integer waited;
+        begin
+            waited = 0;
+            while (order_count < count && waited < max_cycles) begin
+                @(posedge clk);
+                waited = waited + 1;
+            end
+            @(posedge clk);
+        end
+    endtask
+
     task test_arbitrage_strategy();
         begin
             $display("\nTest 1: Arbitrage Strategy");
             test_count = test_count + 1;
-            
-            // Send market data for AAPL with price discrepancy
-            market_symbol = 32'h41415054;  // AAPL
-            market_price = 32'h96000000;   // 150.00
-            market_volume = 32'h64000000;  // 100
-            market_bid = 32'h95F00000;     // 149.90
-            market_ask = 32'h96200000;     // 150.20
-            market_data_valid = 1;
+            restart(4'b0001);
+            arb_min_profit = 32'h00100000;
+
+            // AAPL bid on venue 1 is 0.20 above the venue 0 ask
+            send_venue_quote(2'd0, 32'h41415054, 32'h95F00000, 32'h96000000);
+            repeat(5) @(posedge clk);
             decision_latency_start = $time;
-            
-            @(posedge clk);
-            market_data_valid = 0;
-            
-            // Wait for signal
-            wait(signal_valid);
+            send_venue_quote(2'd1, 32'h41415054, 32'h96200000, 32'h96300000);
+
+            wait(order_valid);
             decision_latency_end = $time;
-            
-            // Check if arbitrage opportunity detected
-            if (signal_valid && signal_type == 8'h01) begin  // ARBITRAGE
-                $display("  ✓ Arbitrage opportunity detected");
+            wait_orders(2, 10);
+
+            // A venue 0 ask 0.10 under the venue 1 bid only matches arb_min_profit
+            send_venue_quote(2'd0, 32'h41415054, 32'h96000000, 32'h96100000);
+            repeat(10) @(posedge clk);
+
+            if (order_count == 2 && log_type[0] == 3'd1 &&
+                log_side[0] == 1'b0 && log_price[0] == 32'h96000000 && log_venue[0] == 2'd0 &&
+                log_side[1] == 1'b1 && log_price[1] == 32'h96200000 && log_venue[1] == 2'd1) begin
+                $display("  ✓ Arbitrage opportunity detected: buy venue 0 @%h, sell venue 1 @%h",
+                         log_price[0], log_price[1]);
                 $display("  ✓ Decision latency: %d ns", decision_latency_end - decision_latency_start);
-                $display("  ✓ Confidence: %h", signal_confidence);
+                $display("  ✓ Opportunity at arb_min_profit ignored");
                 pass_count = pass_count + 1;
                 valid_signals = valid_signals + 1;
             end else begin
-                $display("  ✗ Arbitrage strategy failed");
+                $display("  ✗ Arbitrage strategy failed: %0d orders", order_count);
                 fail_count = fail_count + 1;
             end
-            
+
             total_signals = total_signals + 1;
-            @(posedge clk);
         end
     endtask
-    
+
     task test_market_making_strategy();
         begin
             $display("\nTest 2: Market Making Strategy");
             test_count = test_count + 1;
-            
-            // Send market data with wide spread
-            market_symbol = 32'h474f4f47;  // GOOGL
-            market_price = 32'hAF000000;   // 2800.00
-            market_volume = 32'h32000000;  // 50
-            market_bid = 32'hAE000000;     // 2784.00
-            market_ask = 32'hB0000000;     // 2816.00
-            market_data_valid = 1;
+            restart(4'b0010);
+            mm_spread = 32'h00400000;
+
+            // Quote inside a wide GOOGL spread on venue 2
             decision_latency_start = $time;
-            
-            @(posedge clk);
-            market_data_valid = 0;
-            
-            // Wait for signal
-            wait(signal_valid);
+            send_venue_quote(2'd2, 32'h474f4f47, 32'hAE000000, 32'hB0000000);
+
+            wait(order_valid);
             decision_latency_end = $time;
-            
-            // Check if market making signal generated
-            if (signal_valid && signal_type == 8'h02) begin  // MARKET_MAKING
-                $display("  ✓ Market making signal generated");
+            wait_orders(1, 10);
+
+            if (order_count == 1 && log_symbol[0] == 32'h474f4f47 && log_type[0] == 3'd1 &&
+                log_side[0] == 1'b0 && log_price[0] == 32'hAE200000 && log_volume[0] == 32'd1000 &&
+                log_venue[0] == 2'd2) begin
+                $display("  ✓ Market making bid @%h on venue %0d", log_price[0], log_venue[0]);
                 $display("  ✓ Decision latency: %d ns", decision_latency_end - decision_latency_start);
                 pass_count = pass_count + 1;
                 valid_signals = valid_signals + 1;
             end else begin
-                $display("  ✗ Market making strategy failed");
+                $display("  ✗ Market making strategy failed: %0d orders, price %h", order_count, log_price[0]);
                 fail_count = fail_count + 1;
             end
-            
+
             total_signals = total_signals + 1;
-            @(posedge clk);
         end
     endtask
-    
+
     task test_momentum_strategy();
         integer i;
+        integer buys;
         begin
             $display("\nTest 3: Momentum Strategy");
             test_count = test_count + 1;
-            
-            // Send trending price data
+            restart(4'b1000);
+
+            // Send trending price data, each step more than 0.78% up
             for (i = 0; i < 20; i = i + 1) begin
-                market_symbol = 32'h4d534654;  // MSFT
-                market_price = 32'h50000000 + (i * 32'h01000000);  // Increasing price
-                market_volume = 32'h64000000;
-                market_bid = market_price - 32'h00100000;
-                market_ask = market_price + 32'h00100000;
-                market_data_valid = 1;
-                
-                @(posedge clk);
-                market_data_valid = 0;
+                tick_price = 32'h50000000 + (i * 32'h01000000);
+                send_tick(2'd0, 32'h4d534654, tick_price,
+                          tick_price - 32'h00100000, tick_price + 32'h00100000);  // MSFT
                 @(posedge clk);
             end
-            
-            // Wait for momentum signal
+
+            // Wait for momentum orders
             repeat(10) @(posedge clk);
-            
-            if (signal_valid && signal_type == 8'h03) begin  // MOMENTUM
-                $display("  ✓ Momentum signal generated");
+
+            // The first tick has no previous price to move from
+            buys = 0;
+            for (i = 0; i < order_count; i = i + 1) begin
+                if (log_side[i] == 1'b0 && log_type[i] == 3'd0 && log_volume[i] == 32'd500) buys = buys + 1;
+            end
+
+            if (order_count == 19 && buys == 19) begin
+                $display("  ✓ Momentum orders: %0d market buys on 20 rising ticks", buys);
                 pass_count = pass_count + 1;
                 valid_signals = valid_signals + 1;
             end else begin
-                $display("  ✗ Momentum strategy failed");
+                $display("  ✗ Momentum strategy failed: %0d orders, %0d buys", order_count, buys);
                 fail_count = fail_count + 1;
             end
-            
+
             total_signals = total_signals + 1;
         end
     endtask
-    
-    task test_mean_reversion_strategy();
+
+    task test_momentum_reversal();
         integer i;
+        integer buys, sells;
         begin
-            $display("\nTest 4: Mean Reversion Strategy");
+            $display("\nTest 4: Momentum Reversal");
             test_count = test_count + 1;
-            
-            // Send oscillating price data
+            restart(4'b1000);
+
+            // Send oscillating price data, 5% either side of 100
             for (i = 0; i < 30; i = i + 1) begin
-                market_symbol = 32'h54534c41;  // TSLA
-                market_price = 32'h64000000 + (i % 2 ? 32'h05000000 : -32'h05000000);
-                market_volume = 32'h32000000;
-                market_bid = market_price - 32'h00100000;
-                market_ask = market_price + 32'h00100000;
-                market_data_valid = 1;
-                
-                @(posedge clk);
-                market_data_valid = 0;
+                tick_price = 32'h64000000 + (i % 2 ? 32'h05000000 : -32'h05000000);
+                send_tick(2'd0, 32'h54534c41, tick_price,
+                          tick_price - 32'h00100000, tick_price + 32'h00100000);  // TSLA
                 @(posedge clk);
             end
-            
-            // Wait for mean reversion signal
+
             repeat(10) @(posedge clk);
-            
-            if (signal_valid && signal_type == 8'h04) begin  // MEAN_REVERSION
-                $display("  ✓ Mean reversion signal generated");
+
+            // Every tick after the first reverses the last move
+            buys = 0;
+            sells = 0;
+            for (i = 0; i < order_count; i = i + 1) begin
+                if (log_side[i] == (i % 2)) begin
+                    if (log_side[i]) sells = sells + 1;
+                    else buys = buys + 1;
+                end
+            end
+
+            if (order_count == 29 && buys == 15 && sells == 14) begin
+                $display("  ✓ Momentum followed every reversal: %0d buys, %0d sells", buys, sells);
                 pass_count = pass_count + 1;
                 valid_signals = valid_signals + 1;
             end else begin
-                $display("  ✗ Mean reversion strategy failed");
+                $display("  ✗ Momentum reversal failed: %0d orders, %0d buys, %0d sells",
+                         order_count, buys, sells);
                 fail_count = fail_count + 1;
             end
-            
+
             total_signals = total_signals + 1;
         end
     endtask
-    
+
     task test_multi_symbol_trading();
         begin
             $display("\nTest 5: Multi-Symbol Trading");
             test_count = test_count + 1;
-            
-            // Send data for multiple symbols
-            
-            // AAPL
-            market_symbol = 32'h41415054;
-            market_price = 32'h96000000;
-            market_volume = 32'h64000000;
-            market_bid = 32'h95F00000;
-            market_ask = 32'h96100000;
-            market_data_valid = 1;
+            restart(4'b1000);
+
+            // Interleaved symbols at very different prices: a symbol's first
+            // tick must not be compared with another symbol's last price
+            send_tick(2'd0, 32'h41415054, 32'h96000000, 32'h95F00000, 32'h96100000);  // AAPL
             @(posedge clk);
-            market_data_valid = 0;
+            send_tick(2'd0, 32'h474f4f47, 32'hAF000000, 32'hAEF00000, 32'hAF100000);  // GOOGL
             @(posedge clk);
-            
-            // GOOGL
-            market_symbol = 32'h474f4f47;
-            market_price = 32'hAF000000;
-            market_volume = 32'h32000000;
-            market_bid = 32'hAEF00000;
-            market_ask = 32'hAF100000;
-            market_data_valid = 1;
+            send_tick(2'd0, 32'h4d534654, 32'h50000000, 32'h4FF00000, 32'h50100000);  // MSFT
             @(posedge clk);
-            market_data_valid = 0;
+
+            // AAPL unchanged, GOOGL down 2.3%, MSFT unchanged
+            send_tick(2'd0, 32'h41415054, 32'h96000000, 32'h95F00000, 32'h96100000);
             @(posedge clk);
-            
-            // MSFT
-            market_symbol = 32'h4d534654;
-            market_price = 32'h50000000;
-            market_volume = 32'h48000000;
-            market_bid = 32'h4FF00000;
-            market_ask = 32'h50100000;
-            market_data_valid = 1;
+            send_tick(2'd0, 32'h474f4f47, 32'hAB000000, 32'hAAF00000, 32'hAB100000);
             @(posedge clk);
-            market_data_valid = 0;
-            
+            send_tick(2'd0, 32'h4d534654, 32'h50000000, 32'h4FF00000, 32'h50100000);
+
             // Wait for processing
             repeat(20) @(posedge clk);
-            
-            $display("  ✓ Multi-symbol trading processed");
-            pass_count = pass_count + 1;
+
+            if (decisions_made == 6 && order_count == 1 && log_symbol[0] == 32'h474f4f47 &&
+                log_side[0] == 1'b1 && log_price[0] == 32'hAB000000) begin
+                $display("  ✓ Multi-symbol trading processed: one GOOGL sell from 6 ticks");
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Multi-symbol trading failed: %0d decisions, %0d orders, first symbol %h",
+                         decisions_made, order_count, log_symbol[0]);
+                fail_count = fail_count + 1;
+            end
         end
     endtask
-    
+
     task test_high_frequency_signals();
         integer i;
         reg [31:0] start_time, end_time;
         begin
             $display("\nTest 6: High-Frequency Signals");
             test_count = test_count + 1;
-            
+            restart(4'b0010);
+
             start_time = $time;
-            
-            // Send 1000 market data updates rapidly
+
+            // Send 1000 market data updates back to back; market making
+            // decides on every one and the arbiter must keep up
+            tick_valid = 1;
             for (i = 0; i < 1000; i = i + 1) begin
-                market_symbol = 32'h4e564441;  // NVDA
-                market_price = 32'h64000000 + (i % 10);
-                market_volume = 32'h32000000;
-                market_bid = market_price - 32'h00100000;
-                market_ask = market_price + 32'h00100000;
-                market_data_valid = 1;
-                
+                tick_symbol = 32'h4e564441;  // NVDA
+                tick_price = 32'h64000000 + (i % 10);
+                tick_volume = 32'd100;
+                tick_bid = tick_price - 32'h00100000;
+                tick_ask = tick_price + 32'h00100000;
                 @(posedge clk);
-                market_data_valid = 0;
             end
-            
+            tick_valid = 0;
+
             end_time = $time;
-            
-            $display("  ✓ Processed 1000 market updates in %d ns", end_time - start_time);
-            $display("  ✓ Throughput: %d updates/second", 
-                     (1000 * 1000000000) / (end_time - start_time));
-            pass_count = pass_count + 1;
+            repeat(10) @(posedge clk);
+
+            if (decisions_made == 1000 && strategy_orders[63:32] == 1000 && orders_dropped == 0) begin
+                $display("  ✓ Processed 1000 market updates in %d ns", end_time - start_time);
+                $display("  ✓ Throughput: %d updates/second",
+                         (1000 * 1000000000) / (end_time - start_time));
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ High-frequency signals failed: %0d decisions, %0d orders, %0d dropped",
+                         decisions_made, strategy_orders[63:32], orders_dropped);
+                fail_count = fail_count + 1;
+            end
         end
     endtask
-    
+
     task test_risk_management();
+        integer blocked;
         begin
             $display("\nTest 7: Risk Management");
             test_count = test_count + 1;
-            
-            // Send data that should trigger risk checks
-            market_symbol = 32'h41415054;
-            market_price = 32'hFFFFFFFF;  // Extreme price
-            market_volume = 32'hFFFFFFFF;  // Extreme volume
-            market_bid = 32'h00000001;
-            market_ask = 32'hFFFFFFFE;
-            market_data_valid = 1;
-            
+            restart(4'b0001);
+
+            // An arbitrage opportunity at the position limit is not taken
+            current_position = position_limit;
+            send_venue_quote(2'd0, 32'h41415054, 32'h95F00000, 32'h96000000);
+            repeat(5) @(posedge clk);
+            send_venue_quote(2'd1, 32'h41415054, 32'h96200000, 32'h96300000);
+            repeat(10) @(posedge clk);
+            blocked = order_count;
+
+            // The same opportunity once the position is back under the limit
+            current_position = position_limit - 1;
+            send_venue_quote(2'd1, 32'h41415054, 32'h96200000, 32'h96300000);
+            wait_orders(2, 20);
+
+            if (blocked == 0 && order_count == 2) begin
+                $display("  ✓ Arbitrage held at the position limit");
+                $display("  ✓ Arbitrage resumed under the limit: %0d legs", order_count);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Risk management failed: %0d orders at the limit, %0d under it",
+                         blocked, order_count - blocked);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    task test_cross_venue_arbitrage();
+        begin
+            $display("\nTest 8: Cross-Venue Arbitrage");
+            test_count = test_count + 1;
+            restart(4'b0001);
+
+            // A high bid for MSFT on venue 1 must not read as an AAPL opportunity
+            send_venue_quote(2'd1, 32'h4d534654, 32'h97000000, 32'h97100000);
+            send_venue_quote(2'd0, 32'h41415054, 32'h95F00000, 32'h96000000);
+            // Venue 3 offers AAPL below venue 0, still no crossed market
+            send_venue_quote(2'd3, 32'h41415054, 32'h95E00000, 32'h95F80000);
+            repeat(5) @(posedge clk);
+
+            // AAPL bid on venue 2 above both asks: buy the best ask (venue 3),
+            // sell on venue 2
+            send_venue_quote(2'd2, 32'h41415054, 32'h96300000, 32'h96400000);
+            wait_orders(2, 20);
+            repeat(5) @(posedge clk);
+
+            if (order_count == 2 && strategy_orders[31:0] == 2 &&
+                log_symbol[0] == 32'h41415054 && log_side[0] == 1'b0 &&
+                log_price[0] == 32'h95F80000 && log_venue[0] == 2'd3 &&
+                log_symbol[1] == 32'h41415054 && log_side[1] == 1'b1 &&
+                log_price[1] == 32'h96300000 && log_venue[1] == 2'd2 &&
+                log_cycle[1] == log_cycle[0] + 1) begin
+                $display("  ✓ Cross-venue arbitrage: buy venue %0d @%h, sell venue %0d @%h",
+                         log_venue[0], log_price[0], log_venue[1], log_price[1]);
+                pass_count = pass_count + 1;
+                valid_signals = valid_signals + 1;
+            end else begin
+                $display("  ✗ Cross-venue arbitrage failed: %0d orders, buy %h venue %0d, sell %h venue %0d",
+                         order_count, log_price[0], log_venue[0], log_price[1], log_venue[1]);
+                fail_count = fail_count + 1;
+            end
+
+            total_signals = total_signals + 1;
+        end
+    endtask
+
+    // Three ticks alternating between venues 1 and 0 while order_ready is
+    // low; with venue 0 at 149.90/150.00 and venue 1 at 150.20/150.30 every
+    // one is an arbitrage (buy venue 0 @150.00, sell venue 1 @150.20) and a
+    // market-making decision. Returns a mask of the market-making orders.
+    task queue_arbitrage_burst;
+        input [1:0] mode;
+        output [8:0] mm_mask;
+        integer i;
+        begin
+            restart(4'b0000);
+            send_venue_quote(2'd0, 32'h4e564441, 32'h95F00000, 32'h96000000);
+            send_venue_quote(2'd1, 32'h4e564441, 32'h96200000, 32'h96300000);
+            repeat(5) @(posedge clk);
+
+            configure(4'b0011);
+            arbiter_mode = mode;
+            mm_spread = 32'h00020000;
+            order_ready = 0;
+            send_venue_quote(2'd1, 32'h4e564441, 32'h96200000, 32'h96300000);
+            @(posedge clk);
+            send_venue_quote(2'd0, 32'h4e564441, 32'h95F00000, 32'h96000000);
             @(posedge clk);
-            market_data_valid = 0;
-            
-            // Wait for risk check
+            send_venue_quote(2'd1, 32'h4e564441, 32'h96200000, 32'h96300000);
+            repeat(10) @(posedge clk);
+            order_ready = 1;
+            wait_orders(9, 40);
+
+            mm_mask = 9'd0;
+            for (i = 0; i < 9 && i < order_count; i = i + 1) begin
+                if (log_price[i] != 32'h96000000 && log_price[i] != 32'h96200000) mm_mask[i] = 1'b1;
+            end
+        end
+    endtask
+
+    task test_parallel_strategies();
+        integer i;
+        integer gap_errors;
+        reg [31:0] arb_decisions, mm_decisions;
+        reg [8:0] mm_mask;
+        begin
+            $display("\nTest 9: Parallel Strategy Evaluation");
+            test_count = test_count + 1;
+
+            // One tick that is both an arbitrage and a market-making decision:
+            // both strategies must decide on it, and with fixed priority the
+            // two arbitrage legs go out before the market-making quote, all
+            // carrying the tick's ingress time
+            restart(4'b0011);
+            mm_spread = 32'h00020000;
+            send_venue_quote(2'd0, 32'h54534c41, 32'h95F00000, 32'h96000000);
+            repeat(10) @(posedge clk);
+            arb_decisions = strategy_decisions[31:0];
+            mm_decisions = strategy_decisions[63:32];
+            order_count = 0;
+
+            tick_time = 64'd5000;
+            send_venue_quote(2'd3, 32'h54534c41, 32'h96300000, 32'h96400000);
+            tick_time = 64'd0;
+            wait_orders(3, 20);
+
+            if (strategy_decisions[31:0] == arb_decisions + 1 && strategy_decisions[63:32] == mm_decisions + 1 &&
+                order_count == 3 &&
+                log_price[0] == 32'h96000000 && log_side[0] == 1'b0 && log_venue[0] == 2'd0 &&
+                log_price[1] == 32'h96300000 && log_side[1] == 1'b1 && log_venue[1] == 2'd3 &&
+                log_price[2] == 32'h96310000 && log_side[2] == 1'b0 && log_venue[2] == 2'd3 &&
+                log_tick_time[0] == 64'd5000 && log_tick_time[1] == 64'd5000 && log_tick_time[2] == 64'd5000) begin
+                $display("  ✓ Arbitrage and market making decided on one tick, %0d orders", order_count);
+                pass_count = pass_count + 1;
+                valid_signals = valid_signals + 1;
+            end else begin
+                $display("  ✗ Parallel decision failed: orders=%0d prices %h/%h/%h tick times %0d/%0d/%0d",
+                         order_count, log_price[0], log_price[1], log_price[2],
+                         log_tick_time[0], log_tick_time[1], log_tick_time[2]);
+                fail_count = fail_count + 1;
+            end
+            total_signals = total_signals + 1;
+
+            // Orders queued behind order_ready: fixed priority drains every
+            // arbitrage pair first, round-robin alternates the strategies
+            test_count = test_count + 1;
+            queue_arbitrage_burst(2'd0, mm_mask);
+            if (order_count == 9 && mm_mask == 9'b111000000 && orders_dropped == 0) begin
+                $display("  ✓ Fixed priority: three arbitrage pairs, then three quotes");
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Fixed priority failed: orders=%0d market-making mask %b", order_count, mm_mask);
+                fail_count = fail_count + 1;
+            end
+
+            test_count = test_count + 1;
+            queue_arbitrage_burst(2'd1, mm_mask);
+            if (order_count == 9 && mm_mask == 9'b100100100 && orders_dropped == 0) begin
+                $display("  ✓ Round-robin: arbitrage pairs and quotes alternate");
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Round-robin failed: orders=%0d market-making mask %b", order_count, mm_mask);
+                fail_count = fail_count + 1;
+            end
+
+            // Round-robin with a rate limit on market making: a burst of ticks
+            // yields fewer market-making orders than decisions, the rest are
+            // dropped at the full queue, and granted orders are min_gap apart
+            test_count = test_count + 1;
+            restart(4'b0010);
+            arbiter_mode = 2'd1;
+            strategy_min_gap = {16'd0, 16'd0, 16'd8, 16'd0};
+            for (i = 0; i < 8; i = i + 1) begin
+                send_venue_quote(2'd0, 32'h4e564441 + i, 32'h95F00000, 32'h96000000);
+            end
+            repeat(80) @(posedge clk);
+
+            gap_errors = 0;
+            for (i = 1; i < order_count; i = i + 1) begin
+                if (log_cycle[i] - log_cycle[i-1] < 9) gap_errors = gap_errors + 1;
+            end
+
+            if (strategy_decisions[63:32] == 8 && strategy_orders[63:32] < 8 && strategy_orders[63:32] > 0 &&
+                strategy_orders[63:32] + orders_dropped == 8 && order_count == strategy_orders[63:32] &&
+                gap_errors == 0) begin
+                $display("  ✓ Rate-limited market making: %0d decisions, %0d orders, %0d dropped",
+                         strategy_decisions[63:32], strategy_orders[63:32], orders_dropped);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("  ✗ Rate limit failed: decisions=%0d orders=%0d dropped=%0d gap errors=%0d",
+                         strategy_decisions[63:32], strategy_orders[63:32], orders_dropped, gap_errors);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    task test_twap_strategy();
+        integer i;
+        integer slices, twap_volume;
+        begin
+            $display("\nTest 10: TWAP Execution");
+            test_count = test_count + 1;
+            restart(4'b0100);
+            twap_target_vol = 32'd1000;
+            twap_duration = 32'd1000;
+
+            // A tick every cycle; a slice goes out on every tick that meets a
+            // 10-cycle slice boundary
+            tick_valid = 1;
+            for (i = 0; i < 100; i = i + 1) begin
+                tick_symbol = 32'h414d5a4e;  // AMZN
+                tick_price = 32'h80000000;
+                tick_volume = 32'd100;
+                tick_bid = 32'h7FF00000;
+                tick_ask = 32'h80100000;
+                @(posedge clk);
+            end
+            tick_valid = 0;
             repeat(10) @(posedge clk);
-            
-            if (risk_check_valid) begin
-                $display("  ✓ Risk check triggered");
-                $display("  ✓ Risk exposure: %h", risk_exposure);
+            strategy_enable = 4'b0000;
+
+            slices = 0;
+            twap_volume = 0;
+            for (i = 0; i < order_count; i = i + 1) begin
+                if (log_type[i] == 3'd0 && log_side[i] == 1'b0 && log_price[i] == 32'h80000000) begin
+                    slices = slices + 1;
+                    twap_volume = twap_volume + log_volume[i];
+                end
+            end
+
+            if (order_count > 1 && slices == order_count && twap_volume > 0 && twap_volume <= 1000) begin
+                $display("  ✓ TWAP: %0d slices, %0d of 1000 shares", slices, twap_volume);
                 pass_count = pass_count + 1;
             end else begin
-                $display("  ✗ Risk management failed");
+                $display("  ✗ TWAP failed: %0d orders, %0d slices, %0d shares", order_count, slices, twap_volume);
                 fail_count = fail_count + 1;
             end
         end
     endtask
-    
+
     // Monitor for debugging
-    always @(posedge clk) begin
-        if (signal_valid) begin
-            $display("Signal: Symbol=%h, Price=%h, Volume=%h, Type=%h, Confidence=%h", 
-                     signal_symbol, signal_price, signal_volume, signal_type, signal_confidence);
-        end
-        
-        if (risk_check_valid) begin
-            $display("Risk Check: Exposure=%h, PnL=%h", risk_exposure, risk_pnl);
+    always @(negedge clk) begin
+        if (order_valid && order_ready) begin
+            $display("Order: Symbol=%h, Price=%h, Volume=%0d, Side=%0d, Type=%0d, Venue=%0d",
+                     order_symbol, order_price, order_volume, order_side, order_type, order_venue);
         end
     end
 